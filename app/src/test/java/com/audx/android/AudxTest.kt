@@ -47,6 +47,37 @@ class AudxConfigTest {
         AudxConfig(inputRate = 16000)
         AudxConfig(inputRate = 48000)
     }
+
+    @Test
+    fun `config validation accepts bypass warm interval range`() {
+        // Should not throw
+        AudxConfig(bypassWarmInterval = 0)
+        AudxConfig(bypassWarmInterval = Audx.BYPASS_WARM_INTERVAL_DEFAULT)
+        AudxConfig(bypassWarmInterval = Audx.BYPASS_WARM_INTERVAL_MAX)
+    }
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `config validation rejects negative bypass warm interval`() {
+        AudxConfig(bypassWarmInterval = -1)
+    }
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `config validation rejects bypass warm interval too high`() {
+        AudxConfig(bypassWarmInterval = Audx.BYPASS_WARM_INTERVAL_MAX + 1)
+    }
+
+    @Test
+    fun `config validation accepts bandwidth up to nyquist`() {
+        // Should not throw
+        AudxConfig(inputRate = 8000, bandwidth = Audx.BANDWIDTH_NARROWBAND)
+        AudxConfig(inputRate = 16000, bandwidth = Audx.BANDWIDTH_WIDEBAND)
+        AudxConfig(inputRate = 16000, bandwidth = 8000)
+    }
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `config validation rejects bandwidth above nyquist`() {
+        AudxConfig(inputRate = 8000, bandwidth = Audx.BANDWIDTH_WIDEBAND)
+    }
 }
 
 class AudxBuilderTest {
@@ -113,6 +144,24 @@ class AudxConstantsTest {
     }
 }
 
+class AudxResamplerTest {
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `resampler rejects zero input rate`() {
+        AudxResampler(inputRate = 0, outputRate = 48000)
+    }
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `resampler rejects negative output rate`() {
+        AudxResampler(inputRate = 44100, outputRate = -1)
+    }
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `resampler rejects quality too high`() {
+        AudxResampler(inputRate = 44100, outputRate = 48000, quality = 11)
+    }
+}
+
 class AudxExceptionTest {
 
     @Test
@@ -0,0 +1,104 @@
+#include "arena.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#define ARENA_CHUNK_DEFAULT (256 * 1024)
+
+static size_t pad_state(size_t bytes) {
+  return (bytes + AUDX_STATE_ALIGN - 1) & ~(size_t)(AUDX_STATE_ALIGN - 1);
+}
+
+void *audx_state_calloc(size_t count, size_t size) {
+  if (size && count > (size_t)-1 / size)
+    return nullptr;
+  const size_t bytes = count * size;
+  const size_t padded = pad_state(bytes ? bytes : 1);
+  void *p = nullptr;
+  if (posix_memalign(&p, AUDX_STATE_ALIGN, padded) != 0)
+    return nullptr;
+  memset(p, 0, padded);
+  return p;
+}
+
+namespace {
+
+struct Region {
+  std::vector<char *> chunks;
+  char *next = nullptr; // first free byte of the newest chunk
+  size_t left = 0;      // bytes free after `next`
+};
+
+} // namespace
+
+struct AudxArena {
+  mutable std::mutex lock;
+  size_t chunk_bytes;
+  std::vector<Region> regions;
+  size_t used;
+  size_t reserved;
+};
+
+AudxArena *audx_arena_create(int owners, size_t chunk_bytes) {
+  if (owners < 1)
+    return nullptr;
+  auto *arena = new AudxArena();
+  arena->chunk_bytes = pad_state(chunk_bytes ? chunk_bytes : ARENA_CHUNK_DEFAULT);
+  arena->regions.resize(owners);
+  return arena;
+}
+
+int audx_arena_owners(const AudxArena *arena) {
+  return (int)arena->regions.size();
+}
+
+void *audx_arena_alloc(AudxArena *arena, int owner, size_t bytes) {
+  if (owner < 0 || owner >= (int)arena->regions.size())
+    return nullptr;
+  const size_t size = pad_state(bytes ? bytes : 1);
+
+  std::lock_guard<std::mutex> guard(arena->lock);
+  Region &region = arena->regions[owner];
+  if (size > region.left) {
+    const size_t chunk = size > arena->chunk_bytes ? size : arena->chunk_bytes;
+    void *p = nullptr;
+    if (posix_memalign(&p, AUDX_STATE_ALIGN, chunk) != 0)
+      return nullptr;
+    region.chunks.push_back((char *)p);
+    arena->reserved += chunk;
+    // An oversized block keeps the current chunk's free space for later
+    if (chunk == size && region.left > 0) {
+      arena->used += size;
+      return memset(p, 0, size);
+    }
+    region.next = (char *)p;
+    region.left = chunk;
+  }
+
+  char *block = region.next;
+  region.next += size;
+  region.left -= size;
+  arena->used += size;
+  return memset(block, 0, size);
+}
+
+size_t audx_arena_used(const AudxArena *arena) {
+  std::lock_guard<std::mutex> guard(arena->lock);
+  return arena->used;
+}
+
+size_t audx_arena_reserved(const AudxArena *arena) {
+  std::lock_guard<std::mutex> guard(arena->lock);
+  return arena->reserved;
+}
+
+void audx_arena_destroy(AudxArena *arena) {
+  if (!arena)
+    return;
+  for (Region &region : arena->regions)
+    for (char *chunk : region.chunks)
+      free(chunk);
+  delete arena;
+}
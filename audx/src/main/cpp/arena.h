@@ -0,0 +1,60 @@
+#ifndef AUDX_ARENA_H
+#define AUDX_ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Cache-line layout --- */
+// State written on every frame is kept off cache lines that another thread
+// writes, so streams processed on different cores do not invalidate each
+// other's lines. Blocks are padded to AUDX_STATE_ALIGN, a pair of lines,
+// because adjacent-line prefetchers on x86 (and 128-byte lines on some ARM
+// cores) make neighbouring lines contend as well.
+
+#define AUDX_CACHE_LINE 64
+#define AUDX_STATE_ALIGN 128
+
+// calloc() for per-stream state: zeroed, aligned to AUDX_STATE_ALIGN and
+// rounded up to a multiple of it, so the block shares no line with any
+// other allocation. Release with free().
+void *audx_state_calloc(size_t count, size_t size);
+
+/* --- State arena --- */
+// Places the state of many streams for a multi-threaded host. Memory is
+// handed out per owner, typically the worker thread that will process the
+// stream: each owner fills chunks of its own, so the state of streams on
+// one worker is contiguous (fewer TLB entries, prefetch-friendly) and no
+// line is shared between two owners. Every block is aligned and padded to
+// AUDX_STATE_ALIGN as well, so streams of one owner moved to another worker
+// later do not contend either.
+//
+// Blocks are not freed one by one; the arena releases everything at once.
+// Allocation takes a lock and belongs in setup, not on the audio path.
+
+typedef struct AudxArena AudxArena;
+
+// `owners` regions, each grown `chunk_bytes` at a time (0 uses 256 KiB)
+AudxArena *audx_arena_create(int owners, size_t chunk_bytes);
+
+int audx_arena_owners(const AudxArena *arena);
+
+// Zeroed block of `bytes` in `owner`'s region, or NULL when the owner is out
+// of range or memory is exhausted. Blocks larger than a chunk get a chunk
+// of their own.
+void *audx_arena_alloc(AudxArena *arena, int owner, size_t bytes);
+
+// Bytes handed out, padding included, and bytes reserved in chunks
+size_t audx_arena_used(const AudxArena *arena);
+size_t audx_arena_reserved(const AudxArena *arena);
+
+// Objects placed in the arena must be destroyed first
+void audx_arena_destroy(AudxArena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_ARENA_H
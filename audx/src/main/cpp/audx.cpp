@@ -1,28 +1,43 @@
 #include "audx.h"
+#include "session.h"
 #include <jni.h>
 
 extern "C" JNIEXPORT jlong JNICALL Java_com_audx_android_Audx_denoiseCreateJNI(
-    JNIEnv *env, jobject /*this */, jint in_rate, jint resample_quality) {
-  AudxState *st = audx_create(nullptr, in_rate, resample_quality);
-  if (!st)
+    JNIEnv *env, jobject /*this */, jint in_rate, jint resample_quality,
+    jint warm_interval, jint bandwidth, jint memory_flags,
+    jboolean deterministic) {
+  if (in_rate <= 0 || bandwidth < 0)
     return -1;
 
-  return reinterpret_cast<jlong>(st);
+  AudxSessionConfig config;
+  audx_session_config_default(&config);
+  config.in_rate = in_rate;
+  config.resample_quality = resample_quality;
+  config.warm_interval = warm_interval;
+  config.bandwidth = bandwidth;
+  config.memory_flags = memory_flags;
+  config.deterministic = deterministic ? 1 : 0;
+
+  AudxSession *session = audx_session_create(&config);
+  if (!session)
+    return -1;
+
+  return reinterpret_cast<jlong>(session);
 }
 
 extern "C" JNIEXPORT jfloat JNICALL
 Java_com_audx_android_Audx_denoiseProcessJNI(JNIEnv *env, jobject /* this */,
                                              jlong ptr, jshortArray in,
                                              jshortArray out) {
-  auto *st = reinterpret_cast<AudxState *>(ptr);
-  if (!st) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session) {
     return -1.0f;
   }
 
   jshort *input_ptr = env->GetShortArrayElements(in, nullptr);
   jshort *output_ptr = env->GetShortArrayElements(out, nullptr);
 
-  float result = audx_process_int(st, input_ptr, output_ptr);
+  float result = audx_session_process_int(session, input_ptr, output_ptr);
 
   env->ReleaseShortArrayElements(in, input_ptr, JNI_ABORT);
   env->ReleaseShortArrayElements(out, output_ptr, 0);
@@ -30,11 +45,145 @@ Java_com_audx_android_Audx_denoiseProcessJNI(JNIEnv *env, jobject /* this */,
   return result;
 }
 
+extern "C" JNIEXPORT void JNICALL
+Java_com_audx_android_Audx_denoiseSetBypassJNI(JNIEnv *env, jobject /* this */,
+                                               jlong ptr, jboolean enabled) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return;
+
+  audx_session_set_bypass(session, enabled ? 1 : 0);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_audx_android_Audx_denoiseSetParamsJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr, jint fields, jfloat strength,
+    jboolean agc, jfloat agc_target_db, jfloat agc_max_gain_db) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return JNI_FALSE;
+
+  AudxParams params;
+  audx_session_get_params(session, &params);
+  params.strength = strength;
+  params.agc = agc ? 1 : 0;
+  params.agc_target_db = agc_target_db;
+  params.agc_max_gain_db = agc_max_gain_db;
+  return audx_session_set_params(session, &params, (unsigned int)fields) == 0
+             ? JNI_TRUE
+             : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_audx_android_Audx_denoiseSetSpeakerJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr, jlong detector, jint stream) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return;
+
+  audx_session_set_speaker(
+      session, reinterpret_cast<AudxSpeakerDetector *>(detector), stream);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_audx_android_Audx_denoiseSetEventsJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr, jlong ring, jint stream) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return;
+
+  audx_session_set_events(session, reinterpret_cast<AudxEventRing *>(ring),
+                          stream);
+}
+
+// Attaches a new DTX state (replacing `dtx`) or detaches and frees it.
+// Returns the attached state, 0 when disabled or on failure.
+extern "C" JNIEXPORT jlong JNICALL Java_com_audx_android_Audx_denoiseSetDtxJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr, jlong dtx, jboolean enabled,
+    jint hangover_frames) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return 0;
+
+  audx_session_set_dtx(session, nullptr);
+  audx_dtx_destroy(reinterpret_cast<AudxDtx *>(dtx));
+  if (!enabled)
+    return 0;
+
+  AudxDtxConfig config;
+  audx_dtx_config_default(&config);
+  config.hangover_frames = hangover_frames;
+  AudxDtx *created = audx_dtx_create(&config);
+  if (created)
+    audx_session_set_dtx(session, created);
+  return reinterpret_cast<jlong>(created);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_com_audx_android_Audx_denoiseDtxDecisionJNI(
+    JNIEnv *env, jobject /* this */, jlong dtx) {
+  AudxDtxFrame frame;
+  audx_dtx_last(reinterpret_cast<AudxDtx *>(dtx), &frame);
+  return frame.decision;
+}
+
+extern "C" JNIEXPORT jfloat JNICALL Java_com_audx_android_Audx_denoiseDtxNoiseDbJNI(
+    JNIEnv *env, jobject /* this */, jlong dtx) {
+  AudxDtxFrame frame;
+  audx_dtx_last(reinterpret_cast<AudxDtx *>(dtx), &frame);
+  return frame.noise_db;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_audx_android_Audx_denoiseDtxDestroyJNI(
+    JNIEnv *env, jobject /* this */, jlong dtx) {
+  audx_dtx_destroy(reinterpret_cast<AudxDtx *>(dtx));
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_com_audx_android_Audx_denoisePrimeJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr, jshortArray samples) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return -1;
+
+  const jsize len = env->GetArrayLength(samples);
+  jshort *samples_ptr = env->GetShortArrayElements(samples, nullptr);
+  const int frames = audx_session_prime(session, samples_ptr, (size_t)len);
+  env->ReleaseShortArrayElements(samples, samples_ptr, JNI_ABORT);
+
+  return frames;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_com_audx_android_Audx_denoiseDelayJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return 0;
+
+  return (jlong)audx_session_delay_ns(session);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_audx_android_Audx_denoisePrefaultJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return;
+
+  audx_session_prefault(session);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_audx_android_Audx_denoiseMemoryStatusJNI(JNIEnv *env,
+                                                  jobject /* this */,
+                                                  jlong ptr) {
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
+    return -1;
+
+  return audx_session_memory_status(session);
+}
+
 extern "C" JNIEXPORT void JNICALL Java_com_audx_android_Audx_denoiseDestroyJNI(
     JNIEnv *env, jobject /* this */, jlong ptr) {
-  auto *st = reinterpret_cast<AudxState *>(ptr); // FIX: Use AudxCtx*
-  if (!st)
+  auto *session = reinterpret_cast<AudxSession *>(ptr);
+  if (!session)
     return;
 
-  audx_destroy(st); // Destroy the state
+  audx_session_destroy(session); // Destroys the owned AudxState too
 }
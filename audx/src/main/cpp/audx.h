@@ -1,13 +1,22 @@
 #ifndef AUDX_H
 #define AUDX_H
 
+#include <math.h>
 #include <stdint.h>
 
+#ifdef HAS_X86_SIMD
+#include <smmintrin.h>
+#elif defined(HAS_ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /* --- Utility Converters --- */
+// pcm_float_to_int16() clamps and rounds to nearest even on every target,
+// so SIMD lanes, scalar tails and the scalar build agree bit for bit
 #define PCM_SCALE_FLOAT_MAX 32767.0f
 #define PCM_SCALE_FLOAT_MIN -32768.0f
 
@@ -65,7 +74,7 @@ static inline void pcm_float_to_int16(const float *input, short *output,
       val = PCM_SCALE_FLOAT_MAX;
     if (val < PCM_SCALE_FLOAT_MIN)
       val = PCM_SCALE_FLOAT_MIN;
-    output[i] = (int16_t)val;
+    output[i] = (int16_t)lrintf(val);
   }
 }
 
@@ -107,9 +116,9 @@ static inline void pcm_float_to_int16(const float *input, short *output,
     // Clamp to valid range
     flo = vminq_f32(vmaxq_f32(flo, min_val), max_val);
     fhi = vminq_f32(vmaxq_f32(fhi, min_val), max_val);
-    // Convert to 32-bit integers (ARMv7-compatible)
-    int32x4_t lo32 = vcvtq_s32_f32(flo);
-    int32x4_t hi32 = vcvtq_s32_f32(fhi);
+    // Convert to 32-bit integers, rounding to nearest even like SSE
+    int32x4_t lo32 = vcvtnq_s32_f32(flo);
+    int32x4_t hi32 = vcvtnq_s32_f32(fhi);
     // Narrow to 16-bit integers
     int16x4_t lo16 = vmovn_s32(lo32);
     int16x4_t hi16 = vmovn_s32(hi32);
@@ -124,7 +133,7 @@ static inline void pcm_float_to_int16(const float *input, short *output,
       val = PCM_SCALE_FLOAT_MAX;
     if (val < PCM_SCALE_FLOAT_MIN)
       val = PCM_SCALE_FLOAT_MIN;
-    output[i] = (int16_t)val;
+    output[i] = (int16_t)lrintf(val);
   }
 }
 
@@ -144,7 +153,7 @@ static inline void pcm_float_to_int16(const float *input, short *output,
       val = PCM_SCALE_FLOAT_MAX;
     if (val < PCM_SCALE_FLOAT_MIN)
       val = PCM_SCALE_FLOAT_MIN;
-    output[i] = (int16_t)val;
+    output[i] = (int16_t)lrintf(val);
   }
 }
 #endif
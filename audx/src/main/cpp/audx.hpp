@@ -0,0 +1,539 @@
+#ifndef AUDX_HPP
+#define AUDX_HPP
+
+/* --- C++ API --- */
+// Header-only C++20 layer over the C API. Handles are move-only and release
+// their native object on destruction; process calls take spans and check
+// their length against the frame size instead of trusting a raw pointer.
+// Every call is an inline forward to the C function it wraps.
+
+#include "arena.h"
+#include "audx.h"
+#include "engine.h"
+#include "resampler.h"
+#include "scratch.h"
+#include "session.h"
+#include "stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace audx {
+
+namespace detail {
+template <typename T, void (*Destroy)(T *)> struct Deleter {
+  void operator()(T *p) const noexcept { Destroy(p); }
+};
+
+template <typename T, void (*Destroy)(T *)>
+using Handle = std::unique_ptr<T, Deleter<T, Destroy>>;
+
+[[noreturn]] inline void length_error(const char *what, size_t got,
+                                      size_t want) {
+  throw std::invalid_argument(std::string(what) + ": expected " +
+                              std::to_string(want) + " samples, got " +
+                              std::to_string(got));
+}
+} // namespace detail
+
+/* --- State --- */
+// The core denoiser. Frames are calculate_frame_sample(in_rate) samples.
+
+class State {
+public:
+  explicit State(unsigned int in_rate,
+                 int resample_quality = AUDX_RESAMPLER_QUALITY_DEFAULT)
+      : state_(audx_create(nullptr, in_rate, resample_quality)),
+        frame_samples_(calculate_frame_sample(in_rate)) {
+    if (!state_)
+      throw std::runtime_error("audx_create failed");
+  }
+
+  size_t frame_samples() const noexcept { return frame_samples_; }
+
+  // Returns the VAD probability of the frame
+  float process(std::span<const float> in, std::span<float> out) {
+    check(in.size(), out.size());
+    return audx_process(state_.get(), const_cast<float *>(in.data()),
+                        out.data());
+  }
+
+  float process(std::span<const int16_t> in, std::span<int16_t> out) {
+    check(in.size(), out.size());
+    return audx_process_int(state_.get(), const_cast<short *>(in.data()),
+                            out.data());
+  }
+
+  AudxState *get() const noexcept { return state_.get(); }
+
+private:
+  void check(size_t in, size_t out) const {
+    if (in != frame_samples_)
+      detail::length_error("State::process input", in, frame_samples_);
+    if (out < frame_samples_)
+      detail::length_error("State::process output", out, frame_samples_);
+  }
+
+  detail::Handle<AudxState, audx_destroy> state_;
+  size_t frame_samples_;
+};
+
+/* --- Scratch --- */
+
+class Scratch {
+public:
+  Scratch() : scratch_(audx_scratch_create()) {
+    if (!scratch_)
+      throw std::bad_alloc();
+  }
+
+  size_t bytes() const noexcept { return audx_scratch_bytes(scratch_.get()); }
+
+  AudxScratch *get() const noexcept { return scratch_.get(); }
+
+private:
+  detail::Handle<AudxScratch, audx_scratch_destroy> scratch_;
+};
+
+/* --- Arena --- */
+// Must outlive every session placed in it
+
+class Arena {
+public:
+  explicit Arena(int owners, size_t chunk_bytes = 0)
+      : arena_(audx_arena_create(owners, chunk_bytes)) {
+    if (!arena_)
+      throw std::invalid_argument("audx_arena_create: owners must be >= 1");
+  }
+
+  int owners() const noexcept { return audx_arena_owners(arena_.get()); }
+  size_t used() const noexcept { return audx_arena_used(arena_.get()); }
+
+  AudxArena *get() const noexcept { return arena_.get(); }
+
+private:
+  detail::Handle<AudxArena, audx_arena_destroy> arena_;
+};
+
+/* --- Session --- */
+
+struct SessionConfig : AudxSessionConfig {
+  SessionConfig() noexcept { audx_session_config_default(this); }
+};
+
+class Session {
+public:
+  explicit Session(const SessionConfig &config = {})
+      : session_(audx_session_create(&config)),
+        frame_samples_(session_ ? audx_session_frame_samples(session_.get())
+                                : 0) {
+    if (!session_)
+      throw std::runtime_error("audx_session_create failed");
+  }
+
+  // State placed in `owner`'s region of `arena`
+  Session(const SessionConfig &config, Arena &arena, int owner)
+      : session_(audx_session_create_in(&config, arena.get(), owner)),
+        frame_samples_(session_ ? audx_session_frame_samples(session_.get())
+                                : 0) {
+    if (!session_)
+      throw std::runtime_error("audx_session_create_in failed");
+  }
+
+  size_t frame_samples() const noexcept { return frame_samples_; }
+
+  // Input-to-output delay; see audx_session_delay_ns
+  std::chrono::nanoseconds delay() const noexcept {
+    return std::chrono::nanoseconds(audx_session_delay_ns(session_.get()));
+  }
+
+  // Returns the VAD probability of the frame
+  float process(std::span<const int16_t> in, std::span<int16_t> out) {
+    check(in.size(), out.size());
+    return audx_session_process_int(
+        session_.get(), const_cast<short *>(in.data()), out.data());
+  }
+
+  float process(Scratch &scratch, std::span<const int16_t> in,
+                std::span<int16_t> out) {
+    check(in.size(), out.size());
+    return audx_session_process_int_ws(session_.get(), scratch.get(),
+                                       const_cast<short *>(in.data()),
+                                       out.data());
+  }
+
+  // Outputs the input delayed like processed frames, without the core
+  void process_dry(std::span<const int16_t> in, std::span<int16_t> out) {
+    check(in.size(), out.size());
+    if (audx_session_process_dry(session_.get(), in.data(), out.data()) != 0)
+      throw std::bad_alloc();
+  }
+
+  void set_bypass(bool enabled) noexcept {
+    audx_session_set_bypass(session_.get(), enabled ? 1 : 0);
+  }
+
+  bool bypass() const noexcept {
+    return audx_session_get_bypass(session_.get()) != 0;
+  }
+
+  // Safe from any thread; applied at the next frame boundary
+  void set_params(const AudxParams &params,
+                  unsigned int fields = AUDX_PARAM_ALL) {
+    if (audx_session_set_params(session_.get(), &params, fields) != 0)
+      throw std::invalid_argument("audx_session_set_params: out of range");
+  }
+
+  AudxParams params() const noexcept {
+    AudxParams params;
+    audx_session_get_params(session_.get(), &params);
+    return params;
+  }
+
+  // Feeds pre-roll audio without producing output; returns frames consumed
+  int prime(std::span<const int16_t> samples) noexcept {
+    return audx_session_prime(session_.get(), samples.data(), samples.size());
+  }
+
+  void prefault() noexcept { audx_session_prefault(session_.get()); }
+
+  int memory_status() const noexcept {
+    return audx_session_memory_status(session_.get());
+  }
+
+  AudxSession *get() const noexcept { return session_.get(); }
+
+private:
+  void check(size_t in, size_t out) const {
+    if (in != frame_samples_)
+      detail::length_error("Session::process input", in, frame_samples_);
+    if (out < frame_samples_)
+      detail::length_error("Session::process output", out, frame_samples_);
+  }
+
+  detail::Handle<AudxSession, audx_session_destroy> session_;
+  size_t frame_samples_;
+};
+
+/* --- Stream --- */
+
+class Stream {
+public:
+  explicit Stream(const SessionConfig &config = {}, int queue_frames = 4)
+      : stream_(audx_stream_create(&config, queue_frames)) {
+    if (!stream_)
+      throw std::runtime_error("audx_stream_create failed");
+  }
+
+  // Returns the number of samples accepted
+  size_t write(std::span<const int16_t> in) noexcept {
+    return audx_stream_write(stream_.get(), in.data(),
+                             (unsigned int)in.size());
+  }
+
+  // Returns the number of samples copied to `out`
+  size_t read(std::span<int16_t> out) noexcept {
+    return audx_stream_read(stream_.get(), out.data(),
+                            (unsigned int)out.size());
+  }
+
+  // With the capture time of in[0]
+  size_t write(std::span<const int16_t> in, int64_t timestamp_ns) noexcept {
+    return audx_stream_write_ts(stream_.get(), in.data(),
+                                (unsigned int)in.size(), timestamp_ns);
+  }
+
+  // Sets `pts_ns` to the presentation timestamp of out[0] when anything
+  // was read
+  size_t read(std::span<int16_t> out, int64_t &pts_ns) noexcept {
+    return audx_stream_read_ts(stream_.get(), out.data(),
+                               (unsigned int)out.size(), &pts_ns);
+  }
+
+  size_t available() const noexcept {
+    return audx_stream_available(stream_.get());
+  }
+
+  float vad() const noexcept { return audx_stream_vad(stream_.get()); }
+
+  void reset() noexcept { audx_stream_reset(stream_.get()); }
+
+  AudxStream *get() const noexcept { return stream_.get(); }
+
+private:
+  detail::Handle<AudxStream, audx_stream_destroy> stream_;
+};
+
+/* --- Resampler --- */
+
+class Resampler {
+public:
+  struct Result {
+    size_t consumed;
+    size_t produced;
+  };
+
+  Resampler(unsigned int in_rate, unsigned int out_rate,
+            int quality = AUDX_RESAMPLER_QUALITY_DEFAULT,
+            unsigned int bandwidth = 0)
+      : resampler_(
+            audx_resampler_create_band(in_rate, out_rate, quality, bandwidth)) {
+    if (!resampler_)
+      throw std::invalid_argument("audx_resampler_create failed");
+  }
+
+  // Consumes as much of `in` as fits into `out`
+  Result process(std::span<const float> in, std::span<float> out) {
+    unsigned int in_len = (unsigned int)in.size();
+    unsigned int out_len = (unsigned int)out.size();
+    audx_resampler_process_float(resampler_.get(), in.data(), &in_len,
+                                 out.data(), &out_len);
+    return {in_len, out_len};
+  }
+
+  Result process(std::span<const int16_t> in, std::span<int16_t> out) {
+    unsigned int in_len = (unsigned int)in.size();
+    unsigned int out_len = (unsigned int)out.size();
+    audx_resampler_process_int(resampler_.get(), in.data(), &in_len,
+                               out.data(), &out_len);
+    return {in_len, out_len};
+  }
+
+  size_t max_output(size_t in_len) const noexcept {
+    return audx_resampler_max_output(resampler_.get(), (unsigned int)in_len);
+  }
+
+  int input_latency() const noexcept {
+    return audx_resampler_input_latency(resampler_.get());
+  }
+
+  void reset() noexcept { audx_resampler_reset(resampler_.get()); }
+
+  AudxResampler *get() const noexcept { return resampler_.get(); }
+
+private:
+  detail::Handle<AudxResampler, audx_resampler_destroy> resampler_;
+};
+
+/* --- Executor --- */
+// Worker pool for processing many sessions off the caller's thread. Each
+// session is always handled by the same worker, so frames submitted for one
+// session run in submission order; each worker has its own workspace.
+//
+// The session and both buffers must stay alive and untouched until the
+// returned future is ready. Destruction finishes all queued work.
+
+class Executor {
+public:
+  explicit Executor(unsigned int threads = std::thread::hardware_concurrency())
+      : workers_(threads ? threads : 1) {
+    for (auto &worker : workers_)
+      worker.thread = std::thread([&worker] { worker.run(); });
+  }
+
+  Executor(const Executor &) = delete;
+  Executor &operator=(const Executor &) = delete;
+
+  ~Executor() {
+    for (auto &worker : workers_) {
+      {
+        std::lock_guard<std::mutex> guard(worker.mutex);
+        worker.stopping = true;
+      }
+      worker.wake.notify_one();
+    }
+    for (auto &worker : workers_)
+      worker.thread.join();
+  }
+
+  // Returns the frame's VAD probability. Length errors are thrown here,
+  // before anything is queued.
+  std::future<float> submit(Session &session, std::span<const int16_t> in,
+                            std::span<int16_t> out) {
+    const size_t n = session.frame_samples();
+    if (in.size() != n)
+      detail::length_error("Executor::submit input", in.size(), n);
+    if (out.size() < n)
+      detail::length_error("Executor::submit output", out.size(), n);
+
+    Worker &worker = worker_for(session.get());
+    Job job{session.get(), in.data(), out.data(), {}};
+    std::future<float> result = job.result.get_future();
+    {
+      std::lock_guard<std::mutex> guard(worker.mutex);
+      worker.queue.push_back(std::move(job));
+    }
+    worker.wake.notify_one();
+    return result;
+  }
+
+  size_t threads() const noexcept { return workers_.size(); }
+
+private:
+  struct Job {
+    AudxSession *session;
+    const int16_t *in;
+    int16_t *out;
+    std::promise<float> result;
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> queue;
+    bool stopping = false;
+    std::thread thread;
+
+    void run() {
+      Scratch scratch;
+      std::unique_lock<std::mutex> lock(mutex);
+      for (;;) {
+        wake.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty())
+          return; // stopping and drained
+
+        Job job = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+
+        audx_session_scratch_reserve(job.session, scratch.get());
+        job.result.set_value(audx_session_process_int_ws(
+            job.session, scratch.get(), const_cast<short *>(job.in),
+            job.out));
+
+        lock.lock();
+      }
+    }
+  };
+
+  Worker &worker_for(const AudxSession *session) noexcept {
+    // Heap blocks are at least 16-byte aligned; drop the constant low bits
+    const auto key = reinterpret_cast<uintptr_t>(session) >> 4;
+    return workers_[(key ^ (key >> 7)) % workers_.size()];
+  }
+
+  std::vector<Worker> workers_;
+};
+
+/* --- Engine --- */
+// Deadline-scheduled multi-stream processing (see engine.h). Sessions must
+// outlive the engine or be removed from it first.
+
+class Engine {
+public:
+  struct Frame {
+    float vad;
+    int status;     // AUDX_FRAME_*
+    int64_t pts_ns; // presentation timestamp, 0 unless submitted with one
+  };
+
+  struct Config : AudxEngineConfig {
+    Config() noexcept { audx_engine_config_default(this); }
+  };
+
+  explicit Engine(const Config &config = {})
+      : engine_(audx_engine_create(&config)) {
+    if (!engine_)
+      throw std::invalid_argument("audx_engine_create failed");
+  }
+
+  int add_stream(Session &session, AudxPriority priority = AUDX_PRIORITY_NORMAL,
+                 AudxLatePolicy policy = AUDX_LATE_PROCESS) {
+    const int id =
+        audx_engine_add_stream(engine_.get(), session.get(), priority, policy);
+    if (id < 0)
+      throw std::invalid_argument("audx_engine_add_stream failed");
+    frame_samples_.resize(std::max(frame_samples_.size(), (size_t)id + 1));
+    frame_samples_[id] = session.frame_samples();
+    return id;
+  }
+
+  void remove_stream(int stream) noexcept {
+    audx_engine_remove_stream(engine_.get(), stream);
+  }
+
+  // Throws std::invalid_argument on a length mismatch and
+  // std::runtime_error when the stream's queue is full
+  std::future<Frame> submit(int stream, std::span<const int16_t> in,
+                            std::span<int16_t> out, int64_t deadline_ns) {
+    check(stream, in.size(), out.size());
+    auto promise = std::make_unique<std::promise<Frame>>();
+    std::future<Frame> result = promise->get_future();
+    if (audx_engine_submit(engine_.get(), stream, in.data(), out.data(),
+                           deadline_ns, complete, promise.get()) != 0)
+      throw std::runtime_error("Engine::submit: stream queue full");
+    promise.release(); // owned by the completion now
+    return result;
+  }
+
+  // For a frame captured at `timestamp_ns`; the result carries the
+  // presentation timestamp of `out`
+  std::future<Frame> submit(int stream, std::span<const int16_t> in,
+                            std::span<int16_t> out, int64_t deadline_ns,
+                            int64_t timestamp_ns) {
+    check(stream, in.size(), out.size());
+    auto promise = std::make_unique<std::promise<Frame>>();
+    std::future<Frame> result = promise->get_future();
+    if (audx_engine_submit_ts(engine_.get(), stream, in.data(), out.data(),
+                              deadline_ns, timestamp_ns, complete_timed,
+                              promise.get()) != 0)
+      throw std::runtime_error("Engine::submit: stream queue full");
+    promise.release(); // owned by the completion now
+    return result;
+  }
+
+  void drain() noexcept { audx_engine_drain(engine_.get()); }
+
+  AudxEngineStats stats() const noexcept {
+    AudxEngineStats stats;
+    audx_engine_stats(engine_.get(), &stats);
+    return stats;
+  }
+
+  static int64_t now_ns() noexcept { return audx_engine_now_ns(); }
+
+  AudxEngine *get() const noexcept { return engine_.get(); }
+
+private:
+  void check(int stream, size_t in, size_t out) const {
+    const size_t n = stream >= 0 && (size_t)stream < frame_samples_.size()
+                         ? frame_samples_[stream]
+                         : 0;
+    if (in != n)
+      detail::length_error("Engine::submit input", in, n);
+    if (out < n)
+      detail::length_error("Engine::submit output", out, n);
+  }
+
+  static void complete(void *ctx, int, float vad, int status) {
+    std::unique_ptr<std::promise<Frame>> promise(
+        static_cast<std::promise<Frame> *>(ctx));
+    promise->set_value({vad, status, 0});
+  }
+
+  static void complete_timed(void *ctx, int, float vad, int status,
+                             int64_t pts_ns) {
+    std::unique_ptr<std::promise<Frame>> promise(
+        static_cast<std::promise<Frame> *>(ctx));
+    promise->set_value({vad, status, pts_ns});
+  }
+
+  detail::Handle<AudxEngine, audx_engine_destroy> engine_;
+  std::vector<size_t> frame_samples_;
+};
+
+} // namespace audx
+
+#endif // AUDX_HPP
@@ -0,0 +1,69 @@
+#include "events.h"
+#include <jni.h>
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_audx_android_AudxEventChannel_eventsCreateJNI(JNIEnv *env,
+                                                       jobject /* this */,
+                                                       jint capacity) {
+  if (capacity <= 0)
+    return -1;
+
+  AudxEventRing *ring = audx_events_create((size_t)capacity);
+  if (!ring)
+    return -1;
+
+  return reinterpret_cast<jlong>(ring);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_audx_android_AudxEventChannel_eventsCapacityJNI(JNIEnv *env,
+                                                         jobject /* this */,
+                                                         jlong ptr) {
+  auto *ring = reinterpret_cast<AudxEventRing *>(ptr);
+  if (!ring)
+    return 0;
+
+  return (jint)audx_events_capacity(ring);
+}
+
+// Drains into a direct ByteBuffer in AudxEvent layout, so one call moves a
+// whole batch and Kotlin reads the records without further JNI calls
+extern "C" JNIEXPORT jint JNICALL
+Java_com_audx_android_AudxEventChannel_eventsDrainJNI(JNIEnv *env,
+                                                      jobject /* this */,
+                                                      jlong ptr,
+                                                      jobject buffer) {
+  auto *ring = reinterpret_cast<AudxEventRing *>(ptr);
+  if (!ring)
+    return -1;
+
+  auto *events = static_cast<AudxEvent *>(env->GetDirectBufferAddress(buffer));
+  const jlong bytes = env->GetDirectBufferCapacity(buffer);
+  if (!events || bytes < 0)
+    return -1;
+
+  return (jint)audx_events_drain(ring, events,
+                                 (size_t)bytes / sizeof(AudxEvent));
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_audx_android_AudxEventChannel_eventsDroppedJNI(JNIEnv *env,
+                                                        jobject /* this */,
+                                                        jlong ptr) {
+  auto *ring = reinterpret_cast<AudxEventRing *>(ptr);
+  if (!ring)
+    return 0;
+
+  return (jlong)audx_events_dropped(ring);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_audx_android_AudxEventChannel_eventsDestroyJNI(JNIEnv *env,
+                                                        jobject /* this */,
+                                                        jlong ptr) {
+  auto *ring = reinterpret_cast<AudxEventRing *>(ptr);
+  if (!ring)
+    return;
+
+  audx_events_destroy(ring);
+}
@@ -0,0 +1,107 @@
+#include "resampler.h"
+#include <jni.h>
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_audx_android_AudxResampler_resamplerCreateJNI(JNIEnv *env,
+                                                       jobject /* this */,
+                                                       jint in_rate,
+                                                       jint out_rate,
+                                                       jint quality) {
+  if (in_rate <= 0 || out_rate <= 0)
+    return -1;
+
+  AudxResampler *r = audx_resampler_create(in_rate, out_rate, quality);
+  if (!r)
+    return -1;
+
+  return reinterpret_cast<jlong>(r);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_audx_android_AudxResampler_resamplerProcessJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr, jshortArray in, jint in_len,
+    jshortArray out) {
+  auto *r = reinterpret_cast<AudxResampler *>(ptr);
+  if (!r)
+    return -1;
+
+  jshort *input_ptr = env->GetShortArrayElements(in, nullptr);
+  jshort *output_ptr = env->GetShortArrayElements(out, nullptr);
+
+  auto in_count = static_cast<unsigned int>(in_len);
+  auto out_count = static_cast<unsigned int>(env->GetArrayLength(out));
+  int result = audx_resampler_process_int(r, input_ptr, &in_count, output_ptr,
+                                          &out_count);
+
+  env->ReleaseShortArrayElements(in, input_ptr, JNI_ABORT);
+  env->ReleaseShortArrayElements(out, output_ptr, 0);
+
+  return result == 0 ? static_cast<jint>(out_count) : -1;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_audx_android_AudxResampler_resamplerProcessFloatJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr, jfloatArray in, jint in_len,
+    jfloatArray out) {
+  auto *r = reinterpret_cast<AudxResampler *>(ptr);
+  if (!r)
+    return -1;
+
+  jfloat *input_ptr = env->GetFloatArrayElements(in, nullptr);
+  jfloat *output_ptr = env->GetFloatArrayElements(out, nullptr);
+
+  auto in_count = static_cast<unsigned int>(in_len);
+  auto out_count = static_cast<unsigned int>(env->GetArrayLength(out));
+  int result = audx_resampler_process_float(r, input_ptr, &in_count,
+                                            output_ptr, &out_count);
+
+  env->ReleaseFloatArrayElements(in, input_ptr, JNI_ABORT);
+  env->ReleaseFloatArrayElements(out, output_ptr, 0);
+
+  return result == 0 ? static_cast<jint>(out_count) : -1;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_audx_android_AudxResampler_resamplerMaxOutputJNI(JNIEnv *env,
+                                                          jobject /* this */,
+                                                          jlong ptr,
+                                                          jint in_len) {
+  auto *r = reinterpret_cast<AudxResampler *>(ptr);
+  if (!r || in_len < 0)
+    return -1;
+
+  return static_cast<jint>(audx_resampler_max_output(r, in_len));
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_audx_android_AudxResampler_resamplerLatencyJNI(JNIEnv *env,
+                                                        jobject /* this */,
+                                                        jlong ptr) {
+  auto *r = reinterpret_cast<AudxResampler *>(ptr);
+  if (!r)
+    return -1;
+
+  return audx_resampler_input_latency(r);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_audx_android_AudxResampler_resamplerResetJNI(JNIEnv *env,
+                                                      jobject /* this */,
+                                                      jlong ptr) {
+  auto *r = reinterpret_cast<AudxResampler *>(ptr);
+  if (!r)
+    return;
+
+  audx_resampler_reset(r);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_audx_android_AudxResampler_resamplerDestroyJNI(JNIEnv *env,
+                                                        jobject /* this */,
+                                                        jlong ptr) {
+  auto *r = reinterpret_cast<AudxResampler *>(ptr);
+  if (!r)
+    return;
+
+  audx_resampler_destroy(r);
+}
@@ -0,0 +1,55 @@
+#include "speaker.h"
+#include <jni.h>
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_audx_android_AudxSpeakerDetector_speakerCreateJNI(
+    JNIEnv *env, jobject /* this */, jint streams, jfloat vad_on,
+    jfloat vad_off, jint hangover_frames, jfloat dominance_db,
+    jint switch_frames, jfloat smoothing) {
+  AudxSpeakerConfig config;
+  config.vad_on = vad_on;
+  config.vad_off = vad_off;
+  config.hangover_frames = hangover_frames;
+  config.dominance_db = dominance_db;
+  config.switch_frames = switch_frames;
+  config.smoothing = smoothing;
+
+  // Changes are reported to Kotlin from the tick's return value
+  AudxSpeakerDetector *detector =
+      audx_speaker_create(&config, streams, nullptr, nullptr);
+  if (!detector)
+    return -1;
+
+  return reinterpret_cast<jlong>(detector);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_audx_android_AudxSpeakerDetector_speakerTickJNI(JNIEnv *env,
+                                                         jobject /* this */,
+                                                         jlong ptr) {
+  auto *detector = reinterpret_cast<AudxSpeakerDetector *>(ptr);
+  if (!detector)
+    return -1;
+
+  return audx_speaker_tick(detector);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_audx_android_AudxSpeakerDetector_speakerTalkingJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr, jint stream) {
+  auto *detector = reinterpret_cast<AudxSpeakerDetector *>(ptr);
+  if (!detector)
+    return JNI_FALSE;
+
+  return audx_speaker_talking(detector, stream) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_audx_android_AudxSpeakerDetector_speakerDestroyJNI(
+    JNIEnv *env, jobject /* this */, jlong ptr) {
+  auto *detector = reinterpret_cast<AudxSpeakerDetector *>(ptr);
+  if (!detector)
+    return;
+
+  audx_speaker_destroy(detector);
+}
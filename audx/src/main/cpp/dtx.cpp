@@ -0,0 +1,120 @@
+#include "dtx.h"
+
+#include <cmath>
+#include <cstring>
+
+// Noise floor smoothing per silent frame: falls fast so a closing door
+// does not leave comfort noise too loud, rises slowly so a breath does not
+// lift it
+#define DTX_FLOOR_FALL 0.5f
+#define DTX_FLOOR_RISE 0.05f
+
+struct AudxDtx {
+  AudxDtxConfig config;
+  int speech;   // VAD hysteresis state
+  int hangover; // frames still sent after speech
+  int has_noise;
+  float noise_db;
+  float sid_db;  // level sent with the last comfort-noise update
+  int since_sid; // silent frames since that update
+  AudxDtxFrame last;
+  unsigned long long counts[3];
+};
+
+void audx_dtx_config_default(AudxDtxConfig *config) {
+  config->vad_on = 0.6f;
+  config->vad_off = 0.3f;
+  config->hangover_frames = 20;
+  config->sid_interval = 40;
+}
+
+AudxDtx *audx_dtx_create(const AudxDtxConfig *config) {
+  if (!config || config->vad_off > config->vad_on ||
+      config->hangover_frames < 0 || config->sid_interval < 0)
+    return nullptr;
+
+  auto *dtx = new AudxDtx();
+  dtx->config = *config;
+  audx_dtx_reset(dtx);
+  return dtx;
+}
+
+static float level_dbfs(const short *frame, int len) {
+  float sum = 0.0f;
+  for (int i = 0; i < len; i++)
+    sum += (float)frame[i] * (float)frame[i];
+  const float mean = len > 0 ? sum / ((float)len * 32768.0f * 32768.0f) : 0.0f;
+  const float db = 10.0f * log10f(mean + 1e-12f);
+  return db > AUDX_DTX_FLOOR_DB ? db : AUDX_DTX_FLOOR_DB;
+}
+
+int audx_dtx_update(AudxDtx *dtx, float vad, const short *frame, int len,
+                    AudxDtxFrame *out) {
+  const AudxDtxConfig &config = dtx->config;
+  const float level_db = level_dbfs(frame, len);
+
+  if (vad >= config.vad_on)
+    dtx->speech = 1;
+  else if (vad < config.vad_off)
+    dtx->speech = 0;
+
+  int decision;
+  if (dtx->speech || dtx->hangover > 0) {
+    if (dtx->speech)
+      dtx->hangover = config.hangover_frames;
+    else
+      dtx->hangover--;
+    decision = AUDX_DTX_TRANSMIT;
+  } else {
+    if (!dtx->has_noise) {
+      dtx->noise_db = level_db;
+      dtx->has_noise = 1;
+    } else {
+      const float rate =
+          level_db < dtx->noise_db ? DTX_FLOOR_FALL : DTX_FLOOR_RISE;
+      dtx->noise_db += rate * (level_db - dtx->noise_db);
+    }
+
+    dtx->since_sid++;
+    const bool entering = dtx->last.decision == AUDX_DTX_TRANSMIT;
+    if (entering ||
+        (config.sid_interval > 0 && dtx->since_sid >= config.sid_interval) ||
+        fabsf(dtx->noise_db - dtx->sid_db) > AUDX_DTX_SID_CHANGE_DB) {
+      decision = AUDX_DTX_SID;
+      dtx->sid_db = dtx->noise_db;
+      dtx->since_sid = 0;
+    } else {
+      decision = AUDX_DTX_SILENT;
+    }
+  }
+
+  dtx->last.decision = decision;
+  dtx->last.speech = dtx->speech;
+  dtx->last.vad = vad;
+  dtx->last.level_db = level_db;
+  dtx->last.noise_db = dtx->has_noise ? dtx->noise_db : AUDX_DTX_FLOOR_DB;
+  dtx->counts[decision]++;
+  if (out)
+    *out = dtx->last;
+  return decision;
+}
+
+void audx_dtx_last(const AudxDtx *dtx, AudxDtxFrame *out) { *out = dtx->last; }
+
+void audx_dtx_counts(const AudxDtx *dtx, unsigned long long counts[3]) {
+  memcpy(counts, dtx->counts, sizeof(dtx->counts));
+}
+
+void audx_dtx_reset(AudxDtx *dtx) {
+  dtx->speech = 0;
+  dtx->hangover = dtx->config.hangover_frames;
+  dtx->has_noise = 0;
+  dtx->noise_db = AUDX_DTX_FLOOR_DB;
+  dtx->sid_db = AUDX_DTX_FLOOR_DB;
+  dtx->since_sid = 0;
+  dtx->last = {AUDX_DTX_TRANSMIT, 0, 0.0f, AUDX_DTX_FLOOR_DB,
+               AUDX_DTX_FLOOR_DB};
+  memset(dtx->counts, 0, sizeof(dtx->counts));
+}
+
+void audx_dtx_destroy(AudxDtx *dtx) { delete dtx; }
@@ -0,0 +1,78 @@
+#ifndef AUDX_DTX_H
+#define AUDX_DTX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Discontinuous transmission --- */
+// Per-frame transmit decision for a network encoder (Opus, AMR-WB, ...)
+// taken from the denoiser's VAD, so the encoder does not have to run a VAD
+// of its own and can be skipped entirely for silent frames.
+//
+// A frame is speech once its VAD reaches vad_on and stays speech until the
+// VAD drops below vad_off; speech plus hangover_frames after it is sent.
+// The hangover also covers the output lagging the VAD by the core's
+// one-frame delay, and the quiet tail of words. In silence, the level of
+// the output frames is tracked as a noise floor (quick to fall, slow to
+// rise) and sent as a comfort-noise update (SID) on the first silent frame,
+// every sid_interval frames after it, and whenever the floor moves by more
+// than AUDX_DTX_SID_CHANGE_DB since the last update; the receiver fills
+// the other frames with comfort noise at that level.
+
+#define AUDX_DTX_TRANSMIT 0 // speech or hangover: encode and send
+#define AUDX_DTX_SID 1      // silence: send a comfort-noise update
+#define AUDX_DTX_SILENT 2   // silence: skip the encoder
+
+#define AUDX_DTX_SID_CHANGE_DB 3.0f
+
+// Level reported for digital silence, dBFS
+#define AUDX_DTX_FLOOR_DB -96.0f
+
+typedef struct AudxDtxConfig {
+  float vad_on;
+  float vad_off;
+  int hangover_frames;
+  int sid_interval; // frames between comfort-noise updates, 0 for only on
+                    // entry and level changes
+} AudxDtxConfig;
+
+typedef struct AudxDtxFrame {
+  int decision;   // AUDX_DTX_*
+  int speech;     // VAD decision before hangover
+  float vad;
+  float level_db; // frame level, dBFS
+  float noise_db; // comfort-noise level, dBFS
+} AudxDtxFrame;
+
+// Defaults: on at 0.6, off below 0.3, 200ms hangover, an update every
+// 400ms (what Opus sends in DTX)
+void audx_dtx_config_default(AudxDtxConfig *config);
+
+typedef struct AudxDtx AudxDtx;
+
+AudxDtx *audx_dtx_create(const AudxDtxConfig *config);
+
+// Decides on one output frame given the VAD returned with it. Returns the
+// decision and fills `out` unless NULL.
+int audx_dtx_update(AudxDtx *dtx, float vad, const short *frame, int len,
+                    AudxDtxFrame *out);
+
+// Decision of the last updated frame; AUDX_DTX_TRANSMIT before the first.
+// Sessions also update it for frames an engine drops or degrades, from the
+// last VAD and the unprocessed audio.
+void audx_dtx_last(const AudxDtx *dtx, AudxDtxFrame *out);
+
+// Frames per decision since create or reset, indexed by AUDX_DTX_*
+void audx_dtx_counts(const AudxDtx *dtx, unsigned long long counts[3]);
+
+// Back to speech with no noise estimate, e.g. after a stream restarts
+void audx_dtx_reset(AudxDtx *dtx);
+
+void audx_dtx_destroy(AudxDtx *dtx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_DTX_H
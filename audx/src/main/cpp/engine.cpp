@@ -0,0 +1,750 @@
+#include "engine.h"
+#include "arena.h"
+#include "numa.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <sched.h>
+#include <thread>
+#include <vector>
+
+// How often home worker loads are compared, how far apart they may drift
+// (1/8 of the busiest load) and how many streams one pass may move
+#define REBALANCE_INTERVAL_NS 100000000LL
+#define REBALANCE_TOLERANCE_SHIFT 3
+#define REBALANCE_MAX_MOVES 8
+
+namespace {
+
+struct Job {
+  const short *in;
+  short *out;
+  int64_t deadline;
+  uint64_t seq;
+  AudxEngineDoneFn done;
+  AudxEngineTimedDoneFn timed_done; // instead of done, with a timestamp
+  int64_t timestamp_ns;
+  void *ctx;
+};
+
+// Streams are written by whichever worker runs them; padding keeps two
+// streams off one line
+struct alignas(AUDX_STATE_ALIGN) Stream {
+  AudxSession *session;
+  int priority;
+  int policy;
+
+  std::vector<Job> ring; // queued frames, head first
+  unsigned int head;
+  unsigned int count;
+  bool busy;  // a worker holds the head frame
+  bool ready; // the head frame is in a ready queue
+
+  int node;        // memory node of the session's state
+  int home;        // queue the stream's frames go to
+  int last_worker; // worker that ran the previous frame, -1 if none
+
+  uint64_t added; // value of AudxEngine::added when registered
+
+  int64_t cost_ns; // running estimate of one frame's processing time
+  int64_t work_ns; // processing time since the last rebalance
+  float last_vad;
+};
+
+// Only the head frame of an idle stream is ready; the rest wait in its ring
+struct Ready {
+  int64_t key; // deadline (EDF) or submission order (FIFO)
+  uint64_t seq;
+  int stream;
+};
+
+struct ReadyLater {
+  bool operator()(const Ready &a, const Ready &b) const {
+    return a.key != b.key ? a.key > b.key : a.seq > b.seq;
+  }
+};
+
+// Ready frames of one queue, a min-heap per priority class
+struct Queue {
+  std::vector<Ready> ready[AUDX_PRIORITY_CLASSES];
+
+  bool empty() const {
+    for (const auto &heap : ready)
+      if (!heap.empty())
+        return false;
+    return true;
+  }
+
+  // Earliest key over all classes, for choosing a queue to steal from
+  int64_t earliest() const {
+    int64_t key = INT64_MAX;
+    for (const auto &heap : ready)
+      if (!heap.empty() && heap.front().key < key)
+        key = heap.front().key;
+    return key;
+  }
+};
+
+struct alignas(AUDX_CACHE_LINE) Worker {
+  std::condition_variable wake;
+  bool waiting;
+  int node;
+  uint64_t reserved; // streams added up to here fit the worker's workspace
+  std::thread thread;
+};
+
+} // namespace
+
+struct AudxEngine {
+  int scheduling;
+  int affinity;
+  int pin_workers;
+  unsigned int queue_frames;
+
+  // One node with every CPU unless a topology was configured
+  bool numa;
+  AudxNumaTopology topology;
+  AudxArena *arena;                 // sessions made by the engine, by node
+  std::vector<AudxTables *> tables; // replica per node, empty if none
+
+  // Apart from the configuration above, which workers only read
+  alignas(AUDX_CACHE_LINE) mutable std::mutex mutex;
+  std::condition_variable idle; // a frame completed
+
+  std::vector<std::unique_ptr<Stream>> streams;
+  std::vector<Queue> queues; // one shared queue (per node), or one per worker
+  std::vector<int> queue_node;
+  std::vector<Worker> workers;
+  uint64_t seq;
+  uint64_t pending; // queued or running frames
+  uint64_t added;   // streams registered so far
+  bool stopping;
+  int64_t next_rebalance;
+
+  AudxEngineStats stats;
+  std::atomic<AudxMonitor *> monitor;
+};
+
+int64_t audx_engine_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void audx_engine_config_default(AudxEngineConfig *config) {
+  const unsigned int cpus = std::thread::hardware_concurrency();
+  config->threads = cpus ? (int)cpus : 1;
+  config->queue_frames = 4;
+  config->scheduling = AUDX_SCHED_EDF;
+  config->affinity = AUDX_AFFINITY_SHARED;
+  config->pin_workers = 0;
+  config->numa = nullptr;
+}
+
+static int ready_class(const AudxEngine *engine, const Stream &stream) {
+  return engine->scheduling == AUDX_SCHED_EDF ? stream.priority : 0;
+}
+
+// Called with the mutex held. The notified worker stops counting as
+// waiting right away, so the next frame of a burst wakes another one
+// instead of notifying the same worker again before it has run.
+static void notify(Worker &worker) {
+  worker.waiting = false;
+  worker.wake.notify_one();
+}
+
+static void wake_worker(AudxEngine *engine, int queue) {
+  if (engine->affinity == AUDX_AFFINITY_HOME) {
+    notify(engine->workers[queue]);
+    return;
+  }
+  // Prefer the stream's own worker so stealing only happens under load,
+  // then a worker on the queue's node
+  if (engine->affinity == AUDX_AFFINITY_STEAL &&
+      engine->workers[queue].waiting) {
+    notify(engine->workers[queue]);
+    return;
+  }
+  const int node = engine->queue_node[queue];
+  for (int pass = 0; pass < 2; pass++) {
+    for (Worker &worker : engine->workers) {
+      if (worker.waiting && (pass == 1 || worker.node == node)) {
+        notify(worker);
+        return;
+      }
+    }
+  }
+}
+
+static void make_ready(AudxEngine *engine, int id) {
+  Stream &stream = *engine->streams[id];
+  const Job &job = stream.ring[stream.head];
+  const int64_t key =
+      engine->scheduling == AUDX_SCHED_EDF ? job.deadline : (int64_t)job.seq;
+  auto &heap = engine->queues[stream.home].ready[ready_class(engine, stream)];
+  heap.push_back({key, job.seq, id});
+  std::push_heap(heap.begin(), heap.end(), ReadyLater());
+  stream.ready = true;
+  wake_worker(engine, stream.home);
+}
+
+// Queue holding the frames of streams homed on `worker`
+static int own_queue(const AudxEngine *engine, int worker) {
+  if (engine->affinity == AUDX_AFFINITY_SHARED)
+    return engine->workers[worker].node; // 0 without a topology
+  return worker;
+}
+
+// Queue the worker should serve next, or -1 if there is nothing it may run.
+// Other queues on the worker's node are stolen from first; a remote node's
+// frames are only taken when the whole local node is idle, since their
+// state would be read across the interconnect.
+static int pick_queue(const AudxEngine *engine, int worker) {
+  const int own = own_queue(engine, worker);
+  if (!engine->queues[own].empty())
+    return own;
+  if (engine->affinity == AUDX_AFFINITY_HOME ||
+      (engine->affinity == AUDX_AFFINITY_SHARED && !engine->numa))
+    return -1;
+
+  const int node = engine->workers[worker].node;
+  for (int pass = 0; pass < 2; pass++) {
+    int victim = -1;
+    int64_t earliest = INT64_MAX;
+    for (size_t q = 0; q < engine->queues.size(); q++) {
+      if ((engine->queue_node[q] == node) != (pass == 0))
+        continue;
+      const int64_t key = engine->queues[q].earliest();
+      if (key < earliest) {
+        earliest = key;
+        victim = (int)q;
+      }
+    }
+    if (victim >= 0)
+      return victim;
+  }
+  return -1;
+}
+
+// Picks the class to serve: the earliest deadline overall, unless running it
+// first would make a higher class miss a deadline it can still meet
+static int pick_class(const AudxEngine *engine, const Queue &queue,
+                      int64_t now) {
+  int best = -1;
+  for (int c = 0; c < AUDX_PRIORITY_CLASSES; c++) {
+    if (queue.ready[c].empty())
+      continue;
+    if (best < 0 || queue.ready[c].front().key < queue.ready[best].front().key)
+      best = c;
+  }
+  if (engine->scheduling != AUDX_SCHED_EDF)
+    return best;
+
+  const int64_t best_cost =
+      engine->streams[queue.ready[best].front().stream]->cost_ns;
+  for (int h = 0; h < best; h++) {
+    if (queue.ready[h].empty())
+      continue;
+    const Ready &top = queue.ready[h].front();
+    const int64_t cost = engine->streams[top.stream]->cost_ns;
+    if (now + cost <= top.key && now + best_cost + cost > top.key)
+      return h;
+  }
+  return best;
+}
+
+// Moves idle streams from the busiest home worker of a node to the least
+// busy one while that narrows the gap between them. Streams stay on their
+// node.
+static void rebalance_node(AudxEngine *engine, int node) {
+  const size_t n = engine->queues.size();
+  std::vector<int64_t> load(n, 0);
+  for (const auto &stream : engine->streams)
+    if (stream)
+      load[stream->home] += stream->work_ns;
+
+  for (int move = 0; move < REBALANCE_MAX_MOVES; move++) {
+    size_t hi = n, lo = n;
+    for (size_t q = 0; q < n; q++) {
+      if (engine->queue_node[q] != node)
+        continue;
+      if (hi == n || load[q] > load[hi])
+        hi = q;
+      if (lo == n || load[q] < load[lo])
+        lo = q;
+    }
+    if (hi == n)
+      break;
+    const int64_t gap = load[hi] - load[lo];
+    if (gap <= load[hi] >> REBALANCE_TOLERANCE_SHIFT)
+      break;
+
+    // The stream closest to half the gap evens the two out best
+    int best = -1;
+    int64_t best_miss = gap;
+    for (size_t id = 0; id < engine->streams.size(); id++) {
+      const Stream *s = engine->streams[id].get();
+      if (!s || s->home != (int)hi || s->busy || s->ready || s->work_ns == 0)
+        continue;
+      const int64_t miss = std::abs(gap - 2 * s->work_ns);
+      if (miss < best_miss) {
+        best_miss = miss;
+        best = (int)id;
+      }
+    }
+    if (best < 0)
+      break;
+
+    Stream &stream = *engine->streams[best];
+    load[hi] -= stream.work_ns;
+    load[lo] += stream.work_ns;
+    stream.home = (int)lo;
+    engine->stats.rebalanced++;
+  }
+}
+
+static void rebalance(AudxEngine *engine) {
+  for (int node = 0; node < engine->topology.nodes; node++)
+    rebalance_node(engine, node);
+  for (const auto &stream : engine->streams)
+    if (stream)
+      stream->work_ns = 0;
+}
+
+static void pin_to_cpu(int index) {
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return;
+  const int cpus = CPU_COUNT(&allowed);
+  if (cpus == 0)
+    return;
+
+  int target = index % cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed) || target-- > 0)
+      continue;
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(cpu, &one);
+    sched_setaffinity(0, sizeof(one), &one); // 0 is the calling thread
+    return;
+  }
+}
+
+// Pins to the (index / nodes)-th CPU of the worker's node, or binds to the
+// whole node
+static void bind_to_node(const AudxEngine *engine, int index) {
+  const AudxNumaTopology &t = engine->topology;
+  const int node = engine->workers[index].node;
+  const int cpus = CPU_COUNT(&t.cpus[node]);
+  if (!engine->pin_workers || cpus == 0) {
+    audx_numa_bind_thread(&t, node);
+    return;
+  }
+  int target = (index / t.nodes) % cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &t.cpus[node]) || target-- > 0)
+      continue;
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(cpu, &one);
+    sched_setaffinity(0, sizeof(one), &one);
+    return;
+  }
+}
+
+// Called with the mutex held. Grows the worker's workspace for the streams
+// registered since it last looked, so none of them allocates (or faults in
+// fresh scratch memory) on the worker's first frame of it. Sessions lock and
+// prefault the workspace on that frame as their memory flags ask.
+static void reserve_streams(AudxEngine *engine, Worker &self) {
+  if (self.reserved == engine->added)
+    return;
+  AudxScratch *scratch = audx_scratch_thread_local();
+  for (const auto &stream : engine->streams)
+    if (stream && stream->added > self.reserved)
+      audx_session_scratch_reserve(stream->session, scratch);
+  self.reserved = engine->added;
+}
+
+static void worker_loop(AudxEngine *engine, int index) {
+  if (engine->numa)
+    bind_to_node(engine, index);
+  else if (engine->pin_workers)
+    pin_to_cpu(index);
+
+  Worker &self = engine->workers[index];
+  std::unique_lock<std::mutex> lock(engine->mutex);
+  for (;;) {
+    int q;
+    reserve_streams(engine, self);
+    while ((q = pick_queue(engine, index)) < 0 && !engine->stopping) {
+      self.waiting = true;
+      self.wake.wait(lock);
+      self.waiting = false; // also cleared by notify(); spurious wakeups
+      reserve_streams(engine, self);
+    }
+    if (q < 0)
+      return; // stopping and drained
+
+    int64_t now = audx_engine_now_ns();
+    if (engine->affinity == AUDX_AFFINITY_HOME && now >= engine->next_rebalance) {
+      rebalance(engine);
+      engine->next_rebalance = now + REBALANCE_INTERVAL_NS;
+    }
+
+    Queue &queue = engine->queues[q];
+    auto &heap = queue.ready[pick_class(engine, queue, now)];
+    std::pop_heap(heap.begin(), heap.end(), ReadyLater());
+    const int id = heap.back().stream;
+    heap.pop_back();
+
+    Stream &stream = *engine->streams[id];
+    const Job job = stream.ring[stream.head];
+    stream.ready = false;
+    stream.busy = true;
+    if (stream.last_worker >= 0 && stream.last_worker != index)
+      engine->stats.migrations++;
+    if (stream.node != self.node)
+      engine->stats.remote++;
+    stream.last_worker = index;
+    const bool hopeless = engine->scheduling == AUDX_SCHED_EDF &&
+                          now + stream.cost_ns > job.deadline;
+    const int policy = hopeless ? stream.policy : AUDX_LATE_PROCESS;
+    lock.unlock();
+
+    int status;
+    int64_t elapsed = 0;
+    float vad = stream.last_vad;
+    if (policy == AUDX_LATE_DROP) {
+      // Still advances the session's dry delay so later bypass lines up
+      audx_session_process_dry(stream.session, job.in, nullptr);
+      memset(job.out, 0, audx_session_frame_samples(stream.session) *
+                             sizeof(short));
+      status = AUDX_FRAME_DROPPED;
+    } else if (policy == AUDX_LATE_DEGRADE) {
+      // Delayed like processed frames, so the stream's timing is unchanged
+      if (audx_session_process_dry(stream.session, job.in, job.out) != 0 &&
+          job.out != job.in)
+        memmove(job.out, job.in,
+                audx_session_frame_samples(stream.session) * sizeof(short));
+      status = AUDX_FRAME_DEGRADED;
+    } else {
+      vad = audx_session_process_int(stream.session,
+                                     const_cast<short *>(job.in), job.out);
+      const int64_t end = audx_engine_now_ns();
+      elapsed = end - now;
+      stream.last_vad = vad;
+      status = end <= job.deadline ? AUDX_FRAME_ON_TIME : AUDX_FRAME_LATE;
+    }
+
+    if (AudxMonitor *monitor = engine->monitor.load(std::memory_order_acquire))
+      audx_monitor_publish(monitor, id, elapsed, vad, status);
+    if (job.done)
+      job.done(job.ctx, id, vad, status);
+    if (job.timed_done)
+      job.timed_done(job.ctx, id, vad, status,
+                     job.timestamp_ns - audx_session_delay_ns(stream.session));
+
+    lock.lock();
+    if (elapsed > 0) {
+      stream.cost_ns = stream.cost_ns
+                           ? stream.cost_ns + (elapsed - stream.cost_ns) / 8
+                           : elapsed;
+      stream.work_ns += elapsed;
+    }
+
+    AudxEngineClassStats &stats = engine->stats.priority[stream.priority];
+    switch (status) {
+    case AUDX_FRAME_ON_TIME:
+      stats.on_time++;
+      break;
+    case AUDX_FRAME_LATE:
+      stats.late++;
+      break;
+    case AUDX_FRAME_DROPPED:
+      stats.dropped++;
+      break;
+    default:
+      stats.degraded++;
+      break;
+    }
+
+    stream.head = (stream.head + 1) % engine->queue_frames;
+    stream.count--;
+    stream.busy = false;
+    if (stream.count > 0)
+      make_ready(engine, id);
+    engine->pending--;
+    engine->idle.notify_all();
+  }
+}
+
+AudxEngine *audx_engine_create(const AudxEngineConfig *config) {
+  if (!config || config->threads < 1 || config->queue_frames < 1 ||
+      (config->scheduling != AUDX_SCHED_EDF &&
+       config->scheduling != AUDX_SCHED_FIFO) ||
+      config->affinity < AUDX_AFFINITY_SHARED ||
+      config->affinity > AUDX_AFFINITY_HOME)
+    return nullptr;
+
+  if (config->numa && (config->numa->nodes < 1 ||
+                       config->numa->nodes > AUDX_NUMA_MAX_NODES))
+    return nullptr;
+
+  auto *engine = new AudxEngine();
+  engine->scheduling = config->scheduling;
+  engine->affinity = config->affinity;
+  engine->pin_workers = config->pin_workers;
+  engine->queue_frames = config->queue_frames;
+  engine->numa = config->numa != nullptr;
+  if (config->numa) {
+    engine->topology = *config->numa;
+  } else {
+    engine->topology.nodes = 1;
+    CPU_ZERO(&engine->topology.cpus[0]);
+  }
+  const int nodes = engine->topology.nodes;
+  engine->arena = audx_arena_create(nodes, 0);
+
+  // Workers are dealt to nodes in turn
+  engine->workers = std::vector<Worker>(config->threads);
+  for (int i = 0; i < config->threads; i++)
+    engine->workers[i].node = i % nodes;
+  if (config->affinity == AUDX_AFFINITY_SHARED) {
+    for (int node = 0; node < nodes; node++)
+      engine->queue_node.push_back(node);
+  } else {
+    for (const Worker &worker : engine->workers)
+      engine->queue_node.push_back(worker.node);
+  }
+  engine->queues = std::vector<Queue>(engine->queue_node.size());
+  engine->next_rebalance = audx_engine_now_ns() + REBALANCE_INTERVAL_NS;
+
+  std::lock_guard<std::mutex> guard(engine->mutex);
+  for (int i = 0; i < config->threads; i++)
+    engine->workers[i].thread = std::thread(worker_loop, engine, i);
+  return engine;
+}
+
+// New streams go to the queue of their node with the fewest streams, or to
+// any queue when no worker runs on the node (fewer workers than nodes)
+static int least_loaded_queue(const AudxEngine *engine, int node) {
+  std::vector<int> streams(engine->queues.size(), 0);
+  for (const auto &stream : engine->streams)
+    if (stream)
+      streams[stream->home]++;
+  for (int pass = 0; pass < 2; pass++) {
+    int best = -1;
+    for (size_t q = 0; q < streams.size(); q++)
+      if ((pass == 1 || engine->queue_node[q] == node) &&
+          (best < 0 || streams[q] < streams[best]))
+        best = (int)q;
+    if (best >= 0)
+      return best;
+  }
+  return 0;
+}
+
+// Node a new stream belongs to: where its session lives, or else the node
+// with the fewest streams
+static int stream_node(const AudxEngine *engine, const AudxSession *session) {
+  if (!engine->numa)
+    return 0;
+  const int node = audx_numa_node_of_addr(&engine->topology, session);
+  if (node >= 0)
+    return node;
+  // Nodes without a worker count as full
+  std::vector<int> streams(engine->topology.nodes, INT32_MAX);
+  for (const Worker &worker : engine->workers)
+    streams[worker.node] = 0;
+  for (const auto &stream : engine->streams)
+    if (stream && streams[stream->node] != INT32_MAX)
+      streams[stream->node]++;
+  return (int)(std::min_element(streams.begin(), streams.end()) -
+               streams.begin());
+}
+
+int audx_engine_add_stream(AudxEngine *engine, AudxSession *session,
+                           AudxPriority priority, AudxLatePolicy policy) {
+  if (!session || priority < 0 || priority >= AUDX_PRIORITY_CLASSES ||
+      policy < AUDX_LATE_PROCESS || policy > AUDX_LATE_DEGRADE)
+    return -1;
+
+  auto stream = std::make_unique<Stream>();
+  stream->session = session;
+  stream->priority = priority;
+  stream->policy = policy;
+  stream->ring.resize(engine->queue_frames);
+  stream->last_worker = -1;
+
+  std::lock_guard<std::mutex> guard(engine->mutex);
+  stream->node = stream_node(engine, session);
+  stream->home = least_loaded_queue(engine, stream->node);
+  stream->added = ++engine->added;
+  // Idle workers reserve their workspaces for it before its first frame
+  for (Worker &worker : engine->workers)
+    if (worker.waiting)
+      notify(worker);
+  for (size_t id = 0; id < engine->streams.size(); id++) {
+    if (!engine->streams[id]) {
+      engine->streams[id] = std::move(stream);
+      return (int)id;
+    }
+  }
+  engine->streams.push_back(std::move(stream));
+  for (Queue &queue : engine->queues)
+    for (auto &heap : queue.ready)
+      heap.reserve(engine->streams.size());
+  return (int)engine->streams.size() - 1;
+}
+
+void audx_engine_remove_stream(AudxEngine *engine, int stream) {
+  std::unique_lock<std::mutex> lock(engine->mutex);
+  if (stream < 0 || stream >= (int)engine->streams.size() ||
+      !engine->streams[stream])
+    return;
+
+  const Stream *s = engine->streams[stream].get();
+  engine->idle.wait(lock, [s] { return s->count == 0; });
+  engine->streams[stream].reset();
+}
+
+static int submit(AudxEngine *engine, int stream, const Job &job) {
+  std::lock_guard<std::mutex> guard(engine->mutex);
+  if (stream < 0 || stream >= (int)engine->streams.size() ||
+      !engine->streams[stream])
+    return -1;
+
+  Stream &s = *engine->streams[stream];
+  if (s.count == engine->queue_frames)
+    return -1;
+
+  Job &slot = s.ring[(s.head + s.count) % engine->queue_frames];
+  slot = job;
+  slot.seq = engine->seq++;
+  s.count++;
+  engine->stats.priority[s.priority].submitted++;
+  engine->pending++;
+
+  if (s.count == 1 && !s.busy)
+    make_ready(engine, stream);
+  return 0;
+}
+
+int audx_engine_submit(AudxEngine *engine, int stream, const short *in,
+                       short *out, int64_t deadline_ns, AudxEngineDoneFn done,
+                       void *ctx) {
+  return submit(engine, stream,
+                {in, out, deadline_ns, 0, done, nullptr, 0, ctx});
+}
+
+int audx_engine_submit_ts(AudxEngine *engine, int stream, const short *in,
+                          short *out, int64_t deadline_ns,
+                          int64_t timestamp_ns, AudxEngineTimedDoneFn done,
+                          void *ctx) {
+  return submit(engine, stream,
+                {in, out, deadline_ns, 0, nullptr, done, timestamp_ns, ctx});
+}
+
+void audx_engine_drain(AudxEngine *engine) {
+  std::unique_lock<std::mutex> lock(engine->mutex);
+  engine->idle.wait(lock, [engine] { return engine->pending == 0; });
+}
+
+void audx_engine_stats(const AudxEngine *engine, AudxEngineStats *stats) {
+  std::lock_guard<std::mutex> guard(engine->mutex);
+  *stats = engine->stats;
+}
+
+void audx_engine_set_monitor(AudxEngine *engine, AudxMonitor *monitor) {
+  engine->monitor.store(monitor, std::memory_order_release);
+}
+
+int audx_engine_nodes(const AudxEngine *engine) {
+  return engine->topology.nodes;
+}
+
+// Runs fn on a thread bound to `node`, so the memory it first touches is
+// placed there
+template <typename Fn>
+static void run_on_node(const AudxEngine *engine, int node, Fn fn) {
+  std::thread([engine, node, &fn] {
+    if (engine->numa)
+      audx_numa_bind_thread(&engine->topology, node);
+    fn();
+  }).join();
+}
+
+int audx_engine_build_tables(AudxEngine *engine, const AudxTableSpec *specs,
+                             int count) {
+  std::vector<AudxTables *> replicas(engine->topology.nodes, nullptr);
+  bool ok = true;
+  for (int node = 0; node < engine->topology.nodes; node++) {
+    run_on_node(engine, node, [&] {
+      replicas[node] = audx_tables_build(specs, count);
+    });
+    ok = ok && replicas[node];
+  }
+
+  std::lock_guard<std::mutex> guard(engine->mutex);
+  if (!ok || !engine->tables.empty()) {
+    for (AudxTables *tables : replicas)
+      audx_tables_destroy(tables);
+    return -1;
+  }
+  engine->tables = replicas;
+  return 0;
+}
+
+AudxSession *audx_engine_session_create(AudxEngine *engine,
+                                        const AudxSessionConfig *config,
+                                        int node) {
+  if (!config || !engine->arena || node < 0 ||
+      node >= engine->topology.nodes)
+    return nullptr;
+
+  AudxSessionConfig local = *config;
+  {
+    std::lock_guard<std::mutex> guard(engine->mutex);
+    if (!engine->tables.empty())
+      local.tables = engine->tables[node];
+  }
+  // Only the session's own state is first touched here; the workspace it
+  // runs in belongs to each worker, which reserves it in reserve_streams()
+  AudxSession *session = nullptr;
+  run_on_node(engine, node, [&] {
+    session = audx_session_create_in(&local, engine->arena, node);
+  });
+  return session;
+}
+
+void audx_engine_reset_stats(AudxEngine *engine) {
+  std::lock_guard<std::mutex> guard(engine->mutex);
+  memset(&engine->stats, 0, sizeof(engine->stats));
+}
+
+void audx_engine_destroy(AudxEngine *engine) {
+  if (!engine)
+    return;
+
+  audx_engine_drain(engine);
+  {
+    std::lock_guard<std::mutex> guard(engine->mutex);
+    engine->stopping = true;
+    for (Worker &worker : engine->workers)
+      worker.wake.notify_one();
+  }
+  for (Worker &worker : engine->workers)
+    worker.thread.join();
+  audx_arena_destroy(engine->arena);
+  for (AudxTables *tables : engine->tables)
+    audx_tables_destroy(tables);
+  delete engine;
+}
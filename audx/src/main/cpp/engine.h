@@ -0,0 +1,178 @@
+#ifndef AUDX_ENGINE_H
+#define AUDX_ENGINE_H
+
+#include "numa.h"
+#include "session.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Engine --- */
+// Processes frames of many sessions on a pool of worker threads. Every
+// submitted frame carries a deadline; workers serve the earliest deadline
+// first, and a frame whose deadline can no longer be met is handled by its
+// stream's late policy instead of delaying the frames behind it.
+//
+// Frames of one stream are processed one at a time in submission order.
+
+typedef struct AudxEngine AudxEngine;
+
+typedef enum AudxEngineScheduling {
+  AUDX_SCHED_EDF = 0, // earliest deadline first, priority-aware
+  AUDX_SCHED_FIFO,    // submission order, no late handling (baseline)
+} AudxEngineScheduling;
+
+// Which worker runs a stream's frames. Keeping a stream on one worker keeps
+// its session state in that core's caches.
+typedef enum AudxEngineAffinity {
+  AUDX_AFFINITY_SHARED = 0, // one queue, any idle worker takes the next frame
+  AUDX_AFFINITY_STEAL,      // per-worker queues, idle workers steal frames
+  AUDX_AFFINITY_HOME,       // streams stay on a home worker; loads are
+                            // rebalanced periodically by moving idle streams
+} AudxEngineAffinity;
+
+// Higher classes are protected first when not every deadline can be met
+typedef enum AudxPriority {
+  AUDX_PRIORITY_REALTIME = 0, // e.g. the active speaker
+  AUDX_PRIORITY_NORMAL,
+  AUDX_PRIORITY_BACKGROUND, // e.g. recording, transcription feeds
+  AUDX_PRIORITY_CLASSES
+} AudxPriority;
+
+// What happens to a frame that would finish after its deadline
+typedef enum AudxLatePolicy {
+  AUDX_LATE_PROCESS = 0, // process anyway
+  AUDX_LATE_DROP,        // output silence, the session skips the frame
+  AUDX_LATE_DEGRADE,     // output the input unprocessed, delayed as usual
+} AudxLatePolicy;
+// Dropped and degraded frames still reach the session's speaker detector,
+// event ring and DTX with the stream's last VAD (audx_session_process_dry).
+
+// Completion status passed to AudxEngineDoneFn
+#define AUDX_FRAME_ON_TIME 0
+#define AUDX_FRAME_LATE 1 // processed, finished after the deadline
+#define AUDX_FRAME_DROPPED 2
+#define AUDX_FRAME_DEGRADED 3
+
+typedef struct AudxEngineConfig {
+  int threads;      // workers, at least 1
+  int queue_frames; // frames a stream can have queued
+  int scheduling;   // AudxEngineScheduling
+  int affinity;     // AudxEngineAffinity
+  int pin_workers;  // pin worker i to the i-th CPU the process may use
+  // Node-aware placement for multi-socket hosts, NULL for none; see below.
+  // Copied at create.
+  const AudxNumaTopology *numa;
+} AudxEngineConfig;
+
+// Defaults: one worker per CPU, 4 queued frames per stream, EDF, shared
+// queue, no pinning, no NUMA placement
+void audx_engine_config_default(AudxEngineConfig *config);
+
+AudxEngine *audx_engine_create(const AudxEngineConfig *config);
+
+// Registers a session (still owned by the caller) and returns its stream
+// id, or -1. Every worker reserves its own workspace for the session before
+// it runs the stream's first frame.
+int audx_engine_add_stream(AudxEngine *engine, AudxSession *session,
+                           AudxPriority priority, AudxLatePolicy policy);
+
+// Waits for the stream's queued frames, then unregisters it
+void audx_engine_remove_stream(AudxEngine *engine, int stream);
+
+// Called on a worker thread when a frame is done; `vad` is the session's
+// last VAD probability for dropped and degraded frames
+typedef void (*AudxEngineDoneFn)(void *ctx, int stream, float vad,
+                                 int status);
+
+// Queues one frame. `deadline_ns` is on the audx_engine_now_ns() clock.
+// `in` and `out` must stay valid until `done` runs. Returns -1 when the
+// stream's queue is full or the id is invalid.
+int audx_engine_submit(AudxEngine *engine, int stream, const short *in,
+                       short *out, int64_t deadline_ns, AudxEngineDoneFn done,
+                       void *ctx);
+
+// Completion of a frame submitted with a timestamp. `pts_ns` is the
+// presentation timestamp of `out`: the capture time of the content it
+// carries, i.e. the submitted timestamp minus audx_session_delay_ns(). This
+// holds for degraded frames too, which are delayed like processed ones.
+typedef void (*AudxEngineTimedDoneFn)(void *ctx, int stream, float vad,
+                                      int status, int64_t pts_ns);
+
+// audx_engine_submit() for a frame captured at `timestamp_ns` (any clock)
+int audx_engine_submit_ts(AudxEngine *engine, int stream, const short *in,
+                          short *out, int64_t deadline_ns,
+                          int64_t timestamp_ns, AudxEngineTimedDoneFn done,
+                          void *ctx);
+
+// Blocks until every queued frame is done
+void audx_engine_drain(AudxEngine *engine);
+
+typedef struct AudxEngineClassStats {
+  uint64_t submitted;
+  uint64_t on_time;
+  uint64_t late;
+  uint64_t dropped;
+  uint64_t degraded;
+} AudxEngineClassStats;
+
+typedef struct AudxEngineStats {
+  AudxEngineClassStats priority[AUDX_PRIORITY_CLASSES];
+  uint64_t migrations; // frames run on another worker than the stream's last
+  uint64_t rebalanced; // streams moved to another home worker
+  uint64_t remote;     // frames run on another node than their stream's
+} AudxEngineStats;
+
+void audx_engine_stats(const AudxEngine *engine, AudxEngineStats *stats);
+
+void audx_engine_reset_stats(AudxEngine *engine);
+
+// Publishes every frame to the monitor slot numbered like its stream id,
+// with its status; NULL stops. Frames already running may still publish
+// to the previous monitor, so destroy it only after audx_engine_drain().
+void audx_engine_set_monitor(AudxEngine *engine, AudxMonitor *monitor);
+
+// CLOCK_MONOTONIC in nanoseconds
+int64_t audx_engine_now_ns(void);
+
+// Waits for queued frames and joins the workers; sessions are not destroyed
+void audx_engine_destroy(AudxEngine *engine);
+
+/* --- NUMA placement --- */
+// With a topology (audx_numa_topology()), worker i runs on node i % nodes,
+// bound to that node's CPUs (or pinned to one of them with pin_workers).
+// Each stream belongs to the node its session's memory is on, or the node
+// with the fewest streams when the kernel cannot tell, and is queued there:
+// the shared queue becomes one queue per node, and home workers are chosen
+// and rebalanced within the node. Idle workers steal from their own node
+// first and take a remote node's frames only when their whole node is idle.
+// AudxEngineStats.remote counts frames run on another node than their
+// stream's.
+
+int audx_engine_nodes(const AudxEngine *engine);
+
+// Creates a session whose wrapper state is allocated and first touched by
+// a thread bound to `node`, in an arena the engine owns; register it with
+// audx_engine_add_stream() and destroy it before the engine. With tables
+// built by audx_engine_build_tables(), the session reads its node's
+// replica instead of config->tables. Works without a topology too (node 0).
+AudxSession *audx_engine_session_create(AudxEngine *engine,
+                                        const AudxSessionConfig *config,
+                                        int node);
+
+// Builds one replica of the filter banks for `specs` per node, each written
+// by a thread on its node, for sessions made by audx_engine_session_create().
+// The core's model weights are read-only pages of libaudx_src.so in the
+// page cache and cannot be replicated from here. Returns -1 if replicas
+// exist already or building fails.
+int audx_engine_build_tables(AudxEngine *engine, const AudxTableSpec *specs,
+                             int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_ENGINE_H
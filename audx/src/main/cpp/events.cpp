@@ -0,0 +1,106 @@
+#include "events.h"
+
+#include <atomic>
+#include <ctime>
+
+namespace {
+
+// Bounded MPMC queue cell (Vyukov): `seq` equals the position when the cell
+// is free for that position's producer and position + 1 once it is filled
+struct EventCell {
+  std::atomic<size_t> seq;
+  AudxEvent event;
+};
+
+} // namespace
+
+struct AudxEventRing {
+  size_t mask;
+  EventCell *cells;
+
+  // Producers and the consumer each get their own cache line
+  alignas(64) std::atomic<size_t> head; // next position to push
+  alignas(64) size_t tail;              // next position to drain
+  std::atomic<uint64_t> dropped;
+};
+
+static uint64_t now_ns() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+AudxEventRing *audx_events_create(size_t capacity) {
+  if (capacity == 0 || capacity > ((size_t)1 << 24))
+    return nullptr;
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+
+  auto *ring = new AudxEventRing();
+  ring->mask = size - 1;
+  ring->cells = new EventCell[size];
+  for (size_t i = 0; i < size; i++)
+    ring->cells[i].seq.store(i, std::memory_order_relaxed);
+  ring->head.store(0, std::memory_order_relaxed);
+  ring->tail = 0;
+  ring->dropped.store(0, std::memory_order_relaxed);
+  return ring;
+}
+
+size_t audx_events_capacity(const AudxEventRing *ring) {
+  return ring->mask + 1;
+}
+
+int audx_events_push(AudxEventRing *ring, const AudxEvent *event) {
+  size_t pos = ring->head.load(std::memory_order_relaxed);
+  EventCell *cell;
+  for (;;) {
+    cell = &ring->cells[pos & ring->mask];
+    const size_t seq = cell->seq.load(std::memory_order_acquire);
+    const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0) {
+      if (ring->head.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      // The cell still holds an event from one lap ago
+      ring->dropped.fetch_add(1, std::memory_order_relaxed);
+      return -1;
+    } else {
+      pos = ring->head.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->event = *event;
+  if (cell->event.time_ns == 0)
+    cell->event.time_ns = now_ns();
+  cell->seq.store(pos + 1, std::memory_order_release);
+  return 0;
+}
+
+size_t audx_events_drain(AudxEventRing *ring, AudxEvent *out, size_t max) {
+  size_t count = 0;
+  size_t pos = ring->tail;
+  while (count < max) {
+    EventCell &cell = ring->cells[pos & ring->mask];
+    if (cell.seq.load(std::memory_order_acquire) != pos + 1)
+      break; // empty, or the next producer has not finished writing
+    out[count++] = cell.event;
+    cell.seq.store(pos + ring->mask + 1, std::memory_order_release);
+    pos++;
+  }
+  ring->tail = pos;
+  return count;
+}
+
+uint64_t audx_events_dropped(const AudxEventRing *ring) {
+  return ring->dropped.load(std::memory_order_relaxed);
+}
+
+void audx_events_destroy(AudxEventRing *ring) {
+  if (!ring)
+    return;
+  delete[] ring->cells;
+  delete ring;
+}
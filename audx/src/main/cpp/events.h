@@ -0,0 +1,68 @@
+#ifndef AUDX_EVENTS_H
+#define AUDX_EVENTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Event channel --- */
+// Carries per-frame results (VAD, speech segments) from processing threads
+// to one consumer, e.g. the Kotlin side. Producers write fixed-size records
+// into a bounded lock-free ring and never block or call into the JVM; the
+// consumer drains them in batches, so one JNI call covers many frames. When
+// the ring is full new events are dropped and counted.
+//
+// Any number of threads may push. Only one thread may drain.
+
+typedef struct AudxEventRing AudxEventRing;
+
+typedef enum AudxEventType {
+  AUDX_EVENT_VAD = 1,          // value: VAD probability of the frame
+  AUDX_EVENT_SPEECH_START = 2, // value: VAD probability that started it
+  AUDX_EVENT_SPEECH_END = 3,   // aux: segment length in frames
+  AUDX_EVENT_USER = 256,       // first type free for applications
+} AudxEventType;
+
+// Segment hysteresis of the session's speech events: a segment starts at a
+// VAD of AUDX_EVENT_SPEECH_ON and ends after the VAD has stayed below
+// AUDX_EVENT_SPEECH_OFF for AUDX_EVENT_SPEECH_HANGOVER frames
+#define AUDX_EVENT_SPEECH_ON 0.6f
+#define AUDX_EVENT_SPEECH_OFF 0.3f
+#define AUDX_EVENT_SPEECH_HANGOVER 30
+
+// 32 bytes, host byte order. The Kotlin reader depends on this layout.
+typedef struct AudxEvent {
+  uint32_t type;    // AudxEventType
+  int32_t stream;   // producer-defined stream index
+  uint64_t frame;   // frame index within the stream
+  uint64_t time_ns; // CLOCK_MONOTONIC when the event was pushed
+  float value;
+  int32_t aux;
+} AudxEvent;
+
+// `capacity` is rounded up to a power of two
+AudxEventRing *audx_events_create(size_t capacity);
+
+size_t audx_events_capacity(const AudxEventRing *ring);
+
+// Lock-free; stamps time_ns when it is 0. Returns -1 if the ring is full.
+int audx_events_push(AudxEventRing *ring, const AudxEvent *event);
+
+// Copies up to `max` events, oldest first, into `out`. Returns the count.
+size_t audx_events_drain(AudxEventRing *ring, AudxEvent *out, size_t max);
+
+// Events dropped because the ring was full
+uint64_t audx_events_dropped(const AudxEventRing *ring);
+
+// No producer may be pushing: detach every session first, between its
+// frames (audx_session_set_events() with NULL)
+void audx_events_destroy(AudxEventRing *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_EVENTS_H
@@ -0,0 +1,149 @@
+#include "memlock.h"
+#include "audx.h"
+
+#include <algorithm>
+#include <dlfcn.h>
+#include <link.h>
+#include <map>
+#include <mutex>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static std::mutex lock_mutex;
+static std::map<uintptr_t, int> locked_pages; // page -> lock count
+
+static uintptr_t page_size() {
+  static const uintptr_t size = (uintptr_t)sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+void audx_mem_prefault(const void *addr, size_t len) {
+  if (!addr || len == 0)
+    return;
+  const uintptr_t page = page_size();
+  const auto *p = (const volatile char *)addr;
+  for (size_t off = 0; off < len; off += page)
+    (void)p[off];
+  (void)p[len - 1];
+}
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23 // Linux 5.14, missing from older headers
+#endif
+
+void audx_mem_prefault_write(void *addr, size_t len) {
+  if (!addr || len == 0)
+    return;
+  const uintptr_t page = page_size();
+  const uintptr_t first = (uintptr_t)addr & ~(page - 1);
+  const uintptr_t end = ((uintptr_t)addr + len + page - 1) & ~(page - 1);
+  if (madvise((void *)first, end - first, MADV_POPULATE_WRITE) == 0)
+    return;
+
+  // An atomic add of zero writes without racing other writers of the page
+  auto *p = (char *)addr;
+  for (size_t off = 0; off < len; off += page)
+    __atomic_fetch_add(p + off, 0, __ATOMIC_RELAXED);
+  __atomic_fetch_add(p + len - 1, 0, __ATOMIC_RELAXED);
+}
+
+int audx_mem_lock(const void *addr, size_t len) {
+  if (!addr || len == 0)
+    return 0;
+
+  const uintptr_t page = page_size();
+  const uintptr_t first = (uintptr_t)addr & ~(page - 1);
+  const uintptr_t end = ((uintptr_t)addr + len + page - 1) & ~(page - 1);
+  int result = 0;
+
+  std::lock_guard<std::mutex> guard(lock_mutex);
+  for (uintptr_t p = first; p < end; p += page) {
+    auto it = locked_pages.find(p);
+    if (it != locked_pages.end()) {
+      it->second++;
+      continue;
+    }
+    if (mlock((const void *)p, page) != 0) {
+      result = -1;
+      continue;
+    }
+    locked_pages.emplace(p, 1);
+  }
+  return result;
+}
+
+void audx_mem_unlock(const void *addr, size_t len) {
+  if (!addr || len == 0)
+    return;
+
+  const uintptr_t page = page_size();
+  const uintptr_t first = (uintptr_t)addr & ~(page - 1);
+  const uintptr_t end = ((uintptr_t)addr + len + page - 1) & ~(page - 1);
+
+  std::lock_guard<std::mutex> guard(lock_mutex);
+  for (uintptr_t p = first; p < end; p += page) {
+    auto it = locked_pages.find(p);
+    if (it == locked_pages.end())
+      continue; // never locked, e.g. mlock was refused
+    if (--it->second == 0) {
+      munlock((const void *)p, page);
+      locked_pages.erase(it);
+    }
+  }
+}
+
+struct SegmentQuery {
+  const char *path;
+  AudxMemRangeFn fn;
+  void *ctx;
+};
+
+static int visit_object(struct dl_phdr_info *info, size_t, void *data) {
+  auto *query = (SegmentQuery *)data;
+  if (!info->dlpi_name || strcmp(info->dlpi_name, query->path) != 0)
+    return 0;
+
+  // The loader makes the RELRO part of the writable segment read-only after
+  // relocation (whole pages, end rounded down), so it must not be written
+  const uintptr_t page = page_size();
+  uintptr_t relro_start = 0, relro_end = 0;
+  for (int i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr) &ph = info->dlpi_phdr[i];
+    if (ph.p_type == PT_GNU_RELRO) {
+      relro_start = (info->dlpi_addr + ph.p_vaddr) & ~(page - 1);
+      relro_end = (info->dlpi_addr + ph.p_vaddr + ph.p_memsz) & ~(page - 1);
+    }
+  }
+
+  for (int i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr) &ph = info->dlpi_phdr[i];
+    if (ph.p_type != PT_LOAD || ph.p_memsz == 0)
+      continue;
+    const uintptr_t start = info->dlpi_addr + ph.p_vaddr;
+    const uintptr_t end = start + ph.p_memsz;
+    if (!(ph.p_flags & PF_W)) {
+      query->fn((const void *)start, end - start, 0, query->ctx);
+      continue;
+    }
+
+    const uintptr_t ro_start = std::min(std::max(relro_start, start), end);
+    const uintptr_t ro_end = std::min(std::max(relro_end, ro_start), end);
+    if (ro_start > start)
+      query->fn((const void *)start, ro_start - start, 1, query->ctx);
+    if (ro_end > ro_start)
+      query->fn((const void *)ro_start, ro_end - ro_start, 0, query->ctx);
+    if (end > ro_end)
+      query->fn((const void *)ro_end, end - ro_end, 1, query->ctx);
+  }
+  return 1;
+}
+
+void audx_mem_core_segments(AudxMemRangeFn fn, void *ctx) {
+  Dl_info info;
+  if (!dladdr((const void *)&audx_process_int, &info) || !info.dli_fname)
+    return;
+
+  SegmentQuery query = {info.dli_fname, fn, ctx};
+  dl_iterate_phdr(visit_object, &query);
+}
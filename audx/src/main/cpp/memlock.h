@@ -0,0 +1,46 @@
+#ifndef AUDX_MEMLOCK_H
+#define AUDX_MEMLOCK_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Memory residency --- */
+// Keeps memory used on the audio thread resident. Locks are counted per
+// page, so ranges that share pages (heap neighbours, the core library used
+// by several sessions) can be locked and released independently.
+
+// `writable` is 0 for ranges that are only read while processing (filter
+// banks, the core library's code and constants)
+typedef void (*AudxMemRangeFn)(const void *addr, size_t len, int writable,
+                               void *ctx);
+
+// Touches every page of a read-only range so later reads do not fault. On
+// fresh anonymous memory this maps the shared zero page, so the first write
+// would still fault: use audx_mem_prefault_write() for memory that is
+// written.
+void audx_mem_prefault(const void *addr, size_t len);
+
+// Makes every page of the range present and writable without changing its
+// contents, so later writes take no fault either (MADV_POPULATE_WRITE, or
+// an atomic add of zero to one byte per page on kernels without it). Safe
+// while other threads write the same pages.
+void audx_mem_prefault_write(void *addr, size_t len);
+
+// Returns 0 when every page is locked, -1 if mlock was refused (EPERM,
+// RLIMIT_MEMLOCK); pages that could not be locked are left unlocked
+int audx_mem_lock(const void *addr, size_t len);
+
+void audx_mem_unlock(const void *addr, size_t len);
+
+// Enumerates the loaded segments of the core library (weights, tables and
+// code used by audx_process)
+void audx_mem_core_segments(AudxMemRangeFn fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_MEMLOCK_H
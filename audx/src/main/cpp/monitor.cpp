@@ -0,0 +1,199 @@
+#include "monitor.h"
+#include "engine.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(AudxMonitorHeader) == 64, "header is one cache line");
+static_assert(sizeof(AudxMonitorSlot) == 128, "slot is two cache lines");
+
+// A writer that died mid-update leaves its slot odd for good
+#define MONITOR_READ_TRIES 10000
+
+struct AudxMonitor {
+  char *base;
+  size_t bytes;
+  int slots;
+  char *path; // set for the writer, which removes the file
+};
+
+static AudxMonitorSlot *slot_at(const AudxMonitor *monitor, int slot) {
+  return (AudxMonitorSlot *)(monitor->base + sizeof(AudxMonitorHeader) +
+                             sizeof(AudxMonitorSlot) * (size_t)slot);
+}
+
+// The page is plain memory shared with other processes; fields are
+// accessed through the atomic builtins so both sides stay race-free
+template <typename T> static void store(T *field, T value) {
+  __atomic_store(field, &value, __ATOMIC_RELAXED);
+}
+
+template <typename T> static T load(const T *field) {
+  T value;
+  __atomic_load(field, &value, __ATOMIC_RELAXED);
+  return value;
+}
+
+AudxMonitor *audx_monitor_create(const char *path, int slots) {
+  if (!path || slots < 1)
+    return nullptr;
+
+  const size_t bytes =
+      sizeof(AudxMonitorHeader) + sizeof(AudxMonitorSlot) * (size_t)slots;
+  const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return nullptr;
+  void *base = MAP_FAILED;
+  if (ftruncate(fd, (off_t)bytes) == 0)
+    base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    unlink(path);
+    return nullptr;
+  }
+
+  auto *monitor = (AudxMonitor *)calloc(1, sizeof(AudxMonitor));
+  char *owned_path = strdup(path);
+  if (!monitor || !owned_path) {
+    free(monitor);
+    free(owned_path);
+    munmap(base, bytes);
+    unlink(path);
+    return nullptr;
+  }
+  monitor->base = (char *)base;
+  monitor->bytes = bytes;
+  monitor->slots = slots;
+  monitor->path = owned_path;
+
+  // The file starts zeroed; the magic goes last so readers never see a
+  // half-written header
+  auto *header = (AudxMonitorHeader *)base;
+  header->version = AUDX_MONITOR_VERSION;
+  header->slot_bytes = sizeof(AudxMonitorSlot);
+  header->slots = (uint32_t)slots;
+  header->pid = (int32_t)getpid();
+  header->start_ns = (uint64_t)audx_engine_now_ns();
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(header->magic, AUDX_MONITOR_MAGIC, sizeof(AUDX_MONITOR_MAGIC));
+  return monitor;
+}
+
+AudxMonitor *audx_monitor_open(const char *path) {
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+  struct stat st;
+  void *base = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(AudxMonitorHeader))
+    base = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+    return nullptr;
+
+  const size_t bytes = (size_t)st.st_size;
+  const auto *header = (const AudxMonitorHeader *)base;
+  const bool ok =
+      memcmp(header->magic, AUDX_MONITOR_MAGIC, sizeof(AUDX_MONITOR_MAGIC)) ==
+          0 &&
+      header->version == AUDX_MONITOR_VERSION &&
+      header->slot_bytes == sizeof(AudxMonitorSlot) &&
+      header->slots <= (bytes - sizeof(AudxMonitorHeader)) /
+                           sizeof(AudxMonitorSlot);
+  auto *monitor = ok ? (AudxMonitor *)calloc(1, sizeof(AudxMonitor)) : nullptr;
+  if (!monitor) {
+    munmap(base, bytes);
+    return nullptr;
+  }
+  monitor->base = (char *)base;
+  monitor->bytes = bytes;
+  monitor->slots = (int)header->slots;
+  return monitor;
+}
+
+int audx_monitor_slots(const AudxMonitor *monitor) { return monitor->slots; }
+
+void audx_monitor_publish(AudxMonitor *monitor, int slot, int64_t busy_ns,
+                          float vad, int status) {
+  if (!monitor || slot < 0 || slot >= monitor->slots)
+    return;
+  AudxMonitorSlot *s = slot_at(monitor, slot);
+
+  // Single writer: the odd sequence number marks the update in progress
+  const uint32_t seq = load(&s->seq);
+  store(&s->seq, seq + 1);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  store(&s->active, 1u);
+  store(&s->frames, load(&s->frames) + 1);
+  if (busy_ns > 0)
+    store(&s->busy_ns, load(&s->busy_ns) + (uint64_t)busy_ns);
+  switch (status) {
+  case AUDX_FRAME_LATE:
+    store(&s->late, load(&s->late) + 1);
+    break;
+  case AUDX_FRAME_DROPPED:
+    store(&s->dropped, load(&s->dropped) + 1);
+    break;
+  case AUDX_FRAME_DEGRADED:
+    store(&s->degraded, load(&s->degraded) + 1);
+    break;
+  default:
+    break;
+  }
+  if ((status == AUDX_FRAME_ON_TIME || status == AUDX_FRAME_LATE) &&
+      vad >= AUDX_MONITOR_SPEECH_VAD)
+    store(&s->speech_frames, load(&s->speech_frames) + 1);
+  store(&s->last_vad, vad);
+  store(&s->updated_ns, (uint64_t)audx_engine_now_ns());
+
+  __atomic_store_n(&s->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+int audx_monitor_read(const AudxMonitor *monitor, int slot,
+                      AudxMonitorSlot *out) {
+  if (!monitor || slot < 0 || slot >= monitor->slots)
+    return -1;
+  const AudxMonitorSlot *s = slot_at(monitor, slot);
+
+  for (int tries = 0; tries < MONITOR_READ_TRIES; tries++) {
+    const uint32_t before = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+    if (before & 1) {
+      sched_yield(); // update in progress, possibly preempted
+      continue;
+    }
+    out->active = load(&s->active);
+    out->frames = load(&s->frames);
+    out->busy_ns = load(&s->busy_ns);
+    out->late = load(&s->late);
+    out->dropped = load(&s->dropped);
+    out->degraded = load(&s->degraded);
+    out->speech_frames = load(&s->speech_frames);
+    out->updated_ns = load(&s->updated_ns);
+    out->last_vad = load(&s->last_vad);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (load(&s->seq) == before) {
+      out->seq = before;
+      memset(out->reserved, 0, sizeof(out->reserved));
+      return 0;
+    }
+  }
+  return -1;
+}
+
+void audx_monitor_destroy(AudxMonitor *monitor) {
+  if (!monitor)
+    return;
+  munmap(monitor->base, monitor->bytes);
+  if (monitor->path) {
+    unlink(monitor->path);
+    free(monitor->path);
+  }
+  free(monitor);
+}
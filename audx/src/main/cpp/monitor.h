@@ -0,0 +1,84 @@
+#ifndef AUDX_MONITOR_H
+#define AUDX_MONITOR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Monitor page --- */
+// Publishes per-stream counters into a shared-memory file that external
+// tools map read-only (e.g. audx_monitor). Each stream owns one slot,
+// protected by a seqlock: the processing thread bumps the slot's sequence
+// number around its update and never waits, and readers retry when the
+// number changed or was odd, so monitoring never blocks or slows the
+// frames. Counters are cumulative; readers derive rates from two samples.
+//
+// Layout, host byte order, at offset 0 of the file:
+//   AudxMonitorHeader (64 bytes)
+//   AudxMonitorSlot slots[header.slots] (header.slot_bytes each)
+
+#define AUDX_MONITOR_MAGIC "AUDXMON"
+#define AUDX_MONITOR_VERSION 1
+
+// Frames are 10ms at every rate; RTF = busy_ns / (frames * FRAME_NS)
+#define AUDX_MONITOR_FRAME_NS 10000000ull
+
+// Frames with at least this VAD probability count as speech
+#define AUDX_MONITOR_SPEECH_VAD 0.5f
+
+typedef struct AudxMonitorHeader {
+  char magic[8]; // AUDX_MONITOR_MAGIC, NUL padded
+  uint32_t version;
+  uint32_t slot_bytes;
+  uint32_t slots;
+  int32_t pid;       // writer process
+  uint64_t start_ns; // CLOCK_MONOTONIC when the page was created
+  uint8_t reserved[32];
+} AudxMonitorHeader;
+
+typedef struct AudxMonitorSlot {
+  uint32_t seq;           // odd while the writer updates the slot
+  uint32_t active;        // 1 once the slot has been published to
+  uint64_t frames;        // frames handled, incl. dropped and degraded ones
+  uint64_t busy_ns;       // processing time of those frames
+  uint64_t late;          // processed, finished after the deadline
+  uint64_t dropped;       // replaced by silence, not processed
+  uint64_t degraded;      // passed through unprocessed
+  uint64_t speech_frames; // processed with VAD >= AUDX_MONITOR_SPEECH_VAD
+  uint64_t updated_ns;    // CLOCK_MONOTONIC of the last update
+  float last_vad;
+  uint8_t reserved[60]; // pads the slot to two cache lines
+} AudxMonitorSlot;
+
+typedef struct AudxMonitor AudxMonitor;
+
+// Creates (or truncates) `path`, e.g. under /dev/shm, with `slots` zeroed
+// slots and maps it for writing. The file is removed by destroy.
+AudxMonitor *audx_monitor_create(const char *path, int slots);
+
+// Maps an existing page read-only. Returns NULL if it is not a page of this
+// version.
+AudxMonitor *audx_monitor_open(const char *path);
+
+int audx_monitor_slots(const AudxMonitor *monitor);
+
+// Adds one frame to `slot`. `status` is the frame's AUDX_FRAME_* (engine.h),
+// AUDX_FRAME_ON_TIME outside the engine. Slots must each have one writer at
+// a time; out-of-range slots are ignored.
+void audx_monitor_publish(AudxMonitor *monitor, int slot, int64_t busy_ns,
+                          float vad, int status);
+
+// Consistent snapshot of `slot`. Returns -1 for an out-of-range slot, or
+// when the writer stopped in the middle of an update.
+int audx_monitor_read(const AudxMonitor *monitor, int slot,
+                      AudxMonitorSlot *out);
+
+void audx_monitor_destroy(AudxMonitor *monitor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_MONITOR_H
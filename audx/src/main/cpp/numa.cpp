@@ -0,0 +1,114 @@
+#include "numa.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// get_mempolicy(2) flags; called through syscall() to avoid libnuma
+#define NUMA_MPOL_F_NODE 1
+#define NUMA_MPOL_F_ADDR 2
+
+// Parses a sysfs list such as "0-3,8,10-11", calling fn for each number
+template <typename Fn> static bool parse_list(const char *text, Fn fn) {
+  const char *p = text;
+  while (*p && *p != '\n') {
+    char *end;
+    const long first = strtol(p, &end, 10);
+    if (end == p || first < 0)
+      return false;
+    long last = first;
+    p = end;
+    if (*p == '-') {
+      last = strtol(p + 1, &end, 10);
+      if (end == p + 1 || last < first)
+        return false;
+      p = end;
+    }
+    for (long n = first; n <= last; n++)
+      fn((int)n);
+    if (*p == ',')
+      p++;
+  }
+  return true;
+}
+
+static bool read_line(const char *path, char *buf, size_t size) {
+  FILE *f = fopen(path, "re");
+  if (!f)
+    return false;
+  const bool ok = fgets(buf, (int)size, f) != nullptr;
+  fclose(f);
+  return ok;
+}
+
+int audx_numa_topology(const char *sysfs_root, AudxNumaTopology *topology) {
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    CPU_ZERO(&allowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+      CPU_SET(cpu, &allowed);
+  }
+
+  memset(topology, 0, sizeof(*topology));
+  const char *root = sysfs_root ? sysfs_root : "/sys";
+  char path[512];
+  char list[4096];
+  snprintf(path, sizeof(path), "%s/devices/system/node/online", root);
+  if (read_line(path, list, sizeof(list))) {
+    parse_list(list, [&](int id) {
+      if (topology->nodes == AUDX_NUMA_MAX_NODES)
+        return;
+      char cpus[4096];
+      snprintf(path, sizeof(path), "%s/devices/system/node/node%d/cpulist",
+               root, id);
+      if (!read_line(path, cpus, sizeof(cpus)))
+        return;
+      cpu_set_t *set = &topology->cpus[topology->nodes];
+      CPU_ZERO(set);
+      parse_list(cpus, [&](int cpu) {
+        if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+          CPU_SET(cpu, set);
+      });
+      if (CPU_COUNT(set) > 0)
+        topology->id[topology->nodes++] = id;
+    });
+  }
+
+  if (topology->nodes == 0) {
+    topology->nodes = 1;
+    topology->id[0] = 0;
+    topology->cpus[0] = allowed;
+  }
+  return topology->nodes;
+}
+
+int audx_numa_node_of_cpu(const AudxNumaTopology *topology, int cpu) {
+  if (cpu < 0 || cpu >= CPU_SETSIZE)
+    return -1;
+  for (int n = 0; n < topology->nodes; n++)
+    if (CPU_ISSET(cpu, &topology->cpus[n]))
+      return n;
+  return -1;
+}
+
+int audx_numa_bind_thread(const AudxNumaTopology *topology, int node) {
+  if (node < 0 || node >= topology->nodes)
+    return -1;
+  return sched_setaffinity(0, sizeof(cpu_set_t), &topology->cpus[node]);
+}
+
+int audx_numa_node_of_addr(const AudxNumaTopology *topology,
+                           const void *addr) {
+#ifdef SYS_get_mempolicy
+  int id = -1;
+  if (syscall(SYS_get_mempolicy, &id, nullptr, 0UL, addr,
+              NUMA_MPOL_F_NODE | NUMA_MPOL_F_ADDR) != 0)
+    return -1;
+  for (int n = 0; n < topology->nodes; n++)
+    if (topology->id[n] == id)
+      return n;
+#endif
+  return -1;
+}
@@ -0,0 +1,50 @@
+#ifndef AUDX_NUMA_H
+#define AUDX_NUMA_H
+
+#include <sched.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- NUMA topology --- */
+// Memory nodes of the machine and the CPUs attached to each, read from
+// sysfs, so multi-socket hosts can keep a stream's state, the tables it
+// reads and the worker that processes it on one node. Linux places a page
+// on the node of the thread that first touches it, so memory allocated
+// and initialised by a thread bound to a node stays local to that node.
+//
+// Nodes are numbered by index here; `id` maps back to the kernel's node
+// number. Nodes without a CPU the process may use (memory-only nodes, or
+// ones excluded by the affinity mask) are left out.
+
+#define AUDX_NUMA_MAX_NODES 16
+
+typedef struct AudxNumaTopology {
+  int nodes; // at least 1
+  int id[AUDX_NUMA_MAX_NODES];
+  cpu_set_t cpus[AUDX_NUMA_MAX_NODES];
+} AudxNumaTopology;
+
+// Reads <sysfs_root>/devices/system/node (NULL reads /sys). Without NUMA
+// information, e.g. on phones or kernels built without NUMA, reports one
+// node with every CPU the process may use. Returns the node count.
+int audx_numa_topology(const char *sysfs_root, AudxNumaTopology *topology);
+
+// Node index of `cpu`, -1 if it belongs to none
+int audx_numa_node_of_cpu(const AudxNumaTopology *topology, int cpu);
+
+// Restricts the calling thread to the CPUs of node `node`. Returns -1 for
+// a bad index or when the kernel refuses.
+int audx_numa_bind_thread(const AudxNumaTopology *topology, int node);
+
+// Node index of the page holding `addr`, which must have been touched, or
+// -1 when the kernel cannot tell (no NUMA support, seccomp filters)
+int audx_numa_node_of_addr(const AudxNumaTopology *topology,
+                           const void *addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_NUMA_H
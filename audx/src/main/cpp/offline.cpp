@@ -0,0 +1,56 @@
+#include "offline.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+int audx_offline_reprocess(const AudxSessionConfig *config,
+                           const short *input, size_t input_samples,
+                           size_t start, size_t count, unsigned int warmup_ms,
+                           short *out) {
+  if (!config || !input || !out || count == 0 || start >= input_samples ||
+      count > input_samples - start)
+    return -1;
+
+  // Prefaulting runs two silent frames through the core at create; the
+  // warm-up only reproduces the full pass if they run here too
+  AudxSessionConfig session_config = *config;
+  session_config.memory_flags &= AUDX_MEMORY_PREFAULT;
+  AudxSession *session = audx_session_create(&session_config);
+  if (!session)
+    return -1;
+  const size_t n = audx_session_frame_samples(session);
+  short *in = (short *)malloc(2 * n * sizeof(short));
+  if (!in) {
+    audx_session_destroy(session);
+    return -1;
+  }
+  short *frame_out = in + n;
+
+  // Whole frames of warm-up before the first frame needed
+  const size_t first = start / n;
+  const size_t last = (start + count - 1) / n;
+  const size_t warm_frames = (warmup_ms + 9) / 10;
+  const size_t from = first > warm_frames ? first - warm_frames : 0;
+
+  // Frames before `first` only warm up the session; a trailing partial
+  // frame is zero-padded as in the full pass
+  for (size_t f = from; f <= last; f++) {
+    const size_t offset = f * n;
+    const size_t avail = std::min(n, input_samples - offset);
+    memcpy(in, input + offset, avail * sizeof(short));
+    memset(in + avail, 0, (n - avail) * sizeof(short));
+    audx_session_process_int(session, in, frame_out);
+    if (f < first)
+      continue;
+
+    const size_t lo = std::max(offset, start);
+    const size_t hi = std::min(offset + n, start + count);
+    memcpy(out + (lo - start), frame_out + (lo - offset),
+           (hi - lo) * sizeof(short));
+  }
+
+  free(in);
+  audx_session_destroy(session);
+  return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef AUDX_OFFLINE_H
+#define AUDX_OFFLINE_H
+
+#include "session.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Offline range reprocessing --- */
+// Re-renders any range of a signal that was processed in one pass with
+// audx_session_process_int(), at a cost set by the length of the range
+// rather than its position in the file.
+//
+// Nothing is checkpointed during the full pass. The core's AudxState is
+// opaque and cannot be saved, and the wrapper's own state (resampler
+// history, the dry delay line) is rebuilt exactly by the audio it follows.
+// A fresh session therefore starts warmup_ms before the range, on a frame
+// boundary of the full pass, and re-warms on the audio there. Output inside
+// the range converges to the full pass as the warm-up grows, and matches it
+// exactly when the warm-up reaches back to the start of the signal.
+
+#define AUDX_OFFLINE_WARMUP_MS_DEFAULT 1000
+
+// Reprocesses output samples [start, start + count) of `input`, the
+// complete signal, as a full pass with `config` produced them.
+// AUDX_MEMORY_PREFAULT is kept, since the silent frames it processes at
+// create are part of the full pass's history; AUDX_MEMORY_LOCK does not
+// apply. Returns 0, or -1 if the range is outside the input or the session
+// cannot be created.
+int audx_offline_reprocess(const AudxSessionConfig *config,
+                           const short *input, size_t input_samples,
+                           size_t start, size_t count, unsigned int warmup_ms,
+                           short *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_OFFLINE_H
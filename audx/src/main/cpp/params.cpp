@@ -0,0 +1,106 @@
+#include "params.h"
+#include "session.h"
+
+#include <atomic>
+#include <mutex>
+
+// Set in `middle` when it holds a set the reader has not picked up yet
+#define PARAMS_FRESH 4u
+
+struct AudxParamBlock {
+  AudxParams sets[3];
+
+  // Index of the spare set, or'ed with PARAMS_FRESH once published
+  alignas(64) std::atomic<unsigned int> middle;
+
+  // Writer side, under `writers`
+  alignas(64) std::mutex writers;
+  unsigned int back; // set the next update fills
+  AudxParams latest;
+
+  // Reader side
+  alignas(64) unsigned int front; // set the processing thread is using
+};
+
+void audx_params_default(AudxParams *params) {
+  params->strength = 1.0f;
+  params->bypass = 0;
+  params->warm_interval = AUDX_BYPASS_WARM_INTERVAL_DEFAULT;
+  params->agc = 0;
+  params->agc_target_db = AUDX_AGC_TARGET_DB_DEFAULT;
+  params->agc_max_gain_db = AUDX_AGC_MAX_GAIN_DB_DEFAULT;
+}
+
+int audx_params_valid(const AudxParams *params) {
+  // Written so that NaN fails every range check
+  return params && params->strength >= 0.0f && params->strength <= 1.0f &&
+         params->warm_interval >= 0 &&
+         params->warm_interval <= AUDX_BYPASS_WARM_INTERVAL_MAX &&
+         params->agc_target_db >= -60.0f && params->agc_target_db <= 0.0f &&
+         params->agc_max_gain_db >= 0.0f &&
+         params->agc_max_gain_db <= AUDX_AGC_MAX_GAIN_DB_MAX;
+}
+
+AudxParamBlock *audx_param_block_create(const AudxParams *initial) {
+  AudxParams params;
+  if (initial)
+    params = *initial;
+  else
+    audx_params_default(&params);
+  if (!audx_params_valid(&params))
+    return nullptr;
+
+  auto *block = new AudxParamBlock();
+  for (AudxParams &set : block->sets)
+    set = params;
+  block->front = 0;
+  block->middle.store(1, std::memory_order_relaxed);
+  block->back = 2;
+  block->latest = params;
+  return block;
+}
+
+int audx_param_block_update(AudxParamBlock *block, const AudxParams *values,
+                            unsigned int fields) {
+  if (!values)
+    return -1;
+  std::lock_guard<std::mutex> lock(block->writers);
+  AudxParams next = block->latest;
+  if (fields & AUDX_PARAM_STRENGTH)
+    next.strength = values->strength;
+  if (fields & AUDX_PARAM_BYPASS)
+    next.bypass = values->bypass ? 1 : 0;
+  if (fields & AUDX_PARAM_WARM_INTERVAL)
+    next.warm_interval = values->warm_interval;
+  if (fields & AUDX_PARAM_AGC) {
+    next.agc = values->agc ? 1 : 0;
+    next.agc_target_db = values->agc_target_db;
+    next.agc_max_gain_db = values->agc_max_gain_db;
+  }
+  if (!audx_params_valid(&next))
+    return -1;
+
+  block->latest = next;
+  block->sets[block->back] = next;
+  // The release half publishes the set; the acquire half makes the set
+  // handed back safe to overwrite
+  block->back = block->middle.exchange(block->back | PARAMS_FRESH,
+                                       std::memory_order_acq_rel) &
+                ~PARAMS_FRESH;
+  return 0;
+}
+
+void audx_param_block_latest(AudxParamBlock *block, AudxParams *out) {
+  std::lock_guard<std::mutex> lock(block->writers);
+  *out = block->latest;
+}
+
+const AudxParams *audx_param_block_acquire(AudxParamBlock *block) {
+  if (block->middle.load(std::memory_order_relaxed) & PARAMS_FRESH)
+    block->front = block->middle.exchange(block->front,
+                                          std::memory_order_acq_rel) &
+                   ~PARAMS_FRESH;
+  return &block->sets[block->front];
+}
+
+void audx_param_block_destroy(AudxParamBlock *block) { delete block; }
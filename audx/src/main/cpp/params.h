@@ -0,0 +1,76 @@
+#ifndef AUDX_PARAMS_H
+#define AUDX_PARAMS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Runtime parameters --- */
+// Knobs that may change while a stream is running. Control threads publish
+// new values into a parameter block; the processing thread picks up the
+// newest complete set at the next frame boundary. The block is a triple
+// buffer: publishing fills a spare copy and swaps it in with one atomic
+// exchange, and picking up swaps it out again, so the processing thread
+// never waits, retries or sees a half-written set, however often the
+// values change. Control threads serialise among themselves with a mutex
+// the processing thread never touches.
+
+// Output automatic gain control: the speech level (frames with VAD of at
+// least AUDX_AGC_SPEECH_VAD) is tracked and the output gain steered towards
+// agc_target_db, by at most AUDX_AGC_SLEW_DB per frame and never so far
+// that the frame clips
+#define AUDX_AGC_TARGET_DB_DEFAULT -18.0f
+#define AUDX_AGC_MAX_GAIN_DB_DEFAULT 18.0f
+#define AUDX_AGC_MAX_GAIN_DB_MAX 40.0f
+#define AUDX_AGC_SPEECH_VAD 0.5f
+#define AUDX_AGC_SLEW_DB 0.5f
+
+typedef struct AudxParams {
+  float strength;        // 0 passes the input through, 1 full suppression
+  int bypass;            // see audx_session_set_bypass()
+  int warm_interval;     // 0..AUDX_BYPASS_WARM_INTERVAL_MAX (session.h)
+  int agc;               // 1 enables the output AGC
+  float agc_target_db;   // speech level to aim for, dBFS, -60..0
+  float agc_max_gain_db; // largest boost or cut, 0..AUDX_AGC_MAX_GAIN_DB_MAX
+} AudxParams;
+
+// Field masks for partial updates; AGC covers agc and both agc_* values
+#define AUDX_PARAM_STRENGTH 1u
+#define AUDX_PARAM_BYPASS 2u
+#define AUDX_PARAM_WARM_INTERVAL 4u
+#define AUDX_PARAM_AGC 8u
+#define AUDX_PARAM_ALL 15u
+
+// Full strength, not bypassed, warm interval 2, AGC off at its defaults
+void audx_params_default(AudxParams *params);
+
+// 1 when every value is within its range
+int audx_params_valid(const AudxParams *params);
+
+typedef struct AudxParamBlock AudxParamBlock;
+
+// NULL `initial` uses the defaults. Returns NULL for invalid values.
+AudxParamBlock *audx_param_block_create(const AudxParams *initial);
+
+// Control threads: copies the `fields` of `values` over the newest set and
+// publishes the result. Returns -1, publishing nothing, if the result is
+// invalid.
+int audx_param_block_update(AudxParamBlock *block, const AudxParams *values,
+                            unsigned int fields);
+
+// Control threads: the newest published set
+void audx_param_block_latest(AudxParamBlock *block, AudxParams *out);
+
+// The one processing thread: the newest published set, wait-free. The
+// pointer stays valid and unchanged until the next acquire.
+const AudxParams *audx_param_block_acquire(AudxParamBlock *block);
+
+void audx_param_block_destroy(AudxParamBlock *block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_PARAMS_H
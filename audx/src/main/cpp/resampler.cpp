@@ -0,0 +1,941 @@
+#include "audx.h"
+#include "resampler.h"
+#include "scratch.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// Filter parameters per quality level: taps at 1:1, passband edge as a
+// fraction of the lower Nyquist, Kaiser window beta.
+struct QualityParams {
+  int taps;
+  float cutoff;
+  float beta;
+};
+
+static const QualityParams QUALITY_TABLE[AUDX_RESAMPLER_QUALITY_MAX + 1] = {
+    {8, 0.800f, 5.0f},    {16, 0.840f, 6.0f},   {24, 0.870f, 6.5f},
+    {32, 0.890f, 7.0f},   {48, 0.910f, 8.0f},   {64, 0.920f, 8.5f},
+    {80, 0.930f, 9.0f},   {96, 0.940f, 10.0f},  {128, 0.950f, 10.5f},
+    {160, 0.960f, 11.0f}, {256, 0.970f, 12.0f},
+};
+
+// Above this many coefficients the bank is sampled at a fixed oversampling
+// and outputs interpolate between neighbouring phases.
+#define RESAMPLER_DIRECT_TABLE_MAX 65536
+#define RESAMPLER_OVERSAMPLE 128
+#define RESAMPLER_MAX_TAPS 2048
+#define RESAMPLER_CHUNK 1024
+
+// Power-of-two ratios up to 8 run as a cascade of 2:1 halfband stages.
+// Decimating, each block of this many input samples passes through every
+// stage before the next; interpolating, the block is this many outputs.
+#define RESAMPLER_HALFBAND_MAX_STAGES 3
+#define RESAMPLER_HALFBAND_BLOCK 1024
+
+struct AudxResampler {
+  unsigned int in_rate;
+  unsigned int out_rate;
+  int quality;
+
+  unsigned int num; // input step per output, in units of 1/den samples
+  unsigned int den;
+  unsigned int int_advance;
+  unsigned int frac_advance;
+
+  int taps; // multiple of 8
+  int phases;
+  int interpolate; // phases == RESAMPLER_OVERSAMPLE + 1, blend neighbours
+  int deterministic; // dot_product_exact() instead of dot_product()
+  const float *bank; // phases x taps, or the halfband stages one after another
+  int owns_bank;     // 0 when the bank lives in shared tables
+
+  // Persistent history: the input the next output still needs. Processing
+  // happens in a scratch window of window_cap floats that holds this
+  // history followed by new input.
+  float *hist;
+  int hist_cap;
+  int hist_fill;
+  int window_cap;
+  unsigned int pos; // first tap of the next output, relative to hist
+  unsigned int frac;
+
+  // Halfband cascade instead of the polyphase bank when stages > 0. Stage
+  // 0 runs first; its taps count the non-zero coefficients on either side
+  // of the centre (a multiple of 8). All state lives in `hist`.
+  int stages;
+  int stage_taps[RESAMPLER_HALFBAND_MAX_STAGES];
+  unsigned int pending; // decimating: bit s, stage s holds an unpaired input
+  int held;             // interpolating: outputs computed but not returned
+
+  AudxArena *arena; // holds this struct and `hist`, NULL when on the heap
+};
+
+// Window being filtered during one process call
+struct Window {
+  float *mem;
+  int cap;
+  int fill;
+};
+
+static unsigned int gcd(unsigned int a, unsigned int b) {
+  while (b) {
+    unsigned int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// Zeroth order modified Bessel function of the first kind
+static double bessel_i0(double x) {
+  double sum = 1.0, term = 1.0;
+  const double q = x * x / 4.0;
+  for (int k = 1; k < 64; k++) {
+    term *= q / ((double)k * k);
+    sum += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+// Windowed sinc evaluated at `x` taps from the filter centre
+static float kaiser_sinc(double cutoff, double x, int taps, double beta) {
+  const double half = taps / 2.0;
+  if (fabs(x) >= half)
+    return 0.0f;
+  const double r = x / half;
+  const double window = bessel_i0(beta * sqrt(1.0 - r * r)) / bessel_i0(beta);
+  if (fabs(x) < 1e-9)
+    return (float)(cutoff * window);
+  const double arg = M_PI * cutoff * x;
+  return (float)(cutoff * sin(arg) / arg * window);
+}
+
+// Every dot product sums taps i and i + 8k in lane i % 8 (two vectors of
+// four), then reduces the lanes as ((0+4) + (2+6)) + ((1+5) + (3+7)). That
+// order is fixed on every target; only fused multiply-adds can make the fast
+// variant round differently. dot_product_exact() never fuses, so its result
+// is bit-identical across instruction sets.
+#ifdef HAS_X86_SIMD
+static inline float dot_product(const float *a, const float *b, int count) {
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (int i = 0; i < count; i += 8) {
+    acc0 = _mm_add_ps(acc0,
+                      _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(
+        acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  __m128 acc = _mm_add_ps(acc0, acc1);
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 0x55));
+  return _mm_cvtss_f32(acc);
+}
+
+// SSE4.1 has no FMA, so the fast kernel already rounds every step
+static inline float dot_product_exact(const float *a, const float *b,
+                                      int count) {
+  return dot_product(a, b, count);
+}
+#elif defined(HAS_ARM_NEON)
+static inline float neon_reduce(float32x4_t acc0, float32x4_t acc1) {
+  const float32x4_t acc = vaddq_f32(acc0, acc1);
+  const float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+  return vget_lane_f32(vpadd_f32(sum, sum), 0);
+}
+
+static inline float dot_product(const float *a, const float *b, int count) {
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (int i = 0; i < count; i += 8) {
+    acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  return neon_reduce(acc0, acc1);
+}
+
+static inline float dot_product_exact(const float *a, const float *b,
+                                      int count) {
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (int i = 0; i < count; i += 8) {
+    acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    acc1 = vaddq_f32(acc1,
+                     vmulq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+  }
+  return neon_reduce(acc0, acc1);
+}
+#else
+static inline float dot_product(const float *a, const float *b, int count) {
+  float lane[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  for (int i = 0; i < count; i += 8) {
+    for (int j = 0; j < 8; j++)
+      lane[j] += a[i + j] * b[i + j];
+  }
+  return ((lane[0] + lane[4]) + (lane[2] + lane[6])) +
+         ((lane[1] + lane[5]) + (lane[3] + lane[7]));
+}
+
+static inline float dot_product_exact(const float *a, const float *b,
+                                      int count) {
+  return dot_product(a, b, count);
+}
+#endif
+
+// Clamps and rounds to nearest like pcm_float_to_int16(), one sample at a
+// time so outputs can be stored as they are computed
+static inline short saturate_int16(float v) {
+  v = v > PCM_SCALE_FLOAT_MAX ? PCM_SCALE_FLOAT_MAX : v;
+  v = v < PCM_SCALE_FLOAT_MIN ? PCM_SCALE_FLOAT_MIN : v;
+#ifdef HAS_X86_SIMD
+  return (short)_mm_cvtss_si32(_mm_set_ss(v));
+#elif defined(HAS_ARM_NEON)
+  return (short)vcvtns_s32_f32(v);
+#else
+  return (short)lrintf(v);
+#endif
+}
+
+// Taps needed for a Kaiser-windowed sinc with the given beta to fall from
+// passband to stopband across `width`, in units of the lower Nyquist
+static int kaiser_taps(double beta, double width) {
+  const double attenuation = beta / 0.1102 + 8.7;
+  return (int)ceil((attenuation - 8.0) / (2.285 * M_PI * width));
+}
+
+// Chooses taps, phases and the cutoff of the filter bank
+static double plan_bank(AudxResampler *r, unsigned int bandwidth) {
+  const QualityParams &q = QUALITY_TABLE[r->quality];
+  double cutoff = q.cutoff;
+  int taps = q.taps;
+
+  // Band-limited input: centre the transition on the lower Nyquist and
+  // let it span [bandwidth, lower rate - bandwidth]
+  const unsigned int low_rate = r->in_rate < r->out_rate ? r->in_rate
+                                                         : r->out_rate;
+  const double band = 2.0 * bandwidth / low_rate;
+  if (bandwidth > 0 && band < 1.0) {
+    const int band_taps = kaiser_taps(q.beta, 2.0 * (1.0 - band));
+    if (band_taps < taps) {
+      taps = band_taps < 8 ? 8 : band_taps;
+      cutoff = 1.0;
+    }
+  }
+
+  // Downsampling: move the cutoff below the output Nyquist and stretch
+  // the filter to keep the same transition steepness
+  if (r->num > r->den) {
+    cutoff = cutoff * r->den / r->num;
+    taps = (int)ceil((double)taps * r->num / r->den);
+  }
+  taps = (taps + 7) & ~7;
+  if (taps > RESAMPLER_MAX_TAPS)
+    taps = RESAMPLER_MAX_TAPS;
+
+  r->taps = taps;
+  if ((long)r->den * taps <= RESAMPLER_DIRECT_TABLE_MAX) {
+    r->phases = (int)r->den;
+    r->interpolate = 0;
+  } else {
+    r->phases = RESAMPLER_OVERSAMPLE + 1;
+    r->interpolate = 1;
+  }
+  return cutoff;
+}
+
+// Number of 2:1 stages between the rates, 0 unless one is a power-of-two
+// multiple of the other
+static int halfband_stages(unsigned int in_rate, unsigned int out_rate) {
+  const unsigned int high = in_rate > out_rate ? in_rate : out_rate;
+  const unsigned int low = in_rate > out_rate ? out_rate : in_rate;
+  if (high == low || high % low != 0)
+    return 0;
+  const unsigned int ratio = high / low;
+  if (ratio & (ratio - 1))
+    return 0;
+  int stages = 0;
+  while ((1u << stages) < ratio)
+    stages++;
+  return stages <= RESAMPLER_HALFBAND_MAX_STAGES ? stages : 0;
+}
+
+// A halfband filter is symmetric about a quarter of its rate: it passes
+// [0, edge] and rejects from (half its rate - edge) up, and every other
+// coefficient is zero. The stage next to the lower rate keeps the passband
+// and stopband attenuation of the polyphase filter at the same quality;
+// only the band between the passband edge and the lower Nyquist, where the
+// polyphase filter rolls off, may alias into itself. Stages further out
+// only have to keep that band and reject what would fold into it, so they
+// need only a few taps. Band-limited input moves the edge to `bandwidth`.
+static void plan_halfband(AudxResampler *r, unsigned int bandwidth) {
+  const QualityParams &q = QUALITY_TABLE[r->quality];
+  const unsigned int low_rate = r->in_rate < r->out_rate ? r->in_rate
+                                                         : r->out_rate;
+  // The polyphase transition is centred on the cutoff
+  const double attenuation = q.beta / 0.1102 + 8.7;
+  double edge = q.cutoff - (attenuation - 8.0) / (2.285 * M_PI * q.taps) / 2.0;
+  const double band = 2.0 * bandwidth / low_rate;
+  if (bandwidth > 0 && band < edge)
+    edge = band;
+
+  for (int s = 0; s < r->stages; s++) {
+    // Distance from the lower rate: 0 is the stage that needs the sharp
+    // filter, which runs last when decimating and first when interpolating
+    const int level = r->in_rate > r->out_rate ? r->stages - 1 - s : s;
+    const double width = 1.0 - edge / (double)(1 << level);
+    int taps = (kaiser_taps(q.beta, width) + 2) / 2;
+    taps = (taps + 7) & ~7;
+    if (taps > RESAMPLER_MAX_TAPS / 2)
+      taps = RESAMPLER_MAX_TAPS / 2;
+    r->stage_taps[s] = taps;
+  }
+}
+
+// Non-zero side coefficients of each stage, normalised for unity gain at
+// DC (twice that when interpolating, to make up for the inserted zeros)
+static void fill_halfband(const AudxResampler *r, float *bank) {
+  const QualityParams &q = QUALITY_TABLE[r->quality];
+  const double gain = r->in_rate > r->out_rate ? 1.0 : 2.0;
+  for (int s = 0; s < r->stages; s++) {
+    const int taps = r->stage_taps[s];
+    double sum = 0.0;
+    for (int i = 0; i < taps; i++) {
+      bank[i] = kaiser_sinc(0.5, 2 * i - (taps - 1), 2 * taps, q.beta);
+      sum += bank[i];
+    }
+    for (int i = 0; i < taps; i++)
+      bank[i] = (float)(bank[i] * 0.5 * gain / sum);
+    bank += taps;
+  }
+}
+
+static size_t bank_floats(const AudxResampler *r) {
+  if (!r->stages)
+    return (size_t)r->phases * r->taps;
+  size_t floats = 0;
+  for (int s = 0; s < r->stages; s++)
+    floats += r->stage_taps[s];
+  return floats;
+}
+
+static double plan(AudxResampler *r, unsigned int bandwidth, int polyphase) {
+  r->stages = polyphase ? 0 : halfband_stages(r->in_rate, r->out_rate);
+  if (!r->stages)
+    return plan_bank(r, bandwidth);
+  plan_halfband(r, bandwidth);
+  return 0.0;
+}
+
+static void fill_bank(const AudxResampler *r, double cutoff, float *bank) {
+  if (r->stages) {
+    fill_halfband(r, bank);
+    return;
+  }
+
+  const QualityParams &q = QUALITY_TABLE[r->quality];
+  const double step = r->interpolate ? 1.0 / RESAMPLER_OVERSAMPLE
+                                     : 1.0 / (double)r->den;
+  for (int p = 0; p < r->phases; p++) {
+    for (int j = 0; j < r->taps; j++) {
+      const double x = (double)(j - r->taps / 2 + 1) - p * step;
+      bank[p * r->taps + j] = kaiser_sinc(cutoff, x, r->taps, q.beta);
+    }
+  }
+}
+
+static int valid_config(unsigned int in_rate, unsigned int out_rate,
+                        int quality) {
+  return in_rate != 0 && out_rate != 0 &&
+         quality >= AUDX_RESAMPLER_QUALITY_MIN &&
+         quality <= AUDX_RESAMPLER_QUALITY_MAX;
+}
+
+static void init_rates(AudxResampler *r, unsigned int in_rate,
+                       unsigned int out_rate, int quality) {
+  const unsigned int g = gcd(in_rate, out_rate);
+  r->in_rate = in_rate;
+  r->out_rate = out_rate;
+  r->quality = quality;
+  r->num = in_rate / g;
+  r->den = out_rate / g;
+  r->int_advance = r->num / r->den;
+  r->frac_advance = r->num % r->den;
+}
+
+size_t audx_resampler_bank(unsigned int in_rate, unsigned int out_rate,
+                           int quality, unsigned int bandwidth, float *bank) {
+  if (!valid_config(in_rate, out_rate, quality))
+    return 0;
+  AudxResampler r;
+  memset(&r, 0, sizeof(r));
+  init_rates(&r, in_rate, out_rate, quality);
+  const double cutoff = plan(&r, bandwidth, 0);
+  if (bank)
+    fill_bank(&r, cutoff, bank);
+  return bank_floats(&r);
+}
+
+AudxResampler *audx_resampler_create(unsigned int in_rate,
+                                     unsigned int out_rate, int quality) {
+  return audx_resampler_create_band(in_rate, out_rate, quality, 0);
+}
+
+AudxResampler *audx_resampler_create_band(unsigned int in_rate,
+                                          unsigned int out_rate, int quality,
+                                          unsigned int bandwidth) {
+  return audx_resampler_create_shared(in_rate, out_rate, quality, bandwidth,
+                                      nullptr);
+}
+
+AudxResampler *audx_resampler_create_shared(unsigned int in_rate,
+                                            unsigned int out_rate,
+                                            int quality,
+                                            unsigned int bandwidth,
+                                            const float *bank) {
+  return audx_resampler_create_in(in_rate, out_rate, quality, bandwidth, bank,
+                                  nullptr, 0);
+}
+
+// Zeroed per-stream state, line-padded either way
+static void *state_alloc(AudxArena *arena, int owner, size_t bytes) {
+  return arena ? audx_arena_alloc(arena, owner, bytes)
+               : audx_state_calloc(1, bytes);
+}
+
+static size_t halfband_state_floats(const AudxResampler *r);
+static size_t halfband_scratch_floats(const AudxResampler *r);
+
+static AudxResampler *create(unsigned int in_rate, unsigned int out_rate,
+                             int quality, unsigned int bandwidth,
+                             const float *bank, AudxArena *arena, int owner,
+                             int polyphase) {
+  if (!valid_config(in_rate, out_rate, quality))
+    return nullptr;
+
+  auto *r = (AudxResampler *)state_alloc(arena, owner, sizeof(AudxResampler));
+  if (!r)
+    return nullptr;
+  r->arena = arena;
+
+  init_rates(r, in_rate, out_rate, quality);
+  const double cutoff = plan(r, bandwidth, polyphase);
+  if (bank) {
+    r->bank = bank;
+  } else {
+    float *own = (float *)malloc(sizeof(float) * bank_floats(r));
+    if (!own) {
+      audx_resampler_destroy(r);
+      return nullptr;
+    }
+    fill_bank(r, cutoff, own);
+    r->bank = own;
+    r->owns_bank = 1;
+  }
+
+  if (r->stages) {
+    r->window_cap = (int)halfband_scratch_floats(r);
+    r->hist_cap = (int)halfband_state_floats(r);
+  } else {
+    // The chunk must hold more than one output step so a full window
+    // always yields at least one output
+    int chunk = RESAMPLER_CHUNK;
+    if ((unsigned int)chunk < 2 * (r->int_advance + 1))
+      chunk = (int)(2 * (r->int_advance + 1));
+    r->window_cap = r->taps - 1 + chunk;
+
+    // Input is only pulled into the window as far as the requested outputs
+    // need, so at most one filter span plus one step is left over
+    r->hist_cap = 2 * r->taps + (int)r->int_advance + 2;
+  }
+  r->hist = (float *)state_alloc(arena, owner, sizeof(float) * r->hist_cap);
+  if (!r->hist) {
+    audx_resampler_destroy(r);
+    return nullptr;
+  }
+
+  audx_resampler_reset(r);
+  return r;
+}
+
+AudxResampler *audx_resampler_create_in(unsigned int in_rate,
+                                        unsigned int out_rate, int quality,
+                                        unsigned int bandwidth,
+                                        const float *bank, AudxArena *arena,
+                                        int owner) {
+  return create(in_rate, out_rate, quality, bandwidth, bank, arena, owner, 0);
+}
+
+AudxResampler *audx_resampler_create_polyphase(unsigned int in_rate,
+                                               unsigned int out_rate,
+                                               int quality,
+                                               unsigned int bandwidth) {
+  return create(in_rate, out_rate, quality, bandwidth, nullptr, nullptr, 0, 1);
+}
+
+static inline float filter_phase(const AudxResampler *r, const float *x,
+                                 int phase) {
+  const float *coeffs = r->bank + phase * r->taps;
+  return r->deterministic ? dot_product_exact(x, coeffs, r->taps)
+                          : dot_product(x, coeffs, r->taps);
+}
+
+static inline float filter_one(const AudxResampler *r, const float *x) {
+  if (!r->interpolate)
+    return filter_phase(r, x, (int)r->frac);
+
+  // Blend the two oversampled phases around the exact position
+  const double pos = (double)r->frac * RESAMPLER_OVERSAMPLE / r->den;
+  const int p = (int)pos;
+  const float t = (float)(pos - p);
+  const float a = filter_phase(r, x, p);
+  const float b = filter_phase(r, x, p + 1);
+  return a + (b - a) * t;
+}
+
+static inline void step(AudxResampler *r) {
+  r->pos += r->int_advance;
+  r->frac += r->frac_advance;
+  if (r->frac >= r->den) {
+    r->frac -= r->den;
+    r->pos++;
+  }
+}
+
+// Drops consumed input so the next output's first tap is mem[0]
+static void compact(AudxResampler *r, Window *w) {
+  const unsigned int drop =
+      r->pos < (unsigned int)w->fill ? r->pos : (unsigned int)w->fill;
+  if (drop == 0)
+    return;
+  memmove(w->mem, w->mem + drop, sizeof(float) * (w->fill - drop));
+  w->fill -= drop;
+  r->pos -= drop;
+}
+
+// Window fill needed to emit `outputs` more samples
+static unsigned long long needed_fill(const AudxResampler *r,
+                                      unsigned int outputs) {
+  const unsigned long long num =
+      (unsigned long long)r->int_advance * r->den + r->frac_advance;
+  return r->pos + (r->frac + (outputs - 1) * num) / r->den + r->taps;
+}
+
+/* --- Halfband cascade --- */
+// A 2:1 halfband filter has a centre tap of 1/2 and zeros at every other
+// offset, so only the taps on the odd offsets are stored and multiplied.
+// Decimating, output m takes the centre from the even input samples and
+// the taps from the odd ones; the two phases are split into separate
+// windows so each output is one contiguous dot product. Interpolating,
+// every input yields an output that is the input itself (the centre tap)
+// and one that is a dot product over the inputs (the zeros inserted in
+// between are skipped).
+
+static bool halfband_down(const AudxResampler *r) {
+  return r->in_rate > r->out_rate;
+}
+
+// Persistent floats per stage: decimating, the odd and even phase
+// histories and the unpaired input; interpolating, the input history. The
+// interpolator keeps up to ratio - 1 outputs it could not return at the end.
+static size_t halfband_stage_state(const AudxResampler *r, int s) {
+  const int taps = r->stage_taps[s];
+  return halfband_down(r) ? (size_t)(taps - 1) + (taps / 2 - 1) + 1
+                          : (size_t)(taps - 1);
+}
+
+static size_t halfband_state_floats(const AudxResampler *r) {
+  size_t floats = halfband_down(r) ? 0 : ((size_t)1 << r->stages) - 1;
+  for (int s = 0; s < r->stages; s++)
+    floats += halfband_stage_state(r, s);
+  return floats;
+}
+
+// Workspace for one block: the converted input, then per stage its
+// window(s) and output
+struct HalfbandBuffers {
+  float *in;
+  float *window[RESAMPLER_HALFBAND_MAX_STAGES];
+  float *out[RESAMPLER_HALFBAND_MAX_STAGES];
+};
+
+static unsigned int halfband_block(const AudxResampler *r) {
+  return halfband_down(r) ? RESAMPLER_HALFBAND_BLOCK
+                          : RESAMPLER_HALFBAND_BLOCK >> r->stages;
+}
+
+// Lays the buffers out from `mem` (sizes only when NULL); returns floats
+static size_t halfband_buffers(const AudxResampler *r, float *mem,
+                               HalfbandBuffers *b) {
+  size_t used = halfband_block(r);
+  if (mem)
+    b->in = mem;
+  size_t inputs = used; // most a stage can be given in one block
+  for (int s = 0; s < r->stages; s++) {
+    const size_t taps = r->stage_taps[s];
+    size_t window, outputs;
+    if (halfband_down(r)) {
+      outputs = inputs / 2 + 1;
+      window = (taps - 1) + (taps / 2 - 1) + 2 * outputs;
+    } else {
+      outputs = 2 * inputs;
+      window = (taps - 1) + inputs;
+    }
+    if (mem) {
+      b->window[s] = mem + used;
+      b->out[s] = mem + used + window;
+    }
+    used += window + outputs;
+    inputs = outputs;
+  }
+  return used;
+}
+
+static size_t halfband_scratch_floats(const AudxResampler *r) {
+  return halfband_buffers(r, nullptr, nullptr);
+}
+
+static const float *stage_coeffs(const AudxResampler *r, int s) {
+  const float *coeffs = r->bank;
+  for (int i = 0; i < s; i++)
+    coeffs += r->stage_taps[i];
+  return coeffs;
+}
+
+static float *stage_state(AudxResampler *r, int s) {
+  float *state = r->hist;
+  for (int i = 0; i < s; i++)
+    state += halfband_stage_state(r, i);
+  return state;
+}
+
+static inline float filter_taps(const AudxResampler *r, const float *x,
+                                const float *coeffs, int taps) {
+  return r->deterministic ? dot_product_exact(x, coeffs, taps)
+                          : dot_product(x, coeffs, taps);
+}
+
+// Halves `n` samples of stage `s`; returns the outputs written
+static int halfband_decimate(AudxResampler *r, int s, float *window,
+                             const float *in, int n, float *out) {
+  const int taps = r->stage_taps[s];
+  const float *coeffs = stage_coeffs(r, s);
+  float *state = stage_state(r, s);
+  float *pending = state + (taps - 1) + (taps / 2 - 1);
+  const unsigned int bit = 1u << s;
+
+  // Output m: 1/2 x[2m - taps + 2] plus odd inputs x[2m - 2taps + 3 .. 2m + 1]
+  float *odd = window;
+  float *even = window + (taps - 1) + (n / 2 + 1);
+  memcpy(odd, state, sizeof(float) * (taps - 1));
+  memcpy(even, state + taps - 1, sizeof(float) * (taps / 2 - 1));
+  int fill = 0, i = 0;
+  if ((r->pending & bit) && n > 0) {
+    even[taps / 2 - 1] = *pending;
+    odd[taps - 1] = in[0];
+    fill = 1;
+    i = 1;
+    r->pending &= ~bit;
+  }
+  for (; i + 1 < n; i += 2, fill++) {
+    even[taps / 2 - 1 + fill] = in[i];
+    odd[taps - 1 + fill] = in[i + 1];
+  }
+  if (i < n) {
+    *pending = in[i];
+    r->pending |= bit;
+  }
+
+  for (int m = 0; m < fill; m++)
+    out[m] = 0.5f * even[m] + filter_taps(r, odd + m, coeffs, taps);
+
+  memcpy(state, odd + fill, sizeof(float) * (taps - 1));
+  memcpy(state + taps - 1, even + fill, sizeof(float) * (taps / 2 - 1));
+  return fill;
+}
+
+// Doubles `n` samples of stage `s`; returns the outputs written
+static int halfband_interpolate(AudxResampler *r, int s, float *window,
+                                const float *in, int n, float *out) {
+  const int taps = r->stage_taps[s];
+  const float *coeffs = stage_coeffs(r, s);
+  float *state = stage_state(r, s);
+
+  // Input x[k] yields x[k - taps / 2] and the point halfway to the next
+  memcpy(window, state, sizeof(float) * (taps - 1));
+  memcpy(window + taps - 1, in, sizeof(float) * n);
+  for (int k = 0; k < n; k++) {
+    out[2 * k] = window[k + taps / 2 - 1];
+    out[2 * k + 1] = filter_taps(r, window + k, coeffs, taps);
+  }
+  memcpy(state, window + n, sizeof(float) * (taps - 1));
+  return 2 * n;
+}
+
+// Input the cascade needs for `outputs` more outputs; decimating, every
+// ratio inputs make one output, counting the unpaired inputs stages hold
+static unsigned int halfband_input_needed(const AudxResampler *r,
+                                          unsigned int outputs) {
+  if (outputs == 0)
+    return 0;
+  const unsigned int ratio = 1u << r->stages;
+  if (halfband_down(r)) {
+    unsigned int phase = 0;
+    for (int s = 0; s < r->stages; s++)
+      if (r->pending & (1u << s))
+        phase += 1u << s;
+    return outputs * ratio - phase;
+  }
+  if (outputs <= (unsigned int)r->held)
+    return 0;
+  return (outputs - r->held + ratio - 1) / ratio;
+}
+
+template <typename Out> static inline void store(Out *out, float v) {
+  if constexpr (sizeof(Out) == sizeof(short))
+    *out = saturate_int16(v);
+  else
+    *out = v;
+}
+
+template <typename In, typename Out>
+static int process_halfband(AudxResampler *r, AudxScratch *scratch,
+                            const In *in, unsigned int *in_len, Out *out,
+                            unsigned int *out_len) {
+  float *mem = (float *)audx_scratch_get(scratch, AUDX_SCRATCH_RESAMPLER,
+                                         sizeof(float) * r->window_cap);
+  if (!mem)
+    return -1;
+  HalfbandBuffers b;
+  halfband_buffers(r, mem, &b);
+
+  const unsigned int out_total = *out_len;
+  unsigned int out_used = 0;
+  float *held = r->hist + r->hist_cap - ((1 << r->stages) - 1);
+  if (!halfband_down(r)) {
+    int taken = 0;
+    while (out_used < out_total && taken < r->held)
+      store(&out[out_used++], held[taken++]);
+    memmove(held, held + taken, sizeof(float) * (r->held - taken));
+    r->held -= taken;
+  }
+
+  unsigned int in_total = halfband_input_needed(r, out_total - out_used);
+  if (in_total > *in_len)
+    in_total = *in_len;
+
+  const unsigned int block = halfband_block(r);
+  unsigned int in_used = 0;
+  while (in_used < in_total) {
+    const int n = (int)(in_total - in_used < block ? in_total - in_used
+                                                   : block);
+    if constexpr (sizeof(In) == sizeof(short))
+      pcm_int16_to_float((const short *)in + in_used, b.in, n);
+    else
+      memcpy(b.in, in + in_used, sizeof(float) * n);
+    in_used += n;
+
+    const float *cur = b.in;
+    int len = n;
+    for (int s = 0; s < r->stages; s++) {
+      len = halfband_down(r)
+                ? halfband_decimate(r, s, b.window[s], cur, len, b.out[s])
+                : halfband_interpolate(r, s, b.window[s], cur, len, b.out[s]);
+      cur = b.out[s];
+    }
+    for (int i = 0; i < len; i++) {
+      if (out_used < out_total)
+        store(&out[out_used++], cur[i]);
+      else
+        held[r->held++] = cur[i];
+    }
+  }
+
+  *in_len = in_used;
+  *out_len = out_used;
+  return 0;
+}
+
+/* --- Processing --- */
+
+template <typename In, typename Out>
+static int process(AudxResampler *r, AudxScratch *scratch, const In *in,
+                   unsigned int *in_len, Out *out, unsigned int *out_len) {
+  if (!r || !scratch || !in_len || !out_len || (*in_len && !in) ||
+      (*out_len && !out))
+    return -1;
+  if (r->stages)
+    return process_halfband(r, scratch, in, in_len, out, out_len);
+
+  Window w;
+  w.cap = r->window_cap;
+  w.mem = (float *)audx_scratch_get(scratch, AUDX_SCRATCH_RESAMPLER,
+                                    sizeof(float) * w.cap);
+  if (!w.mem)
+    return -1;
+  memcpy(w.mem, r->hist, sizeof(float) * r->hist_fill);
+  w.fill = r->hist_fill;
+
+  unsigned int in_used = 0, out_used = 0;
+  const unsigned int in_total = *in_len, out_total = *out_len;
+
+  for (;;) {
+    // Emit everything the buffered input allows
+    while (out_used < out_total &&
+           r->pos + (unsigned int)r->taps <= (unsigned int)w.fill) {
+      store(&out[out_used++], filter_one(r, w.mem + r->pos));
+      step(r);
+    }
+    compact(r, &w);
+
+    if (out_used == out_total || in_used == in_total)
+      break;
+
+    unsigned long long count = in_total - in_used;
+    const unsigned long long space = (unsigned long long)(w.cap - w.fill);
+    const unsigned long long wanted =
+        needed_fill(r, out_total - out_used) - (unsigned long long)w.fill;
+    if (count > space)
+      count = space;
+    if (count > wanted)
+      count = wanted;
+    float *dst = w.mem + w.fill;
+    if constexpr (sizeof(In) == sizeof(short))
+      pcm_int16_to_float((const short *)in + in_used, dst, (int)count);
+    else
+      memcpy(dst, in + in_used, sizeof(float) * count);
+    w.fill += (int)count;
+    in_used += (unsigned int)count;
+  }
+
+  memcpy(r->hist, w.mem, sizeof(float) * w.fill);
+  r->hist_fill = w.fill;
+
+  *in_len = in_used;
+  *out_len = out_used;
+  return 0;
+}
+
+int audx_resampler_process_float(AudxResampler *r, const float *in,
+                                 unsigned int *in_len, float *out,
+                                 unsigned int *out_len) {
+  return process(r, audx_scratch_thread_local(), in, in_len, out, out_len);
+}
+
+int audx_resampler_process_int(AudxResampler *r, const short *in,
+                               unsigned int *in_len, short *out,
+                               unsigned int *out_len) {
+  return process(r, audx_scratch_thread_local(), in, in_len, out, out_len);
+}
+
+int audx_resampler_process_float_ws(AudxResampler *r, AudxScratch *scratch,
+                                    const float *in, unsigned int *in_len,
+                                    float *out, unsigned int *out_len) {
+  return process(r, scratch, in, in_len, out, out_len);
+}
+
+int audx_resampler_process_int_ws(AudxResampler *r, AudxScratch *scratch,
+                                  const short *in, unsigned int *in_len,
+                                  short *out, unsigned int *out_len) {
+  return process(r, scratch, in, in_len, out, out_len);
+}
+
+int audx_resampler_process_int_float_ws(AudxResampler *r, AudxScratch *scratch,
+                                        const short *in, unsigned int *in_len,
+                                        float *out, unsigned int *out_len) {
+  return process(r, scratch, in, in_len, out, out_len);
+}
+
+int audx_resampler_process_float_int_ws(AudxResampler *r, AudxScratch *scratch,
+                                        const float *in, unsigned int *in_len,
+                                        short *out, unsigned int *out_len) {
+  return process(r, scratch, in, in_len, out, out_len);
+}
+
+size_t audx_resampler_scratch_bytes(const AudxResampler *r) {
+  return sizeof(float) * r->window_cap;
+}
+
+void audx_resampler_memory(const AudxResampler *r, AudxMemRangeFn fn,
+                           void *ctx) {
+  fn(r, sizeof(AudxResampler), 1, ctx);
+  fn(r->hist, sizeof(float) * r->hist_cap, 1, ctx);
+  fn(r->bank, sizeof(float) * bank_floats(r), 0, ctx);
+}
+
+size_t audx_resampler_state_bytes(const AudxResampler *r) {
+  return sizeof(AudxResampler) + sizeof(float) * r->hist_cap +
+         (r->owns_bank ? sizeof(float) * bank_floats(r) : 0);
+}
+
+unsigned int audx_resampler_max_output(const AudxResampler *r,
+                                       unsigned int in_len) {
+  if (r->stages) {
+    const unsigned int ratio = 1u << r->stages;
+    if (!halfband_down(r))
+      return in_len * ratio + r->held;
+    return (in_len + ratio - halfband_input_needed(r, 1)) / ratio;
+  }
+  return (unsigned int)(((unsigned long long)in_len * r->den + r->num - 1) /
+                        r->num) +
+         1;
+}
+
+// Output k is the filter centred taps / 2 - 1 samples into a window that
+// starts taps - 1 samples of silence before the input, so it lands on
+// input position k * in_rate / out_rate - taps / 2
+//
+// A decimating halfband stage centres output m on its input 2m - taps + 2,
+// an interpolating one emits input k - taps / 2 when given input k; each
+// stage's delay counts in the input samples of the cascade
+int audx_resampler_input_latency(const AudxResampler *r) {
+  if (!r->stages)
+    return r->taps / 2;
+  int latency = 0;
+  for (int s = 0; s < r->stages; s++) {
+    latency += halfband_down(r) ? (r->stage_taps[s] - 2) << s
+                                : (r->stage_taps[s] / 2) >> s;
+  }
+  return latency;
+}
+
+unsigned int audx_resampler_input_needed(const AudxResampler *r,
+                                         unsigned int outputs) {
+  if (r->stages)
+    return halfband_input_needed(r, outputs);
+  if (outputs == 0)
+    return 0;
+  const unsigned long long fill = needed_fill(r, outputs);
+  return fill > (unsigned long long)r->hist_fill
+             ? (unsigned int)(fill - (unsigned long long)r->hist_fill)
+             : 0;
+}
+
+void audx_resampler_set_deterministic(AudxResampler *r, int enabled) {
+  r->deterministic = enabled != 0;
+}
+
+void audx_resampler_reset(AudxResampler *r) {
+  // Start with taps - 1 samples of silence so the first output is centred
+  // on the first input sample after the filter delay
+  memset(r->hist, 0, sizeof(float) * r->hist_cap);
+  r->hist_fill = r->stages ? r->hist_cap : r->taps - 1;
+  r->pos = 0;
+  r->frac = 0;
+  r->pending = 0;
+  r->held = 0;
+}
+
+void audx_resampler_destroy(AudxResampler *r) {
+  if (!r)
+    return;
+  if (r->owns_bank)
+    free((void *)r->bank);
+  if (!r->arena) {
+    free(r->hist);
+    free(r);
+  }
+}
@@ -0,0 +1,149 @@
+#ifndef AUDX_RESAMPLER_H
+#define AUDX_RESAMPLER_H
+
+#include "arena.h"
+#include "memlock.h"
+#include "scratch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Resampler --- */
+// Streaming polyphase windowed-sinc resampler for arbitrary rational rates.
+// Quality levels match audx_create(): 0 is fastest, 10 is best.
+//
+// Rates 2, 4 or 8 times apart (e.g. 96 or 192 kHz against 48 kHz) use a
+// cascade of 2:1 halfband stages instead: half the coefficients of a
+// halfband filter are zero and are skipped, and only the stage next to the
+// lower rate needs a sharp filter. Same passband edge and stopband
+// attenuation per quality as the polyphase filter, at a fraction of the
+// cost.
+
+#define AUDX_RESAMPLER_QUALITY_MIN 0
+#define AUDX_RESAMPLER_QUALITY_MAX 10
+#define AUDX_RESAMPLER_QUALITY_DEFAULT 4
+#define AUDX_RESAMPLER_QUALITY_VOIP 3
+
+typedef struct AudxResampler AudxResampler;
+
+AudxResampler *audx_resampler_create(unsigned int in_rate,
+                                     unsigned int out_rate, int quality);
+
+// Band-limited variant for signals with no content above `bandwidth` Hz.
+// The filter only has to keep [0, bandwidth] and reject images from
+// (lower rate - bandwidth) up, which allows far fewer taps. A bandwidth of
+// 0, or one close to the lower Nyquist, gives the full-band filter.
+AudxResampler *audx_resampler_create_band(unsigned int in_rate,
+                                          unsigned int out_rate, int quality,
+                                          unsigned int bandwidth);
+
+// Filter bank used for a configuration, so it can be computed once and
+// shared. Writes it to `bank` unless NULL and returns its size in floats,
+// 0 for an invalid configuration.
+size_t audx_resampler_bank(unsigned int in_rate, unsigned int out_rate,
+                           int quality, unsigned int bandwidth, float *bank);
+
+// Creates a resampler that reads its filter bank from `bank` (as written by
+// audx_resampler_bank() for the same configuration) instead of building a
+// private copy. The bank must outlive the resampler. NULL builds a private
+// bank, like audx_resampler_create_band().
+AudxResampler *audx_resampler_create_shared(unsigned int in_rate,
+                                            unsigned int out_rate,
+                                            int quality,
+                                            unsigned int bandwidth,
+                                            const float *bank);
+
+// audx_resampler_create_shared() with the resampler's per-stream state
+// placed in `owner`'s region of `arena` (NULL uses the heap). A private
+// bank is read-only once built and stays on the heap. Destroy the
+// resampler before the arena.
+AudxResampler *audx_resampler_create_in(unsigned int in_rate,
+                                        unsigned int out_rate, int quality,
+                                        unsigned int bandwidth,
+                                        const float *bank, AudxArena *arena,
+                                        int owner);
+
+// Always uses the polyphase bank, e.g. to compare against the halfband
+// cascade
+AudxResampler *audx_resampler_create_polyphase(unsigned int in_rate,
+                                               unsigned int out_rate,
+                                               int quality,
+                                               unsigned int bandwidth);
+
+// Consumes up to *in_len samples and writes up to *out_len samples; both are
+// updated with the counts actually used. Returns 0 on success, -1 on bad
+// arguments.
+//
+// Input is copied into the resampler's history before any output is
+// written, so `out` may alias `in` when out_rate <= in_rate. When
+// upsampling in place, place the input at the end of a buffer sized for the
+// output.
+int audx_resampler_process_float(AudxResampler *r, const float *in,
+                                 unsigned int *in_len, float *out,
+                                 unsigned int *out_len);
+
+// Same as above with int16 samples; conversion is folded into the copy into
+// history and into the output stage (saturating).
+int audx_resampler_process_int(AudxResampler *r, const short *in,
+                               unsigned int *in_len, short *out,
+                               unsigned int *out_len);
+
+// Variants that work in an explicit workspace instead of the calling
+// thread's one
+int audx_resampler_process_float_ws(AudxResampler *r, AudxScratch *scratch,
+                                    const float *in, unsigned int *in_len,
+                                    float *out, unsigned int *out_len);
+
+int audx_resampler_process_int_ws(AudxResampler *r, AudxScratch *scratch,
+                                  const short *in, unsigned int *in_len,
+                                  short *out, unsigned int *out_len);
+
+// Mixed formats for resampling around a float stage: int16 converted on its
+// way into the resampler's history, or saturated to int16 as each output is
+// computed. Neither needs a separate conversion pass or buffer.
+int audx_resampler_process_int_float_ws(AudxResampler *r, AudxScratch *scratch,
+                                        const short *in, unsigned int *in_len,
+                                        float *out, unsigned int *out_len);
+
+int audx_resampler_process_float_int_ws(AudxResampler *r, AudxScratch *scratch,
+                                        const float *in, unsigned int *in_len,
+                                        short *out, unsigned int *out_len);
+
+// Workspace needed per call, and bytes kept between calls (including a
+// private filter bank)
+size_t audx_resampler_scratch_bytes(const AudxResampler *r);
+
+size_t audx_resampler_state_bytes(const AudxResampler *r);
+
+// Reports each block the resampler touches while processing
+void audx_resampler_memory(const AudxResampler *r, AudxMemRangeFn fn,
+                           void *ctx);
+
+// Upper bound on the samples produced for `in_len` input samples
+unsigned int audx_resampler_max_output(const AudxResampler *r,
+                                       unsigned int in_len);
+
+// Delay introduced by the filter, in input samples
+int audx_resampler_input_latency(const AudxResampler *r);
+
+// Input samples the next call consumes when it is limited to `outputs`
+// output samples and given enough input
+unsigned int audx_resampler_input_needed(const AudxResampler *r,
+                                         unsigned int outputs);
+
+// Computes every output with a fixed summation order and no fused
+// multiply-adds, so the same bank and input give bit-identical output on
+// every instruction set. Free on x86 (SSE4.1 has no FMA); costs the fused
+// multiply-add on NEON. Off by default.
+void audx_resampler_set_deterministic(AudxResampler *r, int enabled);
+
+void audx_resampler_reset(AudxResampler *r);
+
+void audx_resampler_destroy(AudxResampler *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_RESAMPLER_H
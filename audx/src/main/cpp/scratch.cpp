@@ -0,0 +1,99 @@
+#include "scratch.h"
+#include "arena.h"
+#include "memlock.h"
+
+#include <cstdlib>
+
+// Workspaces of different threads must not share lines
+#define SCRATCH_ALIGN AUDX_STATE_ALIGN
+
+struct AudxScratch {
+  void *region[AUDX_SCRATCH_REGIONS];
+  size_t capacity[AUDX_SCRATCH_REGIONS];
+  int locked[AUDX_SCRATCH_REGIONS]; // mlock succeeded for the region
+  int lock_requested;               // lock regions as they grow
+};
+
+static void release_regions(AudxScratch *scratch) {
+  for (int i = 0; i < AUDX_SCRATCH_REGIONS; i++) {
+    if (scratch->locked[i])
+      audx_mem_unlock(scratch->region[i], scratch->capacity[i]);
+    free(scratch->region[i]);
+  }
+}
+
+// All or nothing, so a region is either locked or holds no page locks
+static int lock_region(void *p, size_t size) {
+  if (audx_mem_lock(p, size) == 0)
+    return 1;
+  audx_mem_unlock(p, size);
+  return 0;
+}
+
+AudxScratch *audx_scratch_create(void) {
+  return (AudxScratch *)calloc(1, sizeof(AudxScratch));
+}
+
+namespace {
+// Owns the thread's workspace so it is released when the thread exits
+struct ThreadScratch {
+  AudxScratch scratch = {};
+  ~ThreadScratch() { release_regions(&scratch); }
+};
+} // namespace
+
+AudxScratch *audx_scratch_thread_local(void) {
+  static thread_local ThreadScratch local;
+  return &local.scratch;
+}
+
+void *audx_scratch_get(AudxScratch *scratch, AudxScratchRegion region,
+                       size_t bytes) {
+  if (bytes <= scratch->capacity[region])
+    return scratch->region[region];
+
+  const size_t size = (bytes + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+  void *p = nullptr;
+  if (posix_memalign(&p, SCRATCH_ALIGN, size) != 0)
+    return nullptr;
+
+  if (scratch->locked[region])
+    audx_mem_unlock(scratch->region[region], scratch->capacity[region]);
+  scratch->locked[region] = scratch->lock_requested && lock_region(p, size);
+  free(scratch->region[region]);
+  scratch->region[region] = p;
+  scratch->capacity[region] = size;
+  return p;
+}
+
+size_t audx_scratch_bytes(const AudxScratch *scratch) {
+  size_t total = 0;
+  for (size_t c : scratch->capacity)
+    total += c;
+  return total;
+}
+
+void audx_scratch_prefault(AudxScratch *scratch) {
+  for (int i = 0; i < AUDX_SCRATCH_REGIONS; i++)
+    audx_mem_prefault_write(scratch->region[i], scratch->capacity[i]);
+}
+
+int audx_scratch_lock(AudxScratch *scratch) {
+  scratch->lock_requested = 1;
+  int result = 0;
+  for (int i = 0; i < AUDX_SCRATCH_REGIONS; i++) {
+    if (scratch->locked[i] || !scratch->region[i])
+      continue;
+    scratch->locked[i] = lock_region(scratch->region[i], scratch->capacity[i]);
+    if (!scratch->locked[i])
+      result = -1;
+  }
+  return result;
+}
+
+void audx_scratch_destroy(AudxScratch *scratch) {
+  if (!scratch)
+    return;
+  release_regions(scratch);
+  free(scratch);
+}
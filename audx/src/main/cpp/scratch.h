@@ -0,0 +1,51 @@
+#ifndef AUDX_SCRATCH_H
+#define AUDX_SCRATCH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Scratch workspace --- */
+// Working memory for one frame in flight. Sessions and resamplers keep only
+// their persistent state; everything that is dead between frames lives in a
+// workspace that can be shared by every stream processed on a thread.
+//
+// Calls without an explicit workspace use the calling thread's own.
+
+typedef struct AudxScratch AudxScratch;
+
+// Regions that are live at the same time get separate storage
+typedef enum AudxScratchRegion {
+  AUDX_SCRATCH_RESAMPLER = 0,
+  AUDX_SCRATCH_SESSION,
+  AUDX_SCRATCH_REGIONS
+} AudxScratchRegion;
+
+AudxScratch *audx_scratch_create(void);
+
+AudxScratch *audx_scratch_thread_local(void);
+
+// Returns `bytes` of 64-byte aligned storage for `region`, growing it if
+// needed (contents are not preserved). NULL if allocation fails.
+void *audx_scratch_get(AudxScratch *scratch, AudxScratchRegion region,
+                       size_t bytes);
+
+size_t audx_scratch_bytes(const AudxScratch *scratch);
+
+// Touches every region so the next frame does not fault
+void audx_scratch_prefault(AudxScratch *scratch);
+
+// Locks the regions in memory, including any they grow into later.
+// Returns -1 if mlock was refused for a region; regions that could not be
+// locked are retried on the next call.
+int audx_scratch_lock(AudxScratch *scratch);
+
+void audx_scratch_destroy(AudxScratch *scratch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_SCRATCH_H
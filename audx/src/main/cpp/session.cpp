@@ -0,0 +1,756 @@
+#include "session.h"
+#include "arena.h"
+#include "engine.h"
+#include "resampler.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Padded so sessions processed on different threads never share a line
+struct alignas(AUDX_STATE_ALIGN) AudxSession {
+  AudxState *state;
+  int frame_samples;
+  unsigned int in_rate;
+  int64_t delay_ns; // input to output, see audx_session_delay_ns
+
+  // Set when the session resamples around a FRAME_RATE core itself
+  AudxResampler *up;
+  AudxResampler *down;
+
+  AudxParamBlock *params;
+  float strength;  // applied at the end of the last frame
+  float agc_gain;  // linear, applied at the end of the last frame
+  float agc_level; // smoothed speech level before the AGC, dBFS
+  int agc_active;  // AGC was on for the last frame
+  int bypass_active;
+  int warm_counter;
+  int held_valid; // last bypassed frame was not fed to the core
+  float last_vad;
+
+  short *held; // last bypassed input frame, replayed on re-enable
+
+  // The input delayed by the session's latency, so dry audio lines up with
+  // wet wherever the two are mixed or swapped. A ring of dry_delay samples
+  // following `held` in the same block.
+  short *dry_line;
+  int dry_delay;
+  int dry_pos;
+
+  int memory_status; // AUDX_MEMORY_* in effect
+  // Workspace last reserved (and locked and prefaulted, as the memory flags
+  // ask) for this session; another one is prepared on its first frame
+  const AudxScratch *prepared;
+
+  AudxSpeakerDetector *speaker;
+  int speaker_stream;
+
+  AudxEventRing *events;
+  int events_stream;
+  uint64_t events_frame; // frames processed since the ring was attached
+  int in_speech;
+  int speech_frames; // length of the current segment
+  int quiet_frames;  // frames below AUDX_EVENT_SPEECH_OFF in the segment
+
+  AudxMonitor *monitor;
+  int monitor_slot;
+
+  AudxDtx *dtx;
+
+  AudxArena *arena; // holds this struct and `held`, NULL when on the heap
+};
+
+// Per-frame working buffers, carved from the AUDX_SCRATCH_SESSION region
+struct Frame {
+  short *dry;       // input delayed by the session's latency
+  short *wet;       // core output while fading or warming
+  short *mix;       // core output before mixing with the dry input
+  float *frame_in;  // FRAME_SIZE floats at FRAME_RATE
+  float *frame_out; // FRAME_SIZE floats at FRAME_RATE
+};
+
+static size_t align64(size_t bytes) { return (bytes + 63) & ~(size_t)63; }
+
+static size_t frame_bytes(const AudxSession *session) {
+  size_t bytes = 3 * align64(sizeof(short) * session->frame_samples);
+  if (session->up)
+    bytes += 2 * align64(sizeof(float) * FRAME_SIZE);
+  return bytes;
+}
+
+static int get_frame(const AudxSession *session, AudxScratch *scratch,
+                     Frame *frame) {
+  auto *base = (char *)audx_scratch_get(scratch, AUDX_SCRATCH_SESSION,
+                                        frame_bytes(session));
+  if (!base)
+    return -1;
+
+  frame->dry = (short *)base;
+  base += align64(sizeof(short) * session->frame_samples);
+  frame->wet = (short *)base;
+  base += align64(sizeof(short) * session->frame_samples);
+  frame->mix = (short *)base;
+  base += align64(sizeof(short) * session->frame_samples);
+  if (session->up) {
+    frame->frame_in = (float *)base;
+    base += align64(sizeof(float) * FRAME_SIZE);
+    frame->frame_out = (float *)base;
+  } else {
+    frame->frame_in = nullptr;
+    frame->frame_out = nullptr;
+  }
+  return 0;
+}
+
+// Blends `from` towards `to` by a weight ramping linearly from t0 to t1
+// across one frame. `out` may alias either input since each sample is read
+// before it is written.
+static void blend_int16(const short *from, const short *to, short *out,
+                        int count, float t0, float t1) {
+  const float step = 1.0f / (float)count;
+  for (int i = 0; i < count; i++) {
+    const float t = t0 + (t1 - t0) * ((float)(i + 1) * step);
+    const float a = (float)from[i];
+    out[i] = (short)(a + ((float)to[i] - a) * t);
+  }
+}
+
+// Linear crossfade from `from` to `to` across one frame
+static void crossfade_int16(const short *from, const short *to, short *out,
+                            int count) {
+  blend_int16(from, to, out, count, 0.0f, 1.0f);
+}
+
+void audx_session_config_default(AudxSessionConfig *config) {
+  config->in_rate = FRAME_RATE;
+  config->resample_quality = 4;
+  config->warm_interval = AUDX_BYPASS_WARM_INTERVAL_DEFAULT;
+  config->bandwidth = 0;
+  config->memory_flags = 0;
+  config->tables = nullptr;
+  config->deterministic = 0;
+}
+
+// Reports every block the process path touches outside the core's state
+static void session_memory(const AudxSession *session, AudxMemRangeFn fn,
+                           void *ctx) {
+  fn(session, sizeof(AudxSession), 1, ctx);
+  fn(session->held,
+     sizeof(short) * (session->frame_samples + session->dry_delay), 1, ctx);
+  if (session->up) {
+    audx_resampler_memory(session->up, fn, ctx);
+    audx_resampler_memory(session->down, fn, ctx);
+  }
+  audx_mem_core_segments(fn, ctx);
+}
+
+// Written ranges are write-touched: a read alone would map the zero page of
+// fresh memory and leave a copy-on-write fault for the first frame
+static void prefault_range(const void *addr, size_t len, int writable,
+                           void *) {
+  if (writable)
+    audx_mem_prefault_write(const_cast<void *>(addr), len);
+  else
+    audx_mem_prefault(addr, len);
+}
+
+static void lock_range(const void *addr, size_t len, int, void *ctx) {
+  if (audx_mem_lock(addr, len) != 0)
+    *(int *)ctx = -1;
+}
+
+static void unlock_range(const void *addr, size_t len, int, void *) {
+  audx_mem_unlock(addr, len);
+}
+
+// Not permitted: release what was locked and carry on unlocked
+static void drop_lock(AudxSession *session) {
+  session_memory(session, unlock_range, nullptr);
+  session->memory_status &= ~AUDX_MEMORY_LOCK;
+}
+
+// Readies a workspace the session has not run on yet, typically the first
+// frame on a new processing thread
+static void prepare_scratch(AudxSession *session, AudxScratch *scratch) {
+  session->prepared = scratch;
+  audx_session_scratch_reserve(session, scratch);
+  if ((session->memory_status & AUDX_MEMORY_LOCK) &&
+      audx_scratch_lock(scratch) != 0)
+    drop_lock(session);
+  if (session->memory_status & AUDX_MEMORY_PREFAULT)
+    audx_scratch_prefault(scratch);
+}
+
+// The wrapper resamples around a FRAME_RATE core itself, with the int16
+// conversions folded into its resamplers, whenever it can deliver exactly
+// FRAME_SIZE samples per 10ms frame, i.e. for rates that are a multiple of
+// 100 Hz. Other rates use the core's own resampling.
+static int use_session_resampler(const AudxSessionConfig *config) {
+  return config->in_rate != FRAME_RATE && config->in_rate % 100 == 0;
+}
+
+// The core's overlap-add synthesis emits each frame one frame late
+#define CORE_DELAY_SAMPLES FRAME_SIZE
+
+static int64_t samples_to_ns(int64_t samples, unsigned int rate) {
+  return (samples * 1000000000LL + rate / 2) / rate;
+}
+
+static int64_t session_delay_ns(const AudxSession *session) {
+  if (!session->up)
+    return samples_to_ns(CORE_DELAY_SAMPLES, FRAME_RATE);
+  // The first down call is limited to one frame of output and leaves the
+  // end of its input unread, which moves everything after it earlier
+  const int skipped =
+      FRAME_SIZE - (int)audx_resampler_input_needed(session->down,
+                                                    session->frame_samples);
+  return samples_to_ns(audx_resampler_input_latency(session->up),
+                       session->in_rate) +
+         samples_to_ns(CORE_DELAY_SAMPLES +
+                           audx_resampler_input_latency(session->down) -
+                           skipped,
+                       FRAME_RATE);
+}
+
+AudxSession *audx_session_create(const AudxSessionConfig *config) {
+  return audx_session_create_in(config, nullptr, 0);
+}
+
+AudxSession *audx_session_create_in(const AudxSessionConfig *config,
+                                    AudxArena *arena, int owner) {
+  if (!config || config->in_rate == 0 || config->warm_interval < 0 ||
+      config->warm_interval > AUDX_BYPASS_WARM_INTERVAL_MAX ||
+      (arena && (owner < 0 || owner >= audx_arena_owners(arena))))
+    return nullptr;
+
+  AudxSession *session;
+  if (arena) {
+    void *block = audx_arena_alloc(arena, owner, sizeof(AudxSession));
+    if (!block)
+      return nullptr;
+    session = new (block) AudxSession();
+    session->arena = arena;
+  } else {
+    session = new AudxSession();
+  }
+  session->frame_samples = calculate_frame_sample(config->in_rate);
+  session->in_rate = config->in_rate;
+  AudxParams params;
+  audx_params_default(&params);
+  params.warm_interval = config->warm_interval;
+  session->params = audx_param_block_create(&params);
+  session->strength = params.strength;
+  session->agc_gain = 1.0f;
+
+  if (use_session_resampler(config)) {
+    session->state = audx_create(nullptr, FRAME_RATE, config->resample_quality);
+    AudxTableSpec specs[2];
+    audx_session_table_specs(config, specs);
+    session->up = audx_resampler_create_in(
+        specs[0].in_rate, specs[0].out_rate, specs[0].quality,
+        specs[0].bandwidth, audx_tables_find(config->tables, &specs[0]),
+        arena, owner);
+    session->down = audx_resampler_create_in(
+        specs[1].in_rate, specs[1].out_rate, specs[1].quality,
+        specs[1].bandwidth, audx_tables_find(config->tables, &specs[1]),
+        arena, owner);
+    if (!session->up || !session->down) {
+      audx_session_destroy(session);
+      return nullptr;
+    }
+    audx_resampler_set_deterministic(session->up, config->deterministic);
+    audx_resampler_set_deterministic(session->down, config->deterministic);
+  } else {
+    session->state =
+        audx_create(nullptr, config->in_rate, config->resample_quality);
+  }
+
+  session->delay_ns = session_delay_ns(session);
+  session->dry_delay =
+      (int)((session->delay_ns * session->in_rate + 500000000LL) /
+            1000000000LL);
+  const size_t held_samples = session->frame_samples + session->dry_delay;
+  session->held =
+      arena ? (short *)audx_arena_alloc(arena, owner,
+                                         sizeof(short) * held_samples)
+            : (short *)audx_state_calloc(held_samples, sizeof(short));
+  if (session->held)
+    session->dry_line = session->held + session->frame_samples;
+  if (!session->state || !session->held || !session->params) {
+    audx_session_destroy(session);
+    return nullptr;
+  }
+
+  // The workspace belongs to whichever thread processes the session, so it
+  // is reserved, locked and prefaulted there (prepare_scratch)
+  if (config->memory_flags & AUDX_MEMORY_LOCK) {
+    int result = 0;
+    session_memory(session, lock_range, &result);
+    session->memory_status |= AUDX_MEMORY_LOCK;
+    if (result != 0)
+      drop_lock(session);
+  }
+
+  if (config->memory_flags & AUDX_MEMORY_PREFAULT) {
+    // Silence through the full path faults in the core's state and every
+    // table it reads
+    short *silence = (short *)calloc(session->frame_samples, sizeof(short));
+    if (silence) {
+      for (int f = 0; f < 2; f++)
+        audx_session_process_int(session, silence, silence);
+      free(silence);
+    }
+    audx_session_prefault(session);
+    session->memory_status |= AUDX_MEMORY_PREFAULT;
+  }
+
+  return session;
+}
+
+int audx_session_table_specs(const AudxSessionConfig *config,
+                             AudxTableSpec specs[2]) {
+  if (!use_session_resampler(config))
+    return 0;
+  specs[0] = {config->in_rate, FRAME_RATE, config->resample_quality,
+              config->bandwidth};
+  specs[1] = {FRAME_RATE, config->in_rate, config->resample_quality,
+              config->bandwidth};
+  return 2;
+}
+
+// Runs one frame through the core, resampling around it when the session
+// owns the resamplers
+static float run_core(AudxSession *session, AudxScratch *scratch,
+                      const Frame *frame, short *in, short *out) {
+  if (!session->up)
+    return audx_process_int(session->state, in, out);
+
+  const int n = session->frame_samples;
+  unsigned int in_len = n, out_len = FRAME_SIZE;
+  audx_resampler_process_int_float_ws(session->up, scratch, in, &in_len,
+                                      frame->frame_in, &out_len);
+
+  const float vad =
+      audx_process(session->state, frame->frame_in, frame->frame_out);
+
+  in_len = FRAME_SIZE;
+  out_len = n;
+  audx_resampler_process_float_int_ws(session->down, scratch,
+                                      frame->frame_out, &in_len, out, &out_len);
+  return vad;
+}
+
+// Feeds the frame's input to the dry delay line and, unless `dry` is NULL,
+// returns the samples it pushes out. `dry` must not alias `in`.
+static void delay_dry(AudxSession *session, const short *in, short *dry) {
+  const int n = session->frame_samples, d = session->dry_delay;
+  if (d == 0) {
+    if (dry)
+      memcpy(dry, in, n * sizeof(short));
+    return;
+  }
+  // Chunks never wrap or exceed the line, so each reads its samples before
+  // overwriting them
+  for (int done = 0; done < n;) {
+    const int chunk = n - done < d - session->dry_pos ? n - done
+                                                      : d - session->dry_pos;
+    short *line = session->dry_line + session->dry_pos;
+    if (dry)
+      memcpy(dry + done, line, chunk * sizeof(short));
+    memcpy(line, in + done, chunk * sizeof(short));
+    session->dry_pos = (session->dry_pos + chunk) % d;
+    done += chunk;
+  }
+}
+
+// A fresh down resampler consumes slightly less than its first frame, so
+// its history only lines up with a continuously running one from the
+// second frame on
+#define PRIME_FULL_FRAMES 2
+
+int audx_session_prime(AudxSession *session, const short *samples, size_t n) {
+  AudxScratch *scratch = audx_scratch_thread_local();
+  Frame frame{};
+  if (!samples || get_frame(session, scratch, &frame) != 0)
+    return -1;
+
+  const size_t frame_samples = session->frame_samples;
+  const size_t frames = n / frame_samples;
+  const short *in = samples + (n - frames * frame_samples);
+  for (size_t f = 0; f < frames; f++, in += frame_samples) {
+    delay_dry(session, in, nullptr);
+    if (!session->up || f + PRIME_FULL_FRAMES >= frames) {
+      // The last frames also fill the down resampler's history
+      session->last_vad =
+          run_core(session, scratch, &frame, (short *)in, frame.wet);
+      continue;
+    }
+    unsigned int in_len = frame_samples, out_len = FRAME_SIZE;
+    audx_resampler_process_int_float_ws(session->up, scratch, in, &in_len,
+                                        frame.frame_in, &out_len);
+    session->last_vad =
+        audx_process(session->state, frame.frame_in, frame.frame_out);
+  }
+  session->held_valid = 0;
+  return (int)frames;
+}
+
+float audx_session_process_int(AudxSession *session, short *in, short *out) {
+  return audx_session_process_int_ws(session, audx_scratch_thread_local(), in,
+                                     out);
+}
+
+// Core output mixed with the delayed dry input at `strength`, ramped across
+// the frame from the strength of the previous one
+static float run_wet(AudxSession *session, AudxScratch *scratch,
+                     const Frame *frame, float strength, short *in,
+                     short *out) {
+  const float from = session->strength;
+  session->strength = strength;
+  if (from >= 1.0f && strength >= 1.0f)
+    return run_core(session, scratch, frame, in, out);
+
+  const float vad = run_core(session, scratch, frame, in, frame->mix);
+  blend_int16(frame->dry, frame->mix, out, session->frame_samples, from,
+              strength);
+  return vad;
+}
+
+static float route_frame(AudxSession *session, AudxScratch *scratch,
+                         const Frame &frame, const AudxParams *params,
+                         short *in, short *out) {
+  const int n = session->frame_samples;
+  const int requested = params->bypass;
+
+  // The dry path is only read when it is mixed in or passed through, but
+  // the line is fed every frame so it is ready when it is
+  const bool dry_used =
+      requested || session->bypass_active || params->strength < 1.0f ||
+      session->strength < 1.0f;
+  delay_dry(session, in, dry_used ? frame.dry : nullptr);
+
+  if (!requested && !session->bypass_active)
+    return run_wet(session, scratch, &frame, params->strength, in, out);
+
+  if (requested && !session->bypass_active) {
+    // Entering bypass: run this frame fully and fade wet -> dry
+    const float vad =
+        run_wet(session, scratch, &frame, params->strength, in, frame.wet);
+    crossfade_int16(frame.wet, frame.dry, out, n);
+    session->bypass_active = 1;
+    session->warm_counter = 0;
+    session->held_valid = 0;
+    return vad;
+  }
+
+  if (!requested) {
+    // Leaving bypass: replay the frame the core skipped so its history is
+    // contiguous, then fade dry -> wet
+    if (session->held_valid)
+      run_core(session, scratch, &frame, session->held, frame.wet);
+    const float vad =
+        run_wet(session, scratch, &frame, params->strength, in, frame.wet);
+    crossfade_int16(frame.dry, frame.wet, out, n);
+    session->bypass_active = 0;
+    session->held_valid = 0;
+    return vad;
+  }
+
+  // Steady bypass: pass through, feed the core every warm_interval frames
+  session->strength = params->strength;
+  float vad = session->last_vad;
+  if (params->warm_interval > 0 &&
+      ++session->warm_counter >= params->warm_interval) {
+    session->warm_counter = 0;
+    vad = run_core(session, scratch, &frame, in, frame.wet);
+    session->held_valid = 0;
+  } else {
+    memcpy(session->held, in, n * sizeof(short));
+    session->held_valid = 1;
+  }
+
+  memcpy(out, frame.dry, n * sizeof(short));
+  return vad;
+}
+
+// Speech level tracking per speech frame, as a fraction of the distance
+#define AGC_LEVEL_SMOOTHING 0.1f
+// Gains this close to unity are snapped to it so idle AGC costs nothing
+#define AGC_UNITY_EPSILON 1e-4f
+
+// Steers the output gain towards the AGC target, see params.h. Bypassed
+// output returns to unity gain within the frame that enters bypass.
+static void apply_agc(AudxSession *session, const AudxParams *params,
+                      float vad, short *out) {
+  const float from = session->agc_gain;
+  if (!params->agc) {
+    session->agc_active = 0;
+    if (from == 1.0f)
+      return;
+  }
+
+  const int n = session->frame_samples;
+  float target = 1.0f;
+  if (params->agc) {
+    if (!session->agc_active) {
+      session->agc_active = 1;
+      session->agc_level = params->agc_target_db;
+    }
+    if (vad >= AUDX_AGC_SPEECH_VAD && !session->bypass_active) {
+      // Measured before the gain, so the loop does not chase itself
+      float sum = 0.0f;
+      for (int i = 0; i < n; i++)
+        sum += (float)out[i] * (float)out[i];
+      const float level =
+          10.0f * log10f(sum / ((float)n * 32768.0f * 32768.0f) + 1e-10f);
+      session->agc_level += AGC_LEVEL_SMOOTHING * (level - session->agc_level);
+    }
+    float gain_db = params->agc_target_db - session->agc_level;
+    gain_db = gain_db > params->agc_max_gain_db ? params->agc_max_gain_db
+                                                : gain_db;
+    gain_db = gain_db < -params->agc_max_gain_db ? -params->agc_max_gain_db
+                                                 : gain_db;
+    target = powf(10.0f, gain_db / 20.0f);
+  }
+
+  float to = 1.0f;
+  if (!session->bypass_active) {
+    const float slew = powf(10.0f, AUDX_AGC_SLEW_DB / 20.0f);
+    to = target > from * slew   ? from * slew
+         : target < from / slew ? from / slew
+                                : target;
+    if (fabsf(to - 1.0f) < AGC_UNITY_EPSILON)
+      to = 1.0f;
+  }
+  if (from == 1.0f && to == 1.0f)
+    return;
+
+  // Never boost the frame into clipping
+  int peak = 1;
+  for (int i = 0; i < n; i++) {
+    const int a = out[i] < 0 ? -out[i] : out[i];
+    peak = a > peak ? a : peak;
+  }
+  if (to * (float)peak > PCM_SCALE_FLOAT_MAX)
+    to = PCM_SCALE_FLOAT_MAX / (float)peak;
+
+  const float step = 1.0f / (float)n;
+  for (int i = 0; i < n; i++) {
+    const float g = from + (to - from) * ((float)(i + 1) * step);
+    float v = (float)out[i] * g;
+    v = v > PCM_SCALE_FLOAT_MAX ? PCM_SCALE_FLOAT_MAX : v;
+    v = v < PCM_SCALE_FLOAT_MIN ? PCM_SCALE_FLOAT_MIN : v;
+    out[i] = (short)lrintf(v);
+  }
+  session->agc_gain = to;
+}
+
+static float process_frame(AudxSession *session, AudxScratch *scratch,
+                           short *in, short *out) {
+  Frame frame{};
+  if (get_frame(session, scratch, &frame) != 0)
+    return -1.0f;
+
+  // The only point the frame looks at the parameters: everything below
+  // sees one consistent set
+  const AudxParams *params = audx_param_block_acquire(session->params);
+  session->last_vad = route_frame(session, scratch, frame, params, in, out);
+  apply_agc(session, params, session->last_vad, out);
+  return session->last_vad;
+}
+
+// Pushes the frame's VAD and any speech segment boundary
+static void report_events(AudxSession *session, float vad) {
+  AudxEvent event = {};
+  event.stream = session->events_stream;
+  event.frame = session->events_frame++;
+
+  event.type = AUDX_EVENT_VAD;
+  event.value = vad;
+  audx_events_push(session->events, &event);
+
+  if (!session->in_speech) {
+    if (vad >= AUDX_EVENT_SPEECH_ON) {
+      session->in_speech = 1;
+      session->speech_frames = 1;
+      session->quiet_frames = 0;
+      event.type = AUDX_EVENT_SPEECH_START;
+      audx_events_push(session->events, &event);
+    }
+    return;
+  }
+
+  session->speech_frames++;
+  session->quiet_frames = vad < AUDX_EVENT_SPEECH_OFF
+                              ? session->quiet_frames + 1
+                              : 0;
+  if (session->quiet_frames > AUDX_EVENT_SPEECH_HANGOVER) {
+    session->in_speech = 0;
+    event.type = AUDX_EVENT_SPEECH_END;
+    event.aux = session->speech_frames;
+    audx_events_push(session->events, &event);
+  }
+}
+
+// Per-frame hooks: the speaker detector, the event ring and DTX. Frames
+// that failed (negative VAD) are not reported.
+static void report_frame(AudxSession *session, float vad, const short *out) {
+  if (vad < 0.0f)
+    return;
+  if (session->speaker)
+    audx_speaker_update(session->speaker, session->speaker_stream, vad, out,
+                        session->frame_samples);
+  if (session->events)
+    report_events(session, vad);
+  if (session->dtx)
+    audx_dtx_update(session->dtx, vad, out, session->frame_samples, nullptr);
+}
+
+int audx_session_process_dry(AudxSession *session, const short *in,
+                             short *out) {
+  // The hooks still see the frame, with the last VAD the core produced and
+  // the input when there is no output
+  if (!out) {
+    delay_dry(session, in, nullptr);
+    report_frame(session, session->last_vad, in);
+    return 0;
+  }
+  Frame frame{};
+  if (get_frame(session, audx_scratch_thread_local(), &frame) != 0)
+    return -1;
+  delay_dry(session, in, frame.dry);
+  memcpy(out, frame.dry, session->frame_samples * sizeof(short));
+  report_frame(session, session->last_vad, out);
+  return 0;
+}
+
+float audx_session_process_int_ws(AudxSession *session, AudxScratch *scratch,
+                                  short *in, short *out) {
+  if (scratch != session->prepared)
+    prepare_scratch(session, scratch);
+
+  float vad;
+  if (session->monitor) {
+    const int64_t start = audx_engine_now_ns();
+    vad = process_frame(session, scratch, in, out);
+    audx_monitor_publish(session->monitor, session->monitor_slot,
+                         audx_engine_now_ns() - start, vad,
+                         AUDX_FRAME_ON_TIME);
+  } else {
+    vad = process_frame(session, scratch, in, out);
+  }
+  report_frame(session, vad, out);
+  return vad;
+}
+
+void audx_session_set_speaker(AudxSession *session,
+                              AudxSpeakerDetector *detector, int stream) {
+  session->speaker = detector;
+  session->speaker_stream = stream;
+}
+
+void audx_session_set_monitor(AudxSession *session, AudxMonitor *monitor,
+                              int slot) {
+  session->monitor = monitor;
+  session->monitor_slot = slot;
+}
+
+void audx_session_set_events(AudxSession *session, AudxEventRing *ring,
+                             int stream) {
+  session->events = ring;
+  session->events_stream = stream;
+  session->events_frame = 0;
+  session->in_speech = 0;
+  session->speech_frames = 0;
+  session->quiet_frames = 0;
+}
+
+void audx_session_set_dtx(AudxSession *session, AudxDtx *dtx) {
+  session->dtx = dtx;
+}
+
+void audx_session_set_bypass(AudxSession *session, int enabled) {
+  AudxParams params;
+  params.bypass = enabled;
+  audx_param_block_update(session->params, &params, AUDX_PARAM_BYPASS);
+}
+
+int audx_session_get_bypass(const AudxSession *session) {
+  AudxParams params;
+  audx_param_block_latest(session->params, &params);
+  return params.bypass;
+}
+
+int audx_session_set_params(AudxSession *session, const AudxParams *params,
+                            unsigned int fields) {
+  return audx_param_block_update(session->params, params, fields);
+}
+
+void audx_session_get_params(const AudxSession *session, AudxParams *out) {
+  audx_param_block_latest(session->params, out);
+}
+
+int audx_session_scratch_reserve(const AudxSession *session,
+                                 AudxScratch *scratch) {
+  if (!audx_scratch_get(scratch, AUDX_SCRATCH_SESSION, frame_bytes(session)))
+    return -1;
+  if (session->up) {
+    const size_t window = audx_resampler_scratch_bytes(session->up) >
+                                  audx_resampler_scratch_bytes(session->down)
+                              ? audx_resampler_scratch_bytes(session->up)
+                              : audx_resampler_scratch_bytes(session->down);
+    if (!audx_scratch_get(scratch, AUDX_SCRATCH_RESAMPLER, window))
+      return -1;
+  }
+  return 0;
+}
+
+size_t audx_session_state_bytes(const AudxSession *session) {
+  size_t bytes = sizeof(AudxSession) +
+                 sizeof(short) * (session->frame_samples + session->dry_delay);
+  if (session->up)
+    bytes += audx_resampler_state_bytes(session->up) +
+             audx_resampler_state_bytes(session->down);
+  return bytes;
+}
+
+void audx_session_prefault(AudxSession *session) {
+  AudxScratch *scratch = audx_scratch_thread_local();
+  prepare_scratch(session, scratch);
+  audx_scratch_prefault(scratch);
+  session_memory(session, prefault_range, nullptr);
+}
+
+int audx_session_memory_status(const AudxSession *session) {
+  return session->memory_status;
+}
+
+int audx_session_frame_samples(const AudxSession *session) {
+  return session->frame_samples;
+}
+
+int64_t audx_session_delay_ns(const AudxSession *session) {
+  return session->delay_ns;
+}
+
+void audx_session_destroy(AudxSession *session) {
+  if (!session)
+    return;
+
+  if (session->memory_status & AUDX_MEMORY_LOCK)
+    session_memory(session, unlock_range, nullptr);
+  if (session->state)
+    audx_destroy(session->state);
+  audx_resampler_destroy(session->up);
+  audx_resampler_destroy(session->down);
+  audx_param_block_destroy(session->params);
+  if (session->arena) {
+    session->~AudxSession(); // the arena releases the memory
+  } else {
+    free(session->held);
+    delete session;
+  }
+}
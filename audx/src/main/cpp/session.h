@@ -0,0 +1,181 @@
+#ifndef AUDX_SESSION_H
+#define AUDX_SESSION_H
+
+#include "arena.h"
+#include "audx.h"
+#include "dtx.h"
+#include "events.h"
+#include "memlock.h"
+#include "monitor.h"
+#include "params.h"
+#include "scratch.h"
+#include "speaker.h"
+#include "tables.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Session --- */
+// A session owns one AudxState together with the per-stream features the
+// wrapper adds on top of the core. Frames are 10ms at in_rate, exactly as
+// for audx_process_int().
+
+// Bypass keeps the core warm by feeding it one frame out of every
+// warm_interval frames. 1 tracks every frame, 0 disables warm updates.
+#define AUDX_BYPASS_WARM_INTERVAL_DEFAULT 2
+#define AUDX_BYPASS_WARM_INTERVAL_MAX 16
+
+// Memory residency options. PREFAULT runs two frames of silence at create
+// time and touches all wrapper and core library pages; LOCK additionally
+// mlocks them. Both degrade gracefully when not permitted, see
+// audx_session_memory_status(). The per-thread workspace is handled on the
+// thread that processes: the first frame there reserves, locks and
+// prefaults it, or call audx_session_prefault() on that thread beforehand.
+#define AUDX_MEMORY_PREFAULT 1
+#define AUDX_MEMORY_LOCK 2
+
+typedef struct AudxSession AudxSession;
+
+typedef struct AudxSessionConfig {
+  unsigned int in_rate;
+  int resample_quality;
+  int warm_interval;
+  // Highest frequency present in the input in Hz, 0 for full band. When
+  // set, the resampling around the core uses band-limited filters.
+  unsigned int bandwidth;
+  int memory_flags; // AUDX_MEMORY_*
+  // Shared filter banks to use instead of private ones, NULL for none.
+  // Banks missing from the tables are built privately.
+  const AudxTables *tables;
+  // 1 for output that is bit-identical across instruction sets: the
+  // wrapper's resamplers use audx_resampler_set_deterministic(). The core
+  // itself must be built deterministic too, and rates that are not a
+  // multiple of 100 (resampled inside the core) are not covered.
+  int deterministic;
+} AudxSessionConfig;
+
+// Defaults: 48kHz, resample quality 4, warm interval 2, full band, no
+// memory flags, no shared tables, not deterministic
+void audx_session_config_default(AudxSessionConfig *config);
+
+AudxSession *audx_session_create(const AudxSessionConfig *config);
+
+// Same as above with the session's wrapper state (the session itself, its
+// resamplers' state and the bypass buffer) placed in `owner`'s region of
+// `arena`, e.g. the worker that will process it. The core's AudxState is
+// allocated by the core. Destroy the session before the arena.
+AudxSession *audx_session_create_in(const AudxSessionConfig *config,
+                                    AudxArena *arena, int owner);
+
+// Resampler banks a session with this config uses, for building shared
+// tables. Writes up to two specs and returns how many.
+int audx_session_table_specs(const AudxSessionConfig *config,
+                             AudxTableSpec specs[2]);
+
+float audx_session_process_int(AudxSession *session, short *in, short *out);
+
+// Same as above using an explicit workspace. Any number of sessions may
+// share one workspace as long as they are processed on the same thread.
+float audx_session_process_int_ws(AudxSession *session, AudxScratch *scratch,
+                                  short *in, short *out);
+
+// Passes a frame through without running the core, which skips it: `out`
+// gets the input delayed like processed output, as in bypass. With `out`
+// NULL the frame only advances that delay, so bypass and the dry part of
+// later frames stay aligned. For frames that are not processed in time.
+// The speaker detector, event ring and DTX still get the frame, with the
+// last VAD the core produced and `out` (the input when `out` is NULL) as
+// its audio, so their frame counts and decisions stay current.
+// Returns 0, or -1 if no workspace could be allocated.
+int audx_session_process_dry(AudxSession *session, const short *in,
+                             short *out);
+
+// Grows `scratch` so processing this session never allocates. Sessions
+// reserve a workspace themselves on their first frame with it.
+int audx_session_scratch_reserve(const AudxSession *session,
+                                 AudxScratch *scratch);
+
+// Bytes the wrapper keeps per session between frames (the core's own
+// AudxState is not included)
+size_t audx_session_state_bytes(const AudxSession *session);
+
+// Reports every processed frame (VAD and output energy) to `detector` as
+// `stream`; NULL detaches. Call between frames, on the processing thread.
+void audx_session_set_speaker(AudxSession *session,
+                              AudxSpeakerDetector *detector, int stream);
+
+// Publishes the processing time and VAD of every frame to `slot` of a
+// monitor page; NULL detaches. Sessions run by an engine are published by
+// the engine instead (audx_engine_set_monitor), with deadline misses.
+// Call between frames, on the processing thread.
+void audx_session_set_monitor(AudxSession *session, AudxMonitor *monitor,
+                              int slot);
+
+// Pushes an AUDX_EVENT_VAD for every processed frame and speech segment
+// start and end events to `ring` as `stream`; NULL detaches. Frames are
+// counted from the call. Call between frames, on the processing thread.
+void audx_session_set_events(AudxSession *session, AudxEventRing *ring,
+                             int stream);
+
+// Runs `dtx` on every processed frame (its VAD and output), so the encoder
+// can read the decision with audx_dtx_last() after each call; NULL
+// detaches. Call between frames, on the processing thread.
+void audx_session_set_dtx(AudxSession *session, AudxDtx *dtx);
+
+// Adapts the session to the room before the first live frame by feeding it
+// pre-roll audio (e.g. what was captured while muted) without producing
+// output. Only the most recent whole frames are used, so the last one
+// should directly precede the next frame passed to process. With the
+// session's own resampler (rates other than 48 kHz that are a multiple of
+// 100 Hz), resampling back to in_rate is skipped for all but the last two
+// frames. At 48 kHz and at rates the core resamples itself every frame is
+// fully processed, so priming costs as much as processing the pre-roll.
+// Returns the number of frames consumed, or -1.
+int audx_session_prime(AudxSession *session, const short *samples, size_t n);
+
+// Safe to call from any thread; the switch happens at the next frame
+// boundary with a one-frame crossfade. Shorthand for the bypass field of
+// audx_session_set_params().
+void audx_session_set_bypass(AudxSession *session, int enabled);
+
+int audx_session_get_bypass(const AudxSession *session);
+
+// Changes the `fields` (AUDX_PARAM_*) of the session's runtime parameters
+// from any thread, without waiting for or stalling the processing thread.
+// The next frame to start uses the new set; strength and AGC gain changes
+// are ramped across that frame. Returns -1, changing nothing, if a value
+// is out of range. The initial warm interval comes from the config.
+int audx_session_set_params(AudxSession *session, const AudxParams *params,
+                            unsigned int fields);
+
+// The newest parameters set, which may not have reached a frame yet
+void audx_session_get_params(const AudxSession *session, AudxParams *out);
+
+// Touches the session's pages, the core library and the calling thread's
+// workspace, reserving the workspace first. Call on the audio thread before
+// the first frame and after long idle periods. With AUDX_MEMORY_LOCK the
+// workspace is locked too.
+void audx_session_prefault(AudxSession *session);
+
+// AUDX_MEMORY_* flags that are actually in effect
+int audx_session_memory_status(const AudxSession *session);
+
+int audx_session_frame_samples(const AudxSession *session);
+
+// Algorithmic delay in nanoseconds: output sample i carries what was
+// captured this long before input sample i. Covers the session's
+// resamplers and the core's one-frame synthesis delay; the core's own
+// resampling (rates that are not a multiple of 100 Hz) is not included.
+// Bypassed frames and the dry part of a partial strength are delayed by
+// the same amount (rounded to whole samples at in_rate), so the dry and
+// wet paths line up wherever they are mixed or crossfaded.
+int64_t audx_session_delay_ns(const AudxSession *session);
+
+void audx_session_destroy(AudxSession *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_SESSION_H
@@ -0,0 +1,226 @@
+#include "speaker.h"
+#include "arena.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+// Energy of a stream that reported nothing, and the floor of any frame
+#define SPEAKER_SILENCE_DB 0.0f
+// Frames a stream can report between two ticks without losing any
+#define SPEAKER_HISTORY 8
+// Ticks without a frame that still repeat the stream's last frames, so
+// delivery jitter does not read as silence. After that the stream is silent.
+#define SPEAKER_HOLD_TICKS 5
+
+namespace {
+
+// Written by the stream's processing thread. Streams run on different
+// threads, so each gets its own lines.
+struct alignas(AUDX_STATE_ALIGN) SpeakerInput {
+  struct {
+    std::atomic<float> vad;
+    std::atomic<float> energy_db;
+  } frames[SPEAKER_HISTORY]; // frame u in slot u % SPEAKER_HISTORY
+  std::atomic<uint32_t> updates;
+};
+
+// Owned by the ticking thread, kept apart from the inputs it polls
+struct SpeakerStream {
+  uint32_t seen;
+  float vad;       // of the frames in the last tick that had any
+  float energy_db; // same
+  int missed;      // ticks in a row without a frame
+  float level_db;  // smoothed energy
+  int talking;
+  int quiet_frames;
+};
+
+} // namespace
+
+struct AudxSpeakerDetector {
+  AudxSpeakerConfig config;
+  int count;
+  SpeakerInput *inputs;
+  SpeakerStream *streams;
+
+  AudxSpeakerChangeFn changed;
+  void *ctx;
+
+  std::atomic<int> active;
+  int challenger; // stream dominating the active speaker, -1 if none
+  int challenger_frames;
+};
+
+void audx_speaker_config_default(AudxSpeakerConfig *config) {
+  config->vad_on = 0.6f;
+  config->vad_off = 0.3f;
+  config->hangover_frames = 30;
+  config->dominance_db = 6.0f;
+  config->switch_frames = 20;
+  config->smoothing = 0.1f;
+}
+
+AudxSpeakerDetector *audx_speaker_create(const AudxSpeakerConfig *config,
+                                         int streams,
+                                         AudxSpeakerChangeFn changed,
+                                         void *ctx) {
+  if (!config || streams < 1 || config->vad_off > config->vad_on ||
+      config->hangover_frames < 0 || config->switch_frames < 1 ||
+      !(config->smoothing > 0.0f && config->smoothing <= 1.0f))
+    return nullptr;
+
+  auto *detector = new AudxSpeakerDetector();
+  detector->config = *config;
+  detector->count = streams;
+  detector->inputs = new SpeakerInput[streams];
+  detector->streams = new SpeakerStream[streams];
+  for (int i = 0; i < streams; i++) {
+    SpeakerInput &in = detector->inputs[i];
+    for (auto &frame : in.frames) {
+      frame.vad.store(0.0f, std::memory_order_relaxed);
+      frame.energy_db.store(SPEAKER_SILENCE_DB, std::memory_order_relaxed);
+    }
+    in.updates.store(0, std::memory_order_relaxed);
+    SpeakerStream &s = detector->streams[i];
+    s.seen = 0;
+    s.vad = 0.0f;
+    s.energy_db = SPEAKER_SILENCE_DB;
+    s.missed = SPEAKER_HOLD_TICKS;
+    s.level_db = SPEAKER_SILENCE_DB;
+    s.talking = 0;
+    s.quiet_frames = 0;
+  }
+  detector->changed = changed;
+  detector->ctx = ctx;
+  detector->active.store(-1, std::memory_order_relaxed);
+  detector->challenger = -1;
+  detector->challenger_frames = 0;
+  return detector;
+}
+
+void audx_speaker_update_energy(AudxSpeakerDetector *detector, int stream,
+                                float vad, float energy_db) {
+  if (stream < 0 || stream >= detector->count)
+    return;
+  // A stream reports from one thread at a time, so it owns the counter
+  SpeakerInput &in = detector->inputs[stream];
+  const uint32_t updates = in.updates.load(std::memory_order_relaxed);
+  auto &frame = in.frames[updates % SPEAKER_HISTORY];
+  frame.vad.store(vad, std::memory_order_relaxed);
+  frame.energy_db.store(energy_db, std::memory_order_relaxed);
+  in.updates.store(updates + 1, std::memory_order_release);
+}
+
+void audx_speaker_update(AudxSpeakerDetector *detector, int stream, float vad,
+                         const short *frame, int len) {
+  float sum = 0.0f;
+  for (int i = 0; i < len; i++)
+    sum += (float)frame[i] * (float)frame[i];
+  const float mean = len > 0 ? sum / (float)len : 0.0f;
+  audx_speaker_update_energy(detector, stream, vad,
+                             10.0f * log10f(mean + 1.0f));
+}
+
+// Advances one stream's talking state and smoothed energy by one frame
+// period. Frames that arrive in a burst count together (highest VAD, mean
+// energy); a period without any repeats the last one for a few ticks.
+static void track(const AudxSpeakerConfig &config, const SpeakerInput &in,
+                  SpeakerStream &s) {
+  const uint32_t updates = in.updates.load(std::memory_order_acquire);
+  uint32_t fresh = updates - s.seen;
+  s.seen = updates;
+  if (fresh > SPEAKER_HISTORY)
+    fresh = SPEAKER_HISTORY; // older frames were overwritten
+  if (fresh > 0) {
+    float vad = 0.0f, energy_sum = 0.0f;
+    for (uint32_t u = updates - fresh; u != updates; u++) {
+      const auto &frame = in.frames[u % SPEAKER_HISTORY];
+      const float v = frame.vad.load(std::memory_order_relaxed);
+      vad = v > vad ? v : vad;
+      energy_sum += frame.energy_db.load(std::memory_order_relaxed);
+    }
+    s.vad = vad;
+    s.energy_db = energy_sum / (float)fresh;
+    s.missed = 0;
+  } else if (s.missed < SPEAKER_HOLD_TICKS) {
+    s.missed++;
+  }
+  const bool silent = s.missed >= SPEAKER_HOLD_TICKS;
+  const float vad = silent ? 0.0f : s.vad;
+  const float energy_db = silent ? SPEAKER_SILENCE_DB : s.energy_db;
+
+  s.level_db += config.smoothing * (energy_db - s.level_db);
+  if (vad >= config.vad_on) {
+    s.talking = 1;
+    s.quiet_frames = 0;
+  } else if (vad >= config.vad_off) {
+    s.quiet_frames = 0;
+  } else if (s.talking && ++s.quiet_frames > config.hangover_frames) {
+    s.talking = 0;
+  }
+}
+
+int audx_speaker_tick(AudxSpeakerDetector *detector) {
+  const AudxSpeakerConfig &config = detector->config;
+  const int active = detector->active.load(std::memory_order_relaxed);
+
+  // Loudest talking stream other than the active one
+  int candidate = -1;
+  for (int i = 0; i < detector->count; i++) {
+    SpeakerStream &s = detector->streams[i];
+    track(config, detector->inputs[i], s);
+    if (i != active && s.talking &&
+        (candidate < 0 || s.level_db > detector->streams[candidate].level_db))
+      candidate = i;
+  }
+
+  int next = active;
+  if (active >= 0 && detector->streams[active].talking) {
+    // The active speaker keeps the floor until a challenger dominates it
+    // for switch_frames in a row
+    if (candidate >= 0 && detector->streams[candidate].level_db >=
+                              detector->streams[active].level_db +
+                                  config.dominance_db) {
+      if (candidate != detector->challenger) {
+        detector->challenger = candidate;
+        detector->challenger_frames = 0;
+      }
+      if (++detector->challenger_frames >= config.switch_frames)
+        next = candidate;
+    } else {
+      detector->challenger = -1;
+      detector->challenger_frames = 0;
+    }
+  } else if (candidate >= 0) {
+    // The floor is free
+    next = candidate;
+  }
+
+  if (next != active) {
+    detector->active.store(next, std::memory_order_relaxed);
+    detector->challenger = -1;
+    detector->challenger_frames = 0;
+    if (detector->changed)
+      detector->changed(detector->ctx, active, next);
+  }
+  return next;
+}
+
+int audx_speaker_active(const AudxSpeakerDetector *detector) {
+  return detector->active.load(std::memory_order_relaxed);
+}
+
+int audx_speaker_talking(const AudxSpeakerDetector *detector, int stream) {
+  if (stream < 0 || stream >= detector->count)
+    return 0;
+  return detector->streams[stream].talking;
+}
+
+void audx_speaker_destroy(AudxSpeakerDetector *detector) {
+  if (!detector)
+    return;
+  delete[] detector->inputs;
+  delete[] detector->streams;
+  delete detector;
+}
@@ -0,0 +1,72 @@
+#ifndef AUDX_SPEAKER_H
+#define AUDX_SPEAKER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Active speaker --- */
+// Decides which of several streams is the active speaker from each stream's
+// per-frame VAD probability and frame energy. A stream counts as talking
+// once its VAD reaches vad_on and stops after its VAD has stayed below
+// vad_off for hangover_frames. Among talking streams the loudest (smoothed
+// energy) wins, but a talking active speaker only loses the floor to a
+// stream that is dominance_db louder for switch_frames in a row. When
+// nobody talks the last active speaker is kept.
+//
+// Streams report frames from any thread; the decision is made once per
+// frame period by audx_speaker_tick() on a single thread, which calls the
+// change callback only when the active speaker changes.
+
+typedef struct AudxSpeakerDetector AudxSpeakerDetector;
+
+typedef struct AudxSpeakerConfig {
+  float vad_on;
+  float vad_off;
+  int hangover_frames;
+  float dominance_db;
+  int switch_frames;
+  float smoothing; // weight of a new frame in the smoothed energy, (0, 1]
+} AudxSpeakerConfig;
+
+// Defaults: on at 0.6, off below 0.3 for 300ms, 6 dB dominance held for
+// 200ms, smoothing 0.1
+void audx_speaker_config_default(AudxSpeakerConfig *config);
+
+// `previous` and `current` are stream indices, -1 for none
+typedef void (*AudxSpeakerChangeFn)(void *ctx, int previous, int current);
+
+AudxSpeakerDetector *audx_speaker_create(const AudxSpeakerConfig *config,
+                                         int streams,
+                                         AudxSpeakerChangeFn changed,
+                                         void *ctx);
+
+// Reports one frame of `stream`; the energy is taken from the samples. Each
+// stream reports from one thread at a time.
+void audx_speaker_update(AudxSpeakerDetector *detector, int stream, float vad,
+                         const short *frame, int len);
+
+// Same with a precomputed energy (mean square in int16 units, in dB)
+void audx_speaker_update_energy(AudxSpeakerDetector *detector, int stream,
+                                float vad, float energy_db);
+
+// Evaluates the frames reported since the previous tick: their highest VAD
+// and mean energy count as one frame. A stream that reported nothing keeps
+// its last value for up to 5 ticks (delivery jitter) and is silent after
+// that. Returns the active stream or -1.
+int audx_speaker_tick(AudxSpeakerDetector *detector);
+
+int audx_speaker_active(const AudxSpeakerDetector *detector);
+
+// Whether `stream` currently counts as talking; on the ticking thread
+int audx_speaker_talking(const AudxSpeakerDetector *detector, int stream);
+
+// No stream may be reporting: detach every session first, between its
+// frames (audx_session_set_speaker() with NULL)
+void audx_speaker_destroy(AudxSpeakerDetector *detector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_SPEAKER_H
@@ -0,0 +1,227 @@
+#include "stream.h"
+#include "arena.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// Timestamp anchors kept per stream. Writes that continue the timeline at
+// the nominal rate need none, so only discontinuities (jitter, drift
+// corrections, gaps) use them; when full the oldest is dropped.
+#define STREAM_ANCHORS 64
+
+struct StreamAnchor {
+  uint64_t index; // input sample the timestamp belongs to
+  int64_t timestamp_ns;
+};
+
+struct AudxStream {
+  AudxSession *session;
+  unsigned int frame_samples;
+
+  short *pending; // input frame being collected
+  unsigned int pending_fill;
+
+  short *queue; // processed output, ring of queue_cap samples
+  unsigned int queue_cap;
+  unsigned int queue_read;
+  unsigned int queue_fill;
+
+  short *frame_out;
+  float vad;
+
+  // Sample positions since create; output sample i carries input sample i
+  uint64_t written;
+  uint64_t read;
+  unsigned int rate;
+  int64_t delay_ns;
+  StreamAnchor anchors[STREAM_ANCHORS]; // ring, oldest first
+  unsigned int anchor_first;
+  unsigned int anchor_count;
+};
+
+AudxStream *audx_stream_create(const AudxSessionConfig *config,
+                               int queue_frames) {
+  if (queue_frames < 1)
+    return nullptr;
+
+  AudxSession *session = audx_session_create(config);
+  if (!session)
+    return nullptr;
+
+  auto *stream = (AudxStream *)audx_state_calloc(1, sizeof(AudxStream));
+  if (!stream) {
+    audx_session_destroy(session);
+    return nullptr;
+  }
+  stream->session = session;
+  stream->frame_samples = audx_session_frame_samples(session);
+  stream->queue_cap = stream->frame_samples * queue_frames;
+  stream->rate = stream->frame_samples * 100;
+  stream->delay_ns = audx_session_delay_ns(session);
+  stream->pending =
+      (short *)audx_state_calloc(stream->frame_samples, sizeof(short));
+  stream->frame_out =
+      (short *)audx_state_calloc(stream->frame_samples, sizeof(short));
+  stream->queue = (short *)audx_state_calloc(stream->queue_cap, sizeof(short));
+  if (!stream->pending || !stream->frame_out || !stream->queue) {
+    audx_stream_destroy(stream);
+    return nullptr;
+  }
+  return stream;
+}
+
+static void queue_push(AudxStream *stream, const short *in, unsigned int len) {
+  unsigned int tail = stream->queue_read + stream->queue_fill;
+  if (tail >= stream->queue_cap)
+    tail -= stream->queue_cap;
+  const unsigned int first =
+      len < stream->queue_cap - tail ? len : stream->queue_cap - tail;
+  memcpy(stream->queue + tail, in, first * sizeof(short));
+  memcpy(stream->queue, in + first, (len - first) * sizeof(short));
+  stream->queue_fill += len;
+}
+
+// Processes the pending frame if it is complete and its output fits.
+// Returns 0 while a complete frame is still parked.
+static int flush_frame(AudxStream *stream) {
+  const unsigned int n = stream->frame_samples;
+  if (stream->pending_fill < n)
+    return 1;
+  if (stream->queue_cap - stream->queue_fill < n)
+    return 0;
+
+  stream->vad = audx_session_process_int(stream->session, stream->pending,
+                                         stream->frame_out);
+  queue_push(stream, stream->frame_out, n);
+  stream->pending_fill = 0;
+  return 1;
+}
+
+int audx_stream_write(AudxStream *stream, const short *in, unsigned int len) {
+  unsigned int used = 0;
+  while (used < len && flush_frame(stream)) {
+    unsigned int take = stream->frame_samples - stream->pending_fill;
+    if (take > len - used)
+      take = len - used;
+    memcpy(stream->pending + stream->pending_fill, in + used,
+           take * sizeof(short));
+    stream->pending_fill += take;
+    used += take;
+  }
+  flush_frame(stream);
+  stream->written += used;
+  return (int)used;
+}
+
+static const StreamAnchor &anchor_at(const AudxStream *stream,
+                                     unsigned int i) {
+  return stream->anchors[(stream->anchor_first + i) % STREAM_ANCHORS];
+}
+
+// Duration of `samples` (truncated toward zero). Whole seconds and the
+// remainder are scaled separately so no product overflows however far the
+// index runs past its anchor.
+static int64_t samples_to_ns(int64_t samples, unsigned int rate) {
+  const int64_t r = rate;
+  return samples / r * 1000000000LL + samples % r * 1000000000LL / r;
+}
+
+// Timestamp of input sample `index` on the timeline of the newest anchor at
+// or before it (the oldest anchor when there is none, 0 without anchors)
+static int64_t input_timestamp(const AudxStream *stream, uint64_t index) {
+  if (stream->anchor_count == 0)
+    return samples_to_ns((int64_t)index, stream->rate);
+  unsigned int i = 0;
+  while (i + 1 < stream->anchor_count &&
+         anchor_at(stream, i + 1).index <= index)
+    i++;
+  const StreamAnchor &a = anchor_at(stream, i);
+  return a.timestamp_ns + samples_to_ns((int64_t)(index - a.index),
+                                        stream->rate);
+}
+
+int64_t audx_stream_input_timestamp(const AudxStream *stream,
+                                    uint64_t index) {
+  return input_timestamp(stream, index);
+}
+
+int audx_stream_write_ts(AudxStream *stream, const short *in, unsigned int len,
+                         int64_t timestamp_ns) {
+  const uint64_t index = stream->written;
+  const int used = audx_stream_write(stream, in, len);
+  if (used == 0 ||
+      (stream->anchor_count > 0 &&
+       input_timestamp(stream, index) == timestamp_ns))
+    return used;
+
+  if (stream->anchor_count == STREAM_ANCHORS) {
+    stream->anchor_first = (stream->anchor_first + 1) % STREAM_ANCHORS;
+    stream->anchor_count--;
+  }
+  stream->anchors[(stream->anchor_first + stream->anchor_count) %
+                  STREAM_ANCHORS] = {index, timestamp_ns};
+  stream->anchor_count++;
+  return used;
+}
+
+int audx_stream_read(AudxStream *stream, short *out, unsigned int len) {
+  if (len > stream->queue_fill)
+    len = stream->queue_fill;
+
+  const unsigned int first = len < stream->queue_cap - stream->queue_read
+                                 ? len
+                                 : stream->queue_cap - stream->queue_read;
+  memcpy(out, stream->queue + stream->queue_read, first * sizeof(short));
+  memcpy(out + first, stream->queue, (len - first) * sizeof(short));
+
+  stream->queue_read += len;
+  if (stream->queue_read >= stream->queue_cap)
+    stream->queue_read -= stream->queue_cap;
+  stream->queue_fill -= len;
+  stream->read += len;
+  return (int)len;
+}
+
+int audx_stream_read_ts(AudxStream *stream, short *out, unsigned int len,
+                        int64_t *timestamp_ns) {
+  const uint64_t index = stream->read;
+  const int n = audx_stream_read(stream, out, len);
+  if (n == 0)
+    return 0;
+
+  // Anchors before the one covering `index` are no longer needed
+  while (stream->anchor_count > 1 && anchor_at(stream, 1).index <= index) {
+    stream->anchor_first = (stream->anchor_first + 1) % STREAM_ANCHORS;
+    stream->anchor_count--;
+  }
+  *timestamp_ns = input_timestamp(stream, index) - stream->delay_ns;
+  return n;
+}
+
+unsigned int audx_stream_available(const AudxStream *stream) {
+  return stream->queue_fill;
+}
+
+float audx_stream_vad(const AudxStream *stream) { return stream->vad; }
+
+void audx_stream_reset(AudxStream *stream) {
+  // The next sample read carries the next sample written
+  stream->read = stream->written;
+  stream->pending_fill = 0;
+  stream->queue_read = 0;
+  stream->queue_fill = 0;
+}
+
+AudxSession *audx_stream_session(AudxStream *stream) {
+  return stream->session;
+}
+
+void audx_stream_destroy(AudxStream *stream) {
+  if (!stream)
+    return;
+  audx_session_destroy(stream->session);
+  free(stream->pending);
+  free(stream->frame_out);
+  free(stream->queue);
+  free(stream);
+}
@@ -0,0 +1,72 @@
+#ifndef AUDX_STREAM_H
+#define AUDX_STREAM_H
+
+#include "session.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Streaming --- */
+// Session wrapper for device callbacks whose period is not a 10ms frame.
+// Captured samples are written in any amount; whole frames are processed as
+// soon as they complete and queued for reading. Output lags input by the
+// partial frame still being collected.
+//
+// Writes and reads must not run concurrently; everything is allocated at
+// create.
+
+typedef struct AudxStream AudxStream;
+
+// `queue_frames` processed frames can wait to be read before writes stop
+// accepting input (at least 1)
+AudxStream *audx_stream_create(const AudxSessionConfig *config,
+                               int queue_frames);
+
+// Returns the number of samples accepted, fewer than `len` when the output
+// queue is full
+int audx_stream_write(AudxStream *stream, const short *in, unsigned int len);
+
+// Returns the number of samples copied to `out` (at most `len`)
+int audx_stream_read(AudxStream *stream, short *out, unsigned int len);
+
+/* --- Timestamps --- */
+// Writes may carry the capture time of their first sample, in nanoseconds
+// on any clock. Samples written without one continue the timeline of the
+// previous timestamp at the nominal rate (from 0 when none was given).
+// Reads return the presentation timestamp of their first sample: the
+// capture time of the audio it carries, i.e. the timestamp of the input
+// sample at the same position minus audx_session_delay_ns(), however long
+// it was buffered. Nothing is allocated.
+
+int audx_stream_write_ts(AudxStream *stream, const short *in, unsigned int len,
+                         int64_t timestamp_ns);
+
+// `timestamp_ns` is left unchanged when nothing was read
+int audx_stream_read_ts(AudxStream *stream, short *out, unsigned int len,
+                        int64_t *timestamp_ns);
+
+// Capture time of input sample `index`, counted from create, on the
+// timeline above. Timestamps of samples already read may be forgotten, so
+// indices before the last read follow the oldest one still held.
+int64_t audx_stream_input_timestamp(const AudxStream *stream, uint64_t index);
+
+// Processed samples waiting to be read
+unsigned int audx_stream_available(const AudxStream *stream);
+
+// VAD probability of the most recently processed frame
+float audx_stream_vad(const AudxStream *stream);
+
+// Drops buffered input and output; the session keeps its state
+void audx_stream_reset(AudxStream *stream);
+
+// For bypass, prefault and other per-session controls
+AudxSession *audx_stream_session(AudxStream *stream);
+
+void audx_stream_destroy(AudxStream *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_STREAM_H
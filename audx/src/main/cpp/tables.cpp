@@ -0,0 +1,197 @@
+#include "tables.h"
+#include "resampler.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Older libcs (Android before API 30) lack the wrapper and constants
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS 1033
+#define F_GET_SEALS 1034
+#define F_SEAL_SEAL 0x0001
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#define F_SEAL_WRITE 0x0008
+#endif
+
+#define TABLES_REQUIRED_SEALS (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE)
+
+struct AudxTables {
+  int fd;
+  const char *base;
+  size_t bytes;
+  const AudxTablesHeader *header;
+  const AudxTablesEntry *entries;
+};
+
+static size_t align64(size_t bytes) { return (bytes + 63) & ~(size_t)63; }
+
+static int create_memfd(const char *name) {
+#ifdef __NR_memfd_create
+  return (int)syscall(__NR_memfd_create, name,
+                      MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+  (void)name;
+  return -1;
+#endif
+}
+
+// Maps a sealed blob read-only and checks its layout; takes over `fd`
+static AudxTables *map_blob(int fd) {
+  struct stat st;
+  const int seals = fcntl(fd, F_GET_SEALS);
+  if (seals < 0 || (seals & TABLES_REQUIRED_SEALS) != TABLES_REQUIRED_SEALS ||
+      fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(AudxTablesHeader)) {
+    close(fd);
+    return nullptr;
+  }
+
+  const size_t bytes = (size_t)st.st_size;
+  void *base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    close(fd);
+    return nullptr;
+  }
+
+  const auto *header = (const AudxTablesHeader *)base;
+  bool ok = memcmp(header->magic, AUDX_TABLES_MAGIC, sizeof(header->magic)) ==
+                0 &&
+            header->version == AUDX_TABLES_VERSION && header->bytes == bytes &&
+            header->count <= (bytes - sizeof(AudxTablesHeader)) /
+                                 sizeof(AudxTablesEntry);
+  const auto *entries = (const AudxTablesEntry *)(header + 1);
+  for (uint32_t i = 0; ok && i < header->count; i++) {
+    ok = entries[i].offset % 64 == 0 && entries[i].offset <= bytes &&
+         entries[i].floats <= (bytes - entries[i].offset) / sizeof(float);
+  }
+  if (!ok) {
+    munmap(base, bytes);
+    close(fd);
+    return nullptr;
+  }
+
+  auto *tables = (AudxTables *)calloc(1, sizeof(AudxTables));
+  if (!tables) {
+    munmap(base, bytes);
+    close(fd);
+    return nullptr;
+  }
+  tables->fd = fd;
+  tables->base = (const char *)base;
+  tables->bytes = bytes;
+  tables->header = header;
+  tables->entries = entries;
+  return tables;
+}
+
+AudxTables *audx_tables_build(const AudxTableSpec *specs, int count) {
+  if (count < 0 || (count > 0 && !specs))
+    return nullptr;
+
+  // Lay out the header, the entries and one aligned bank per spec
+  AudxTablesEntry *entries =
+      (AudxTablesEntry *)calloc(count ? count : 1, sizeof(AudxTablesEntry));
+  if (!entries)
+    return nullptr;
+  size_t bytes = align64(sizeof(AudxTablesHeader) +
+                         sizeof(AudxTablesEntry) * (size_t)count);
+  for (int i = 0; i < count; i++) {
+    const AudxTableSpec &spec = specs[i];
+    const size_t floats = audx_resampler_bank(
+        spec.in_rate, spec.out_rate, spec.quality, spec.bandwidth, nullptr);
+    if (floats == 0) {
+      free(entries);
+      return nullptr;
+    }
+    entries[i].spec = spec;
+    entries[i].offset = bytes;
+    entries[i].floats = floats;
+    bytes += align64(sizeof(float) * floats);
+  }
+
+  const int fd = create_memfd("audx-tables");
+  if (fd < 0 || ftruncate(fd, (off_t)bytes) != 0) {
+    if (fd >= 0)
+      close(fd);
+    free(entries);
+    return nullptr;
+  }
+
+  void *base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    close(fd);
+    free(entries);
+    return nullptr;
+  }
+  auto *header = (AudxTablesHeader *)base;
+  memcpy(header->magic, AUDX_TABLES_MAGIC, sizeof(header->magic));
+  header->version = AUDX_TABLES_VERSION;
+  header->count = (uint32_t)count;
+  header->bytes = bytes;
+  memcpy(header + 1, entries, sizeof(AudxTablesEntry) * (size_t)count);
+  for (int i = 0; i < count; i++) {
+    const AudxTableSpec &spec = specs[i];
+    audx_resampler_bank(spec.in_rate, spec.out_rate, spec.quality,
+                        spec.bandwidth,
+                        (float *)((char *)base + entries[i].offset));
+  }
+  free(entries);
+
+  // F_SEAL_WRITE requires that no writable mapping remains
+  munmap(base, bytes);
+  if (fcntl(fd, F_ADD_SEALS, TABLES_REQUIRED_SEALS | F_SEAL_SEAL) != 0) {
+    close(fd);
+    return nullptr;
+  }
+  return map_blob(fd);
+}
+
+AudxTables *audx_tables_map(int fd) {
+  const int own = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (own < 0)
+    return nullptr;
+  return map_blob(own);
+}
+
+int audx_tables_fd(const AudxTables *tables) { return tables->fd; }
+
+size_t audx_tables_bytes(const AudxTables *tables) { return tables->bytes; }
+
+const float *audx_tables_find(const AudxTables *tables,
+                              const AudxTableSpec *spec) {
+  if (!tables || !spec)
+    return nullptr;
+  for (uint32_t i = 0; i < tables->header->count; i++) {
+    const AudxTableSpec &entry = tables->entries[i].spec;
+    if (entry.in_rate == spec->in_rate && entry.out_rate == spec->out_rate &&
+        entry.quality == spec->quality && entry.bandwidth == spec->bandwidth) {
+      // The bank must have the size this build would give it
+      const size_t floats =
+          audx_resampler_bank(spec->in_rate, spec->out_rate, spec->quality,
+                              spec->bandwidth, nullptr);
+      if (floats != tables->entries[i].floats)
+        return nullptr;
+      return (const float *)(tables->base + tables->entries[i].offset);
+    }
+  }
+  return nullptr;
+}
+
+void audx_tables_destroy(AudxTables *tables) {
+  if (!tables)
+    return;
+  munmap((void *)tables->base, tables->bytes);
+  close(tables->fd);
+  free(tables);
+}
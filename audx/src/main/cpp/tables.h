@@ -0,0 +1,76 @@
+#ifndef AUDX_TABLES_H
+#define AUDX_TABLES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Shared tables --- */
+// The immutable filter banks of the wrapper's resamplers, built once into a
+// sealed memfd. Other processes receive the file descriptor (fork, binder
+// ParcelFileDescriptor, SCM_RIGHTS) and map it read-only, so every process
+// reads the same physical pages instead of building private copies.
+// Sessions pick their banks from the tables through
+// AudxSessionConfig.tables.
+//
+// The core's model weights are file-backed read-only data of
+// libaudx_src.so and are shared through the page cache already.
+
+typedef struct AudxTables AudxTables;
+
+typedef struct AudxTableSpec {
+  unsigned int in_rate;
+  unsigned int out_rate;
+  int quality;
+  unsigned int bandwidth;
+} AudxTableSpec;
+
+// Blob layout, host byte order:
+//   AudxTablesHeader
+//   AudxTablesEntry entries[count]
+//   banks, each 64-byte aligned
+#define AUDX_TABLES_MAGIC "AUDXTBLS"
+#define AUDX_TABLES_VERSION 2 // 2: halfband banks for power-of-two ratios
+
+typedef struct AudxTablesHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t count;
+  uint64_t bytes;
+} AudxTablesHeader;
+
+typedef struct AudxTablesEntry {
+  AudxTableSpec spec;
+  uint64_t offset; // of the bank from the start of the blob
+  uint64_t floats;
+} AudxTablesEntry;
+
+// Builds the banks for `specs` into a new memfd, seals it against writes
+// and resizing, and maps it read-only. Returns NULL when memfd or sealing
+// is unavailable.
+AudxTables *audx_tables_build(const AudxTableSpec *specs, int count);
+
+// Maps tables received from another process. Only sealed blobs are
+// accepted. `fd` is duplicated and may be closed afterwards.
+AudxTables *audx_tables_map(int fd);
+
+// Descriptor to pass to other processes; owned by the tables
+int audx_tables_fd(const AudxTables *tables);
+
+size_t audx_tables_bytes(const AudxTables *tables);
+
+// Bank for a configuration, or NULL when the tables do not contain it
+const float *audx_tables_find(const AudxTables *tables,
+                              const AudxTableSpec *spec);
+
+// Unmaps the blob; sessions and resamplers using it must be destroyed first
+void audx_tables_destroy(AudxTables *tables);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_TABLES_H
@@ -0,0 +1,2230 @@
+// Host micro-benchmarks for the wrapper layer.
+//
+// Usage: audx_bench [case ...]   (no arguments runs every case)
+
+#include "arena.h"
+#include "audx.hpp"
+#include "dtx.h"
+#include "bench_util.h"
+#include "engine.h"
+#include "events.h"
+#include "monitor.h"
+#include "numa.h"
+#include "offline.h"
+#include "params.h"
+#include "resampler.h"
+#include "session.h"
+#include "speaker.h"
+#include "stream.h"
+#include "tables.h"
+#include "vmath.h"
+
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+
+static const int BENCH_SECONDS = 20;
+
+/* --- bypass --- */
+// ns/frame in active mode and in bypass at several warm intervals, plus the
+// largest sample step across a bypass -> active switch.
+
+static AudxSession *bench_session(unsigned int rate, int warm_interval,
+                                  unsigned int bandwidth) {
+  AudxSessionConfig config;
+  audx_session_config_default(&config);
+  config.in_rate = rate;
+  config.warm_interval = warm_interval;
+  config.bandwidth = bandwidth;
+  return audx_session_create(&config);
+}
+
+// ns/frame of a session over `input`, which is consumed in 10ms frames
+static double session_ns_per_frame(AudxSession *session,
+                                   const std::vector<short> &input) {
+  const int n = audx_session_frame_samples(session);
+  std::vector<short> in(n), out(n);
+  const int frames = (int)input.size() / n;
+  const int64_t start = bench_now_ns();
+  for (int f = 0; f < frames; f++) {
+    memcpy(in.data(), &input[(size_t)f * n], n * sizeof(short));
+    audx_session_process_int(session, in.data(), out.data());
+  }
+  return (double)(bench_now_ns() - start) / frames;
+}
+
+static double bypass_run(unsigned int rate, int warm_interval, int bypass,
+                         const std::vector<short> &input) {
+  AudxSession *session = bench_session(rate, warm_interval, 0);
+  if (!session)
+    return -1.0;
+  audx_session_set_bypass(session, bypass);
+  const double ns = session_ns_per_frame(session, input);
+  audx_session_destroy(session);
+  return ns;
+}
+
+static int bypass_max_switch_step(unsigned int rate,
+                                  const std::vector<short> &input) {
+  AudxSession *session = bench_session(rate, 2, 0);
+  const int n = audx_session_frame_samples(session);
+  std::vector<short> in(n), out(n);
+  short prev = 0;
+  int max_step = 0;
+
+  const int frames = (int)input.size() / n;
+  for (int f = 0; f < frames; f++) {
+    // Toggle every 50 frames (0.5s)
+    audx_session_set_bypass(session, (f / 50) % 2);
+    memcpy(in.data(), &input[(size_t)f * n], n * sizeof(short));
+    audx_session_process_int(session, in.data(), out.data());
+    if (f % 50 == 0 && f > 0)
+      max_step = std::max(max_step, std::abs(out[0] - prev));
+    prev = out[n - 1];
+  }
+
+  audx_session_destroy(session);
+  return max_step;
+}
+
+static void bench_bypass() {
+  const unsigned int rates[] = {16000, 48000};
+  for (unsigned int rate : rates) {
+    const auto clean = bench_clean_speech(rate, rate * BENCH_SECONDS);
+    const auto input = bench_to_int16(bench_add_noise(clean, 10.0f));
+
+    printf("bypass rate=%u active        %9.0f ns/frame\n", rate,
+           bypass_run(rate, 1, 0, input));
+    const int intervals[] = {1, 2, 4, 0};
+    for (int interval : intervals)
+      printf("bypass rate=%u warm_interval=%d %9.0f ns/frame\n", rate, interval,
+             bypass_run(rate, interval, 1, input));
+    printf("bypass rate=%u max switch step %d\n", rate,
+           bypass_max_switch_step(rate, input));
+  }
+}
+
+/* --- resampler --- */
+// Polyphase resampler at several qualities against two common alternatives:
+// linear interpolation and a direct-form windowed sinc that evaluates its
+// kernel per output. Reports ns per 10ms of input and the SNR of a 997 Hz
+// tone after conversion (least-squares fit, so filter delay doesn't count).
+
+typedef void (*ResampleFn)(void *ctx, const float *in, int in_len,
+                           std::vector<float> &out);
+
+static void linear_resample(void *ctx, const float *in, int in_len,
+                            std::vector<float> &out) {
+  const double step = *(double *)ctx;
+  out.clear();
+  for (double t = 0.0; t < in_len - 1; t += step) {
+    const int i = (int)t;
+    const float f = (float)(t - i);
+    out.push_back(in[i] + (in[i + 1] - in[i]) * f);
+  }
+}
+
+static void naive_sinc_resample(void *ctx, const float *in, int in_len,
+                                std::vector<float> &out) {
+  const double step = *(double *)ctx;
+  const int half = 16;
+  const double cutoff = std::min(1.0, 1.0 / step) * 0.91;
+  out.clear();
+  for (double t = half; t < in_len - half; t += step) {
+    const int c = (int)t;
+    double acc = 0.0;
+    for (int k = c - half + 1; k <= c + half; k++) {
+      const double x = t - k;
+      const double w = 0.5 + 0.5 * cos(M_PI * x / half);
+      const double a = M_PI * cutoff * x;
+      acc += in[k] * (fabs(x) < 1e-9 ? cutoff : cutoff * sin(a) / a) * w;
+    }
+    out.push_back((float)acc);
+  }
+}
+
+static void audx_resample(void *ctx, const float *in, int in_len,
+                          std::vector<float> &out) {
+  auto *r = (AudxResampler *)ctx;
+  out.resize(audx_resampler_max_output(r, in_len));
+  unsigned int il = in_len, ol = (unsigned int)out.size();
+  audx_resampler_process_float(r, in, &il, out.data(), &ol);
+  out.resize(ol);
+}
+
+static double tone_snr_db(const std::vector<float> &y, unsigned int rate,
+                          double freq) {
+  // Skip the filter warm-up, fit a*sin + b*cos and measure the residual
+  const size_t start = std::min<size_t>(y.size(), rate / 10);
+  double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+  for (size_t i = start; i < y.size(); i++) {
+    const double w = 2.0 * M_PI * freq * i / rate;
+    const double s = sin(w), c = cos(w);
+    ss += s * s, sc += s * c, cc += c * c, ys += y[i] * s, yc += y[i] * c;
+  }
+  const double det = ss * cc - sc * sc;
+  const double a = (ys * cc - yc * sc) / det, b = (yc * ss - ys * sc) / det;
+  double sig = 0, err = 0;
+  for (size_t i = start; i < y.size(); i++) {
+    const double w = 2.0 * M_PI * freq * i / rate;
+    const double fit = a * sin(w) + b * cos(w);
+    sig += fit * fit;
+    err += (y[i] - fit) * (y[i] - fit);
+  }
+  return 10.0 * log10(sig / std::max(err, 1e-20));
+}
+
+static void resampler_report(const char *name, unsigned int in_rate,
+                             unsigned int out_rate, ResampleFn fn, void *ctx) {
+  const int block = in_rate / 100;
+  const int blocks = BENCH_SECONDS * 100;
+  std::vector<float> tone((size_t)block * blocks), out, all;
+  for (size_t i = 0; i < tone.size(); i++)
+    tone[i] = (float)(10000.0 * sin(2.0 * M_PI * 997.0 * i / in_rate));
+
+  int64_t elapsed = 0;
+  for (int b = 0; b < blocks; b++) {
+    const int64_t start = bench_now_ns();
+    fn(ctx, &tone[(size_t)b * block], block, out);
+    elapsed += bench_now_ns() - start;
+    all.insert(all.end(), out.begin(), out.end());
+  }
+  printf("resampler %5u->%-5u %-14s %8.0f ns/10ms  snr %6.1f dB\n", in_rate,
+         out_rate, name, (double)elapsed / blocks,
+         tone_snr_db(all, out_rate, 997.0));
+}
+
+// The linear and naive references are stateless per block, so they run
+// over the whole signal at once to keep block edges out of their SNR
+static void resampler_report_whole(const char *name, unsigned int in_rate,
+                                   unsigned int out_rate, ResampleFn fn,
+                                   void *ctx) {
+  const size_t len = (size_t)in_rate * BENCH_SECONDS;
+  std::vector<float> tone(len), out;
+  for (size_t i = 0; i < len; i++)
+    tone[i] = (float)(10000.0 * sin(2.0 * M_PI * 997.0 * i / in_rate));
+
+  const int64_t start = bench_now_ns();
+  fn(ctx, tone.data(), (int)len, out);
+  const int64_t elapsed = bench_now_ns() - start;
+  printf("resampler %5u->%-5u %-14s %8.0f ns/10ms  snr %6.1f dB\n", in_rate,
+         out_rate, name, (double)elapsed / (BENCH_SECONDS * 100),
+         tone_snr_db(out, out_rate, 997.0));
+}
+
+static void bench_resampler() {
+  const unsigned int pairs[][2] = {
+      {44100, 48000}, {48000, 16000}, {16000, 48000}, {8000, 48000}};
+  for (const auto &pair : pairs) {
+    double step = (double)pair[0] / pair[1];
+    resampler_report_whole("linear", pair[0], pair[1], linear_resample, &step);
+    resampler_report_whole("naive-sinc32", pair[0], pair[1],
+                           naive_sinc_resample, &step);
+    const int qualities[] = {0, 3, 4, 7, 10};
+    for (int q : qualities) {
+      char name[32];
+      snprintf(name, sizeof(name), "audx-q%d", q);
+      AudxResampler *r = audx_resampler_create(pair[0], pair[1], q);
+      resampler_report(name, pair[0], pair[1], audx_resample, r);
+      audx_resampler_destroy(r);
+    }
+  }
+}
+
+/* --- halfband --- */
+// 96, 192 and 384 kHz against the 48 kHz core: the polyphase bank against
+// the halfband cascade picked for these ratios, at several qualities.
+// Reports ns per 10ms of input, the SNR of a 997 Hz tone and the level of
+// what a tone outside the output band leaves behind, relative to the tone:
+// decimating, a tone 6 kHz above 24 kHz folded to 18 kHz; interpolating,
+// the image of the 997 Hz tone above 24 kHz.
+
+static double tone_level_db(const std::vector<float> &y, unsigned int rate,
+                            double freq, double amplitude) {
+  const size_t start = std::min<size_t>(y.size(), rate / 10);
+  double s = 0, c = 0;
+  for (size_t i = start; i < y.size(); i++) {
+    const double w = 2.0 * M_PI * freq * i / rate;
+    s += y[i] * sin(w), c += y[i] * cos(w);
+  }
+  const double n = (double)(y.size() - start);
+  return 20.0 * log10(std::max(2.0 * sqrt(s * s + c * c) / n, 1e-9) /
+                      amplitude);
+}
+
+static void halfband_report(const char *name, AudxResampler *r,
+                            unsigned int in_rate, unsigned int out_rate) {
+  const size_t len = (size_t)in_rate * BENCH_SECONDS;
+  const bool down = in_rate > out_rate;
+  const double stray = down ? out_rate / 2 + 6000.0 : 0.0;
+  std::vector<float> tone(len), probe(len);
+  for (size_t i = 0; i < len; i++) {
+    tone[i] = (float)(10000.0 * sin(2.0 * M_PI * 997.0 * i / in_rate));
+    probe[i] = down ? (float)(10000.0 * sin(2.0 * M_PI * stray * i / in_rate))
+                    : tone[i];
+  }
+
+  // Best of a few passes, the first also faults everything in
+  const int block = in_rate / 100;
+  std::vector<float> out, all;
+  int64_t elapsed = INT64_MAX;
+  for (int pass = 0; pass < 3; pass++) {
+    audx_resampler_reset(r);
+    all.clear();
+    int64_t total = 0;
+    for (size_t b = 0; b + block <= len; b += block) {
+      const int64_t start = bench_now_ns();
+      audx_resample(r, &tone[b], block, out);
+      total += bench_now_ns() - start;
+      all.insert(all.end(), out.begin(), out.end());
+    }
+    elapsed = std::min(elapsed, total);
+  }
+  const double snr = tone_snr_db(all, out_rate, 997.0);
+
+  audx_resampler_reset(r);
+  audx_resample(r, probe.data(), (int)len, all);
+  const double leak =
+      tone_level_db(all, out_rate, down ? out_rate - stray : in_rate - 997.0,
+                    10000.0);
+  printf("halfband %6u->%-6u %-14s %8.0f ns/10ms  snr %6.1f dB  %s %6.1f dB\n",
+         in_rate, out_rate, name, (double)elapsed / (len / block), snr,
+         down ? "alias" : "image", leak);
+}
+
+static void bench_halfband() {
+  const unsigned int pairs[][2] = {{96000, 48000},  {48000, 96000},
+                                   {192000, 48000}, {48000, 192000},
+                                   {384000, 48000}, {48000, 384000}};
+  for (const auto &pair : pairs) {
+    for (int q : {0, 3, 4, 7, 10}) {
+      char name[32];
+      AudxResampler *poly =
+          audx_resampler_create_polyphase(pair[0], pair[1], q, 0);
+      snprintf(name, sizeof(name), "polyphase-q%d", q);
+      halfband_report(name, poly, pair[0], pair[1]);
+      audx_resampler_destroy(poly);
+
+      AudxResampler *half = audx_resampler_create(pair[0], pair[1], q);
+      snprintf(name, sizeof(name), "halfband-q%d", q);
+      halfband_report(name, half, pair[0], pair[1]);
+      audx_resampler_destroy(half);
+    }
+  }
+}
+
+/* --- bandwidth --- */
+// Narrowband content at 8 and 16 kHz: session cost with the core's own
+// full-band resampling against a bandwidth hint, and the up+down
+// resampling cost per frame on its own.
+
+static double resample_pair_ns(unsigned int rate, unsigned int bandwidth,
+                               const std::vector<short> &input) {
+  AudxResampler *up = audx_resampler_create_band(rate, FRAME_RATE, 4, bandwidth);
+  AudxResampler *down =
+      audx_resampler_create_band(FRAME_RATE, rate, 4, bandwidth);
+  const int n = rate / 100;
+  std::vector<float> in(n), mid(FRAME_SIZE), out(n);
+  const int frames = (int)input.size() / n;
+  const int64_t start = bench_now_ns();
+  for (int f = 0; f < frames; f++) {
+    for (int i = 0; i < n; i++)
+      in[i] = input[(size_t)f * n + i];
+    unsigned int il = n, ol = FRAME_SIZE;
+    audx_resampler_process_float(up, in.data(), &il, mid.data(), &ol);
+    il = FRAME_SIZE, ol = n;
+    audx_resampler_process_float(down, mid.data(), &il, out.data(), &ol);
+  }
+  const int64_t elapsed = bench_now_ns() - start;
+  audx_resampler_destroy(up);
+  audx_resampler_destroy(down);
+  return (double)elapsed / frames;
+}
+
+static void bench_bandwidth() {
+  const unsigned int rates[] = {8000, 16000};
+  const unsigned int hints[] = {0, 7000, 3400};
+  for (unsigned int rate : rates) {
+    // bench_clean_speech caps its harmonics at 4 kHz
+    const auto clean = bench_clean_speech(rate, rate * BENCH_SECONDS);
+    const auto input = bench_to_int16(bench_add_noise(clean, 20.0f));
+    for (unsigned int hint : hints) {
+      if (hint >= rate / 2)
+        continue;
+      AudxSession *session = bench_session(rate, 2, hint);
+      printf("bandwidth rate=%-5u hint=%-4u session %9.0f ns/frame  "
+             "resample up+down %7.0f ns/frame\n",
+             rate, hint, session_ns_per_frame(session, input),
+             resample_pair_ns(rate, hint, input));
+      audx_session_destroy(session);
+    }
+  }
+}
+
+/* --- scratch --- */
+// 1000 streams processed round-robin on one thread, once with one workspace
+// per stream (the layout before the state/scratch split) and once with the
+// thread's shared workspace. Reports per-stream bytes and, where perf
+// events are available, cache misses per frame.
+
+static void scratch_run(const char *label, std::vector<AudxSession *> &sessions,
+                        std::vector<AudxScratch *> &scratches,
+                        const std::vector<short> &input) {
+  const int n = audx_session_frame_samples(sessions[0]);
+  std::vector<short> out(n);
+  const int rounds = 20;
+  BenchPerfCounter misses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+  misses.start();
+  const int64_t start = bench_now_ns();
+  for (int r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < sessions.size(); i++) {
+      short *in = const_cast<short *>(&input[(size_t)((r * 7 + i) % 100) * n]);
+      audx_session_process_int_ws(sessions[i], scratches[i], in, out.data());
+    }
+  }
+  const int64_t elapsed = bench_now_ns() - start;
+  const uint64_t miss_count = misses.stop();
+
+  const double frames = (double)rounds * sessions.size();
+  if (misses.valid())
+    printf("scratch %-10s %9.0f ns/frame %9.1f cache-misses/frame\n", label,
+           elapsed / frames, miss_count / frames);
+  else
+    printf("scratch %-10s %9.0f ns/frame  cache-misses n/a\n", label,
+           elapsed / frames);
+}
+
+static void bench_scratch() {
+  const unsigned int rate = 16000;
+  const int streams = 1000;
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(rate, rate), 10.0f));
+
+  std::vector<AudxSession *> sessions;
+  for (int i = 0; i < streams; i++)
+    sessions.push_back(bench_session(rate, 2, 7000));
+
+  std::vector<AudxScratch *> own, shared(streams, audx_scratch_thread_local());
+  size_t scratch_bytes = 0;
+  for (AudxSession *session : sessions) {
+    AudxScratch *scratch = audx_scratch_create();
+    audx_session_scratch_reserve(session, scratch);
+    scratch_bytes = audx_scratch_bytes(scratch);
+    own.push_back(scratch);
+  }
+
+  const size_t state_bytes = audx_session_state_bytes(sessions[0]);
+  printf("scratch per-stream bytes: per-stream workspace %zu, shared %zu "
+         "(+%zu per thread)\n",
+         state_bytes + scratch_bytes, state_bytes, scratch_bytes);
+
+  scratch_run("per-stream", sessions, own, input);
+  scratch_run("shared", sessions, shared, input);
+
+  for (AudxScratch *scratch : own)
+    audx_scratch_destroy(scratch);
+  for (AudxSession *session : sessions)
+    audx_session_destroy(session);
+}
+
+/* --- prefault --- */
+// First-frame latency after create, and p99.9 frame latency right after
+// "idle" periods, emulated by asking the kernel to reclaim the core
+// library's pages (MADV_PAGEOUT, ignored for locked pages).
+
+static void pageout_range(const void *addr, size_t len, int, void *) {
+  const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+  const uintptr_t start = (uintptr_t)addr & ~(page - 1);
+  madvise((void *)start, (uintptr_t)addr + len - start, MADV_PAGEOUT);
+}
+
+static AudxSession *prefault_session(unsigned int rate, int flags) {
+  AudxSessionConfig config;
+  audx_session_config_default(&config);
+  config.in_rate = rate;
+  config.bandwidth = 7000;
+  config.memory_flags = flags;
+  return audx_session_create(&config);
+}
+
+static void bench_prefault() {
+  const unsigned int rate = 16000;
+  const int n = rate / 100;
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(rate, rate), 10.0f));
+  std::vector<short> out(n);
+
+  struct Mode {
+    const char *name;
+    int flags;
+    bool reprefault; // call audx_session_prefault() after idle
+  };
+  const Mode modes[] = {
+      {"none", 0, false},
+      {"prefault", AUDX_MEMORY_PREFAULT, true},
+      {"prefault+lock", AUDX_MEMORY_PREFAULT | AUDX_MEMORY_LOCK, false},
+  };
+
+  for (const Mode &mode : modes) {
+    std::vector<int64_t> first, after_idle;
+    int status = 0;
+    for (int trial = 0; trial < 50; trial++) {
+      audx_mem_core_segments(pageout_range, nullptr);
+      AudxSession *session = prefault_session(rate, mode.flags);
+      status = audx_session_memory_status(session);
+      short *in = const_cast<short *>(input.data());
+      const int64_t start = bench_now_ns();
+      audx_session_process_int(session, in, out.data());
+      first.push_back(bench_now_ns() - start);
+      audx_session_destroy(session);
+    }
+
+    AudxSession *session = prefault_session(rate, mode.flags);
+    for (int cycle = 0; cycle < 200; cycle++) {
+      audx_mem_core_segments(pageout_range, nullptr);
+      if (mode.reprefault)
+        audx_session_prefault(session);
+      for (int f = 0; f < 10; f++) {
+        short *in = const_cast<short *>(&input[(size_t)((cycle + f) % 100) * n]);
+        const int64_t start = bench_now_ns();
+        audx_session_process_int(session, in, out.data());
+        after_idle.push_back(bench_now_ns() - start);
+      }
+    }
+    audx_session_destroy(session);
+
+    printf("prefault %-14s status=%d first-frame p50 %8.0f ns max %8.0f ns  "
+           "post-idle p99.9 %8.0f ns\n",
+           mode.name, status, bench_percentile(first, 50.0),
+           bench_percentile(first, 100.0), bench_percentile(after_idle, 99.9));
+  }
+}
+
+/* --- cpp --- */
+// Per-frame cost of the C++ layer against the C calls it wraps (best of
+// several interleaved runs), and throughput of Executor against processing
+// the same streams on the calling thread.
+
+static double cpp_c_run(AudxSession *session, const std::vector<short> &input,
+                        std::vector<short> &out) {
+  const int n = audx_session_frame_samples(session);
+  const int frames = (int)input.size() / n;
+  const int64_t start = bench_now_ns();
+  for (int f = 0; f < frames; f++)
+    audx_session_process_int(session,
+                             const_cast<short *>(&input[(size_t)f * n]),
+                             out.data());
+  return (double)(bench_now_ns() - start) / frames;
+}
+
+static double cpp_span_run(audx::Session &session,
+                           const std::vector<short> &input,
+                           std::vector<short> &out) {
+  const size_t n = session.frame_samples();
+  const std::span<const int16_t> all(input);
+  const size_t frames = input.size() / n;
+  const int64_t start = bench_now_ns();
+  for (size_t f = 0; f < frames; f++)
+    session.process(all.subspan(f * n, n), out);
+  return (double)(bench_now_ns() - start) / frames;
+}
+
+static void bench_cpp() {
+  for (unsigned int rate : {48000u, 16000u}) {
+    const auto input = bench_to_int16(
+        bench_add_noise(bench_clean_speech(rate, rate * BENCH_SECONDS), 10.0f));
+    audx::SessionConfig config;
+    config.in_rate = rate;
+    AudxSession *c_session = audx_session_create(&config);
+    audx::Session session(config);
+    std::vector<short> out(session.frame_samples());
+
+    double c_best = 1e30, cpp_best = 1e30;
+    for (int run = 0; run < 5; run++) {
+      c_best = std::min(c_best, cpp_c_run(c_session, input, out));
+      cpp_best = std::min(cpp_best, cpp_span_run(session, input, out));
+    }
+    audx_session_destroy(c_session);
+    printf("cpp %5u Hz  C %8.1f ns/frame  C++ %8.1f ns/frame  (%+.2f%%)\n",
+           rate, c_best, cpp_best, 100.0 * (cpp_best - c_best) / c_best);
+  }
+
+  const unsigned int rate = 16000;
+  const int streams = 64, rounds = 50;
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(rate, rate), 10.0f));
+  audx::SessionConfig config;
+  config.in_rate = rate;
+  std::vector<audx::Session> sessions;
+  for (int i = 0; i < streams; i++)
+    sessions.emplace_back(config);
+  const size_t n = sessions[0].frame_samples();
+  const std::span<const int16_t> all(input);
+  std::vector<short> out(streams * n);
+
+  int64_t start = bench_now_ns();
+  for (int r = 0; r < rounds; r++)
+    for (int i = 0; i < streams; i++)
+      sessions[i].process(all.subspan(((r + i) % 100) * n, n),
+                          std::span<int16_t>(out).subspan(i * n, n));
+  const double inline_ns = (double)(bench_now_ns() - start) / (rounds * streams);
+
+  audx::Executor executor;
+  std::vector<std::future<float>> pending(streams);
+  start = bench_now_ns();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < streams; i++)
+      pending[i] = executor.submit(sessions[i],
+                                   all.subspan(((r + i) % 100) * n, n),
+                                   std::span<int16_t>(out).subspan(i * n, n));
+    for (auto &p : pending)
+      p.get();
+  }
+  const double async_ns = (double)(bench_now_ns() - start) / (rounds * streams);
+
+  printf("cpp executor %zu threads, %d streams: inline %8.0f ns/frame, "
+         "async %8.0f ns/frame\n",
+         executor.threads(), streams, inline_ns, async_ns);
+}
+
+/* --- edf --- */
+// Many streams on the engine at 50-150% of its capacity, each submitting
+// one frame per 10ms tick with the tick's end as deadline. Background
+// frames are submitted first. Reports per-class deadline misses for FIFO
+// and for EDF with late policies (realtime/normal degrade, background drops).
+
+struct EdfLoad {
+  int streams[AUDX_PRIORITY_CLASSES];
+};
+
+static void edf_run(int scheduling, const EdfLoad &load,
+                    const std::vector<short> &input, int ticks) {
+  AudxEngineConfig config;
+  audx_engine_config_default(&config);
+  config.scheduling = scheduling;
+  config.queue_frames = 2;
+  AudxEngine *engine = audx_engine_create(&config);
+
+  const AudxLatePolicy policies[AUDX_PRIORITY_CLASSES] = {
+      AUDX_LATE_DEGRADE, AUDX_LATE_DEGRADE, AUDX_LATE_DROP};
+  std::vector<AudxSession *> sessions;
+  std::vector<int> ids;
+  // Background first, so FIFO queues it ahead of the realtime streams
+  for (int c = AUDX_PRIORITY_CLASSES - 1; c >= 0; c--) {
+    for (int i = 0; i < load.streams[c]; i++) {
+      AudxSession *session = bench_session(16000, 2, 0);
+      sessions.push_back(session);
+      ids.push_back(audx_engine_add_stream(
+          engine, session, (AudxPriority)c,
+          scheduling == AUDX_SCHED_EDF ? policies[c] : AUDX_LATE_PROCESS));
+    }
+  }
+
+  const int n = audx_session_frame_samples(sessions[0]);
+  std::vector<short> out(sessions.size() * 2 * n);
+  uint64_t rejected = 0;
+  int64_t tick = audx_engine_now_ns();
+  for (int t = 0; t < ticks; t++) {
+    const int64_t deadline = tick + 10000000;
+    for (size_t i = 0; i < sessions.size(); i++) {
+      const short *in = &input[(size_t)((t + i) % 100) * n];
+      short *dst = &out[(i * 2 + t % 2) * n];
+      if (audx_engine_submit(engine, ids[i], in, dst, deadline, nullptr,
+                             nullptr) != 0)
+        rejected++;
+    }
+    tick = deadline;
+    while (audx_engine_now_ns() < tick)
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  audx_engine_drain(engine);
+
+  AudxEngineStats stats;
+  audx_engine_stats(engine, &stats);
+  static const char *const names[] = {"realtime", "normal", "background"};
+  for (int c = 0; c < AUDX_PRIORITY_CLASSES; c++) {
+    const AudxEngineClassStats &s = stats.priority[c];
+    const double total = s.submitted ? (double)s.submitted : 1.0;
+    printf("edf   %-4s %-10s late %6.2f%%  dropped %6.2f%%  degraded %6.2f%%\n",
+           scheduling == AUDX_SCHED_EDF ? "edf" : "fifo", names[c],
+           100.0 * s.late / total, 100.0 * s.dropped / total,
+           100.0 * s.degraded / total);
+  }
+  if (rejected)
+    printf("edf   %-4s %llu frames rejected (stream queue full)\n",
+           scheduling == AUDX_SCHED_EDF ? "edf" : "fifo",
+           (unsigned long long)rejected);
+
+  audx_engine_destroy(engine);
+  for (AudxSession *session : sessions)
+    audx_session_destroy(session);
+}
+
+static void bench_edf() {
+  const unsigned int rate = 16000;
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(rate, rate), 10.0f));
+
+  AudxSession *probe = bench_session(rate, 2, 0);
+  const double cost = session_ns_per_frame(probe, input);
+  audx_session_destroy(probe);
+
+  AudxEngineConfig config;
+  audx_engine_config_default(&config);
+  const double capacity = config.threads * 10e6 / cost; // frames per tick
+
+  for (double load : {0.5, 1.0, 1.5}) {
+    const int total = (int)(load * capacity);
+    EdfLoad streams = {{total / 20, total * 3 / 20, 0}};
+    streams.streams[AUDX_PRIORITY_BACKGROUND] =
+        total - streams.streams[0] - streams.streams[1];
+    printf("edf load %.0f%%: %d realtime, %d normal, %d background streams on "
+           "%d threads\n",
+           load * 100, streams.streams[0], streams.streams[1],
+           streams.streams[2], config.threads);
+    edf_run(AUDX_SCHED_FIFO, streams, input, 100);
+    edf_run(AUDX_SCHED_EDF, streams, input, 100);
+  }
+}
+
+/* --- affinity --- */
+// 256 streams spread over the workers. Streams are homed round-robin, and
+// half of worker 0's streams use a much more expensive configuration, so
+// home workers start out unevenly loaded. Each round
+// submits one frame per stream and waits for all of them. Reports
+// throughput, cache misses per frame (worker threads included) and how
+// often a stream ran on a different worker than its previous frame.
+
+static void affinity_run(const char *label, int affinity, int pin,
+                         const std::vector<short> &input) {
+  AudxEngineConfig config;
+  audx_engine_config_default(&config);
+  config.affinity = affinity;
+  config.pin_workers = pin;
+  const int streams = 256, rounds = 100;
+
+  BenchPerfCounter misses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,
+                          true);
+  misses.start();
+  AudxEngine *engine = audx_engine_create(&config);
+
+  std::vector<AudxSession *> sessions;
+  std::vector<int> ids;
+  for (int i = 0; i < streams; i++) {
+    const bool heavy = i % config.threads == 0 && i < streams / 2;
+    AudxSessionConfig session_config;
+    audx_session_config_default(&session_config);
+    session_config.in_rate = heavy ? 16000 : 48000;
+    session_config.bandwidth = heavy ? 7000 : 0;
+    session_config.resample_quality = heavy ? AUDX_RESAMPLER_QUALITY_MAX : 4;
+    sessions.push_back(audx_session_create(&session_config));
+    ids.push_back(audx_engine_add_stream(engine, sessions.back(),
+                                         AUDX_PRIORITY_NORMAL,
+                                         AUDX_LATE_PROCESS));
+  }
+
+  std::vector<short> out((size_t)streams * FRAME_SIZE);
+  const int64_t start = bench_now_ns();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < streams; i++)
+      audx_engine_submit(engine, ids[i], &input[(size_t)((r + i) % 100) * FRAME_SIZE],
+                         &out[(size_t)i * FRAME_SIZE], INT64_MAX, nullptr,
+                         nullptr);
+    audx_engine_drain(engine);
+  }
+  const int64_t elapsed = bench_now_ns() - start;
+
+  AudxEngineStats stats;
+  audx_engine_stats(engine, &stats);
+  audx_engine_destroy(engine); // joins workers so their counts are folded in
+  const uint64_t miss_count = misses.stop();
+  for (AudxSession *session : sessions)
+    audx_session_destroy(session);
+
+  const double frames = (double)streams * rounds;
+  printf("affinity %-12s %2d threads %9.0f frames/s  migrations %5.1f%%  "
+         "rebalanced %3llu",
+         label, config.threads, frames * 1e9 / elapsed,
+         100.0 * stats.migrations / frames,
+         (unsigned long long)stats.rebalanced);
+  if (misses.valid())
+    printf("  %8.1f cache-misses/frame\n", miss_count / frames);
+  else
+    printf("  cache-misses n/a\n");
+}
+
+static void bench_affinity() {
+  // 48kHz frames; the 16kHz streams read a prefix of each
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(FRAME_RATE, FRAME_RATE), 10.0f));
+
+  affinity_run("shared", AUDX_AFFINITY_SHARED, 0, input);
+  affinity_run("steal", AUDX_AFFINITY_STEAL, 0, input);
+  affinity_run("home", AUDX_AFFINITY_HOME, 0, input);
+  affinity_run("home+pinned", AUDX_AFFINITY_HOME, 1, input);
+}
+
+/* --- fused --- */
+// Resampling around the core with separate int16 <-> float passes against
+// the fused entry points, with an identity in place of the core (best of
+// several interleaved runs). Reports ns/frame, the buffer traffic removed
+// and the largest output difference.
+
+struct FusedPair {
+  AudxResampler *up;
+  AudxResampler *down;
+};
+
+static double fused_run(FusedPair pair, bool fused, unsigned int rate,
+                        const std::vector<short> &input,
+                        std::vector<short> &output) {
+  const int n = rate / 100;
+  const int frames = (int)input.size() / n;
+  AudxScratch *scratch = audx_scratch_thread_local();
+  std::vector<float> conv(n), frame(FRAME_SIZE);
+  audx_resampler_reset(pair.up);
+  audx_resampler_reset(pair.down);
+
+  const int64_t start = bench_now_ns();
+  for (int f = 0; f < frames; f++) {
+    const short *in = &input[(size_t)f * n];
+    short *out = &output[(size_t)f * n];
+    unsigned int in_len = n, out_len = FRAME_SIZE;
+    if (fused) {
+      audx_resampler_process_int_float_ws(pair.up, scratch, in, &in_len,
+                                          frame.data(), &out_len);
+    } else {
+      pcm_int16_to_float(in, conv.data(), n);
+      audx_resampler_process_float_ws(pair.up, scratch, conv.data(), &in_len,
+                                      frame.data(), &out_len);
+    }
+    in_len = FRAME_SIZE;
+    out_len = n;
+    if (fused) {
+      audx_resampler_process_float_int_ws(pair.down, scratch, frame.data(),
+                                          &in_len, out, &out_len);
+    } else {
+      audx_resampler_process_float_ws(pair.down, scratch, frame.data(),
+                                      &in_len, conv.data(), &out_len);
+      pcm_float_to_int16(conv.data(), out, n);
+    }
+  }
+  return (double)(bench_now_ns() - start) / frames;
+}
+
+static void bench_fused() {
+  for (unsigned int rate : {8000u, 16000u, 24000u, 32000u, 44100u}) {
+    const int n = rate / 100;
+    const auto input = bench_to_int16(
+        bench_add_noise(bench_clean_speech(rate, n * 500), 10.0f));
+    const FusedPair pair = {audx_resampler_create(rate, FRAME_RATE, 4),
+                            audx_resampler_create(FRAME_RATE, rate, 4)};
+    std::vector<short> out_separate(input.size()), out_fused(input.size());
+
+    double separate_ns = 1e30, fused_ns = 1e30;
+    for (int run = 0; run < 5; run++) {
+      separate_ns = std::min(separate_ns,
+                             fused_run(pair, false, rate, input, out_separate));
+      fused_ns =
+          std::min(fused_ns, fused_run(pair, true, rate, input, out_fused));
+    }
+
+    int max_diff = 0;
+    for (size_t i = 0; i < input.size(); i++)
+      max_diff = std::max(max_diff, std::abs(out_separate[i] - out_fused[i]));
+
+    // Each side drops a conversion pass (read int16 + write float, or the
+    // reverse) and moves int16 instead of float through the resampler
+    const int saved_bytes = 2 * (2 * n + 4 * n + 2 * n);
+    printf("fused %5u Hz  separate %7.0f ns/frame  fused %7.0f ns/frame  "
+           "saved %5d B/frame  max diff %d\n",
+           rate, separate_ns, fused_ns, saved_bytes, max_diff);
+
+    audx_resampler_destroy(pair.up);
+    audx_resampler_destroy(pair.down);
+  }
+}
+
+/* --- reprocess --- */
+// Full pass over two minutes, then 1s slices reprocessed at several file
+// positions and warm-ups. Reports the time per slice against the full pass
+// and the largest difference to the full pass output inside the slice.
+
+static void bench_reprocess() {
+  for (unsigned int rate : {16000u, 48000u}) {
+    const auto input = bench_to_int16(
+        bench_add_noise(bench_clean_speech(rate, rate * 120), 10.0f));
+    AudxSessionConfig config;
+    audx_session_config_default(&config);
+    config.in_rate = rate;
+    AudxSession *session = audx_session_create(&config);
+    const int n = rate / 100;
+    std::vector<short> full(input.size()), in(n);
+
+    const int64_t start = bench_now_ns();
+    for (size_t i = 0; i + n <= input.size(); i += n) {
+      memcpy(in.data(), &input[i], n * sizeof(short));
+      audx_session_process_int(session, in.data(), &full[i]);
+    }
+    const double full_ms = (double)(bench_now_ns() - start) / 1e6;
+    audx_session_destroy(session);
+    printf("reprocess %5u Hz  full pass %7.1f ms\n", rate, full_ms);
+
+    std::vector<short> slice(rate);
+    for (unsigned int warmup_ms : {0u, 200u, 1000u}) {
+      for (double at_s : {10.0, 60.0, 110.0}) {
+        const size_t from = (size_t)(at_s * rate);
+        const int64_t t0 = bench_now_ns();
+        audx_offline_reprocess(&config, input.data(), input.size(), from,
+                               slice.size(), warmup_ms, slice.data());
+        const double ms = (double)(bench_now_ns() - t0) / 1e6;
+        int max_diff = 0;
+        for (size_t i = 0; i < slice.size(); i++)
+          max_diff = std::max(max_diff, std::abs(slice[i] - full[from + i]));
+        printf("  slice 1s at %5.1fs  warmup %4u ms  %6.1f ms  max diff %d\n",
+               at_s, warmup_ms, ms, max_diff);
+      }
+    }
+  }
+}
+
+/* --- prime --- */
+// A call that starts after 500ms of room noise: the first 500ms of live
+// output from a cold session and from a primed one, against a session that
+// processed the pre-roll normally (RMS difference). Also the cost of priming
+// per frame against processing: priming only saves the session resampler's
+// work, so at 48 kHz and at rates the core resamples itself (22050 Hz) it
+// costs as much as processing.
+
+static double rms_diff(const short *a, const short *b, size_t count) {
+  double sum = 0.0;
+  for (size_t i = 0; i < count; i++)
+    sum += (double)(a[i] - b[i]) * (a[i] - b[i]);
+  return std::sqrt(sum / count);
+}
+
+static void bench_prime() {
+  for (unsigned int rate : {16000u, 48000u, 22050u}) {
+    const int n = rate / 100;
+    const char *path = rate == 48000 ? "core rate"
+                       : rate % 100  ? "core resampling"
+                                     : "session resampler";
+    const size_t preroll = rate / 2, live = rate * 2;
+    // Noise throughout, speech only after the pre-roll
+    auto clean = bench_clean_speech(rate, preroll + live);
+    std::fill(clean.begin(), clean.begin() + preroll, 0.0f);
+    const auto input = bench_to_int16(bench_add_noise(clean, 10.0f));
+
+    std::vector<short> reference(preroll + live), cold(live), primed(live);
+    std::vector<short> in(n);
+    auto run = [&](AudxSession *session, size_t from, short *out) {
+      for (size_t i = from; i + n <= input.size(); i += n) {
+        memcpy(in.data(), &input[i], n * sizeof(short));
+        audx_session_process_int(session, in.data(), out + (i - from));
+      }
+    };
+
+    AudxSession *session = bench_session(rate, 2, 0);
+    run(session, 0, reference.data());
+    audx_session_destroy(session);
+
+    session = bench_session(rate, 2, 0);
+    run(session, preroll, cold.data());
+    audx_session_destroy(session);
+
+    session = bench_session(rate, 2, 0);
+    audx_session_prime(session, input.data(), preroll);
+    run(session, preroll, primed.data());
+    audx_session_destroy(session);
+
+    // Cost over a longer pre-roll, best of several interleaved runs
+    const auto long_input = bench_to_int16(
+        bench_add_noise(bench_clean_speech(rate, n * 1000), 10.0f));
+    double process_ns = 1e30, prime_ns = 1e30;
+    for (int r = 0; r < 5; r++) {
+      session = bench_session(rate, 2, 0);
+      process_ns =
+          std::min(process_ns, session_ns_per_frame(session, long_input));
+      audx_session_destroy(session);
+      session = bench_session(rate, 2, 0);
+      const int64_t start = bench_now_ns();
+      const int frames =
+          audx_session_prime(session, long_input.data(), long_input.size());
+      prime_ns =
+          std::min(prime_ns, (double)(bench_now_ns() - start) / frames);
+      audx_session_destroy(session);
+    }
+
+    const size_t window = rate / 2;
+    printf("prime %5u Hz %-17s  first 500ms vs warm: cold rms %7.1f  "
+           "primed rms %7.1f  |  process %7.0f ns/frame  prime %7.0f "
+           "ns/frame (%3.0f%%)\n",
+           rate, path, rms_diff(cold.data(), &reference[preroll], window),
+           rms_diff(primed.data(), &reference[preroll], window), process_ns,
+           prime_ns, 100.0 * prime_ns / process_ns);
+  }
+}
+
+/* --- speaker --- */
+// Four participants taking turns of 2-5s, with short backchannels from the
+// listeners and the talker bleeding into every other microphone at -20 dB.
+// Sessions report to the active-speaker detector as they process; it is
+// compared with the loudest VAD-positive stream per frame (what a naive
+// JVM-side loop does). Reports speaker changes and those to a participant
+// who is not talking, frame accuracy and the mean delay from the start of a
+// turn (which may open with a pause) to the switch.
+
+static void bench_speaker() {
+  const unsigned int rate = 16000;
+  const int n = rate / 100, streams = 4, seconds = 60;
+  const int frames = seconds * 100;
+
+  // Ground truth turns and per-participant input
+  std::vector<int> truth(frames);
+  std::vector<std::vector<float>> mic(streams,
+                                      std::vector<float>((size_t)frames * n));
+  const auto speech = bench_clean_speech(rate, frames * n);
+  BenchRng rng(5);
+  int turns = 0;
+  for (int f = 0, talker = 0; f < frames; talker = (talker + 1) % streams) {
+    const int len = (int)(100 * (3.5f + 1.5f * rng.uniform()));
+    for (int i = 0; i < len && f + i < frames; i++)
+      truth[f + i] = talker;
+    for (size_t i = (size_t)f * n;
+         i < std::min((size_t)(f + len), (size_t)frames) * n; i++) {
+      for (int s = 0; s < streams; s++)
+        mic[s][i] += speech[i] * (s == talker ? 1.0f : 0.1f);
+    }
+    // One 250ms backchannel from the next participant mid-turn
+    const int listener = (talker + 1) % streams;
+    const size_t bc = (size_t)(f + len / 2) * n;
+    for (size_t i = bc; i < bc + rate / 4 && i < mic[listener].size(); i++)
+      mic[listener][i] += 0.7f * speech[i - bc + rate];
+    f += len;
+    turns++;
+  }
+
+  std::vector<AudxSession *> sessions;
+  std::vector<std::vector<short>> input;
+  AudxSpeakerConfig config;
+  audx_speaker_config_default(&config);
+  AudxSpeakerDetector *detector =
+      audx_speaker_create(&config, streams, nullptr, nullptr);
+  for (int s = 0; s < streams; s++) {
+    sessions.push_back(bench_session(rate, 2, 0));
+    audx_session_set_speaker(sessions[s], detector, s);
+    input.push_back(bench_to_int16(bench_add_noise(mic[s], 15.0f, 11 + s)));
+  }
+
+  int changes = 0, naive_changes = 0, correct = 0, naive_correct = 0;
+  int wrong = 0, naive_wrong = 0; // changes to someone who is not talking
+  int active = -1, naive = -1, since_turn = 0;
+  int delay_sum = 0, delays = 0, naive_delay_sum = 0, naive_delays = 0;
+  int64_t tick_ns = 0;
+  std::vector<short> in(n), out(n);
+  for (int f = 0; f < frames; f++) {
+    int loudest = -1;
+    float loudest_db = -1.0f;
+    for (int s = 0; s < streams; s++) {
+      memcpy(in.data(), &input[s][(size_t)f * n], n * sizeof(short));
+      const float vad =
+          audx_session_process_int(sessions[s], in.data(), out.data());
+      float sum = 0.0f;
+      for (short v : out)
+        sum += (float)v * v;
+      const float db = 10.0f * log10f(sum / n + 1.0f);
+      if (vad >= config.vad_on && db > loudest_db) {
+        loudest = s;
+        loudest_db = db;
+      }
+    }
+    const int64_t start = bench_now_ns();
+    const int next = audx_speaker_tick(detector);
+    tick_ns += bench_now_ns() - start;
+
+    since_turn = f > 0 && truth[f] != truth[f - 1] ? 0 : since_turn + 1;
+    if (next != active) {
+      changes++;
+      wrong += next != truth[f];
+      if (next == truth[f]) {
+        delay_sum += since_turn;
+        delays++;
+      }
+    }
+    if (loudest >= 0 && loudest != naive) {
+      naive_changes++;
+      naive_wrong += loudest != truth[f];
+      if (loudest == truth[f]) {
+        naive_delay_sum += since_turn;
+        naive_delays++;
+      }
+      naive = loudest;
+    }
+    active = next;
+    correct += active == truth[f];
+    naive_correct += naive == truth[f];
+  }
+
+  printf("speaker  %d streams %ds  %d turns\n", streams, seconds, turns);
+  printf("  detector  %4d changes (%3d wrong)  %5.1f%% frames correct  "
+         "switch delay %4.0f ms  tick %3.0f ns\n",
+         changes, wrong, 100.0 * correct / frames,
+         delays ? 10.0 * delay_sum / delays : 0.0, (double)tick_ns / frames);
+  printf("  naive     %4d changes (%3d wrong)  %5.1f%% frames correct  "
+         "switch delay %4.0f ms\n",
+         naive_changes, naive_wrong, 100.0 * naive_correct / frames,
+         naive_delays ? 10.0 * naive_delay_sum / naive_delays : 0.0);
+
+  for (AudxSession *session : sessions)
+    audx_session_destroy(session);
+  audx_speaker_destroy(detector);
+}
+
+/* --- tables --- */
+// Worker processes forked from the bench, each running sessions with the
+// largest resampler banks (44.1 kHz at quality 4 and 10). Once with private
+// banks and once mapping tables the parent built into a sealed memfd, as a
+// process receiving the descriptor would. Reports the PSS the workers gain
+// by creating their sessions, summed over workers, and the saving per
+// extra process.
+
+static const AudxSessionConfig *tables_configs(int *count) {
+  static AudxSessionConfig configs[2];
+  for (int i = 0; i < 2; i++) {
+    audx_session_config_default(&configs[i]);
+    configs[i].in_rate = 44100;
+    configs[i].resample_quality = i == 0 ? 4 : 10;
+  }
+  *count = 2;
+  return configs;
+}
+
+static long pss_kb() {
+  FILE *file = fopen("/proc/self/smaps_rollup", "r");
+  if (!file)
+    return -1;
+  char line[256];
+  long kb = -1;
+  while (fgets(line, sizeof(line), file))
+    if (sscanf(line, "Pss: %ld kB", &kb) == 1)
+      break;
+  fclose(file);
+  return kb;
+}
+
+// Runs in the child: creates the sessions, waits until every worker has,
+// then reports its PSS growth
+static void tables_worker(int tables_fd, int ready, int go, int result) {
+  const long before = pss_kb();
+  AudxTables *tables = tables_fd >= 0 ? audx_tables_map(tables_fd) : nullptr;
+  int count;
+  const AudxSessionConfig *configs = tables_configs(&count);
+  std::vector<AudxSession *> sessions;
+  std::vector<short> frame(441);
+  for (int i = 0; i < count; i++) {
+    AudxSessionConfig config = configs[i];
+    config.tables = tables;
+    AudxSession *session = audx_session_create(&config);
+    audx_session_process_int(session, frame.data(), frame.data());
+    audx_session_prefault(session);
+    sessions.push_back(session);
+  }
+  char byte = 0;
+  if (write(ready, &byte, 1) != 1 || read(go, &byte, 1) != 1)
+    _exit(1);
+  const long grown = pss_kb() - before;
+  if (write(result, &grown, sizeof(grown)) != sizeof(grown))
+    _exit(1);
+  _exit(0);
+}
+
+static long tables_run(int workers, const AudxTables *tables) {
+  int ready[2], go[2], result[2];
+  if (pipe(ready) != 0 || pipe(go) != 0 || pipe(result) != 0)
+    return -1;
+  std::vector<pid_t> pids;
+  for (int w = 0; w < workers; w++) {
+    const pid_t pid = fork();
+    if (pid == 0)
+      tables_worker(tables ? audx_tables_fd(tables) : -1, ready[1], go[0],
+                    result[1]);
+    pids.push_back(pid);
+  }
+
+  char byte = 0;
+  for (int w = 0; w < workers; w++)
+    if (read(ready[0], &byte, 1) != 1)
+      break;
+  for (int w = 0; w < workers; w++)
+    if (write(go[1], &byte, 1) != 1)
+      break;
+  long total = 0;
+  for (int w = 0; w < workers; w++) {
+    long grown = 0;
+    if (read(result[0], &grown, sizeof(grown)) == sizeof(grown))
+      total += grown;
+  }
+  for (pid_t pid : pids)
+    waitpid(pid, nullptr, 0);
+  for (int fd : {ready[0], ready[1], go[0], go[1], result[0], result[1]})
+    close(fd);
+  return total;
+}
+
+static void bench_tables() {
+  int count;
+  const AudxSessionConfig *configs = tables_configs(&count);
+  std::vector<AudxTableSpec> specs;
+  for (int i = 0; i < count; i++) {
+    AudxTableSpec pair[2];
+    const int n = audx_session_table_specs(&configs[i], pair);
+    specs.insert(specs.end(), pair, pair + n);
+  }
+  AudxTables *tables = audx_tables_build(specs.data(), (int)specs.size());
+  if (!tables || pss_kb() < 0) {
+    printf("tables  memfd sealing or smaps_rollup unavailable\n");
+    audx_tables_destroy(tables);
+    return;
+  }
+
+  printf("tables  blob %zu KB (%zu banks)\n", audx_tables_bytes(tables) / 1024,
+         specs.size());
+  for (int workers : {1, 2, 4, 8}) {
+    const long private_kb = tables_run(workers, nullptr);
+    const long shared_kb = tables_run(workers, tables);
+    printf("  %d workers  PSS growth private %6ld KB  shared %6ld KB  "
+           "saved per extra process %5ld KB\n",
+           workers, private_kb, shared_kb,
+           workers > 1 ? (private_kb - shared_kb) / (workers - 1) : 0L);
+  }
+  audx_tables_destroy(tables);
+}
+
+/* --- events --- */
+// Event delivery from processing threads to one consumer: the lock-free
+// ring drained in batches against a per-event handoff through a mutex and
+// condition variable (what a per-frame upcall needs at the least; the JNI
+// attach and call cost comes on top on a device). Producers push as fast as
+// they can; a full ring makes them retry.
+
+static const int EVENTS_PER_PRODUCER = 1000000;
+
+static double events_ring_run(int producers) {
+  AudxEventRing *ring = audx_events_create(4096);
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++) {
+    threads.emplace_back([ring, p] {
+      AudxEvent event = {};
+      event.type = AUDX_EVENT_VAD;
+      event.stream = p;
+      event.time_ns = 1; // skip the clock read, measured separately
+      for (int i = 0; i < EVENTS_PER_PRODUCER; i++) {
+        event.frame = (uint64_t)i;
+        while (audx_events_push(ring, &event) != 0)
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  std::vector<AudxEvent> batch(256);
+  const size_t total = (size_t)producers * EVENTS_PER_PRODUCER;
+  std::vector<uint64_t> next(producers, 0);
+  size_t received = 0, out_of_order = 0;
+  while (received < total) {
+    const size_t n = audx_events_drain(ring, batch.data(), batch.size());
+    for (size_t i = 0; i < n; i++) {
+      const AudxEvent &e = batch[i];
+      out_of_order += e.frame != next[e.stream];
+      next[e.stream] = e.frame + 1;
+    }
+    received += n;
+    if (n == 0)
+      std::this_thread::yield();
+  }
+  for (auto &t : threads)
+    t.join();
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  audx_events_destroy(ring);
+  if (out_of_order)
+    printf("  ring delivered %zu events out of order\n", out_of_order);
+  return (double)total / seconds;
+}
+
+static double events_locked_run(int producers) {
+  std::mutex lock;
+  std::condition_variable ready;
+  std::deque<AudxEvent> queue;
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++) {
+    threads.emplace_back([&, p] {
+      AudxEvent event = {};
+      event.type = AUDX_EVENT_VAD;
+      event.stream = p;
+      for (int i = 0; i < EVENTS_PER_PRODUCER; i++) {
+        event.frame = (uint64_t)i;
+        {
+          std::lock_guard<std::mutex> guard(lock);
+          queue.push_back(event);
+        }
+        ready.notify_one();
+      }
+    });
+  }
+
+  const size_t total = (size_t)producers * EVENTS_PER_PRODUCER;
+  for (size_t received = 0; received < total; received++) {
+    std::unique_lock<std::mutex> guard(lock);
+    ready.wait(guard, [&] { return !queue.empty(); });
+    queue.pop_front();
+  }
+  for (auto &t : threads)
+    t.join();
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  return (double)total / seconds;
+}
+
+static void bench_events() {
+  // Cost on the processing thread: one VAD event with its timestamp
+  AudxEventRing *ring = audx_events_create(1024);
+  std::vector<AudxEvent> batch(1024);
+  AudxEvent event = {};
+  event.type = AUDX_EVENT_VAD;
+  const int pushes = 1000000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < pushes; i++) {
+    event.time_ns = 0;
+    audx_events_push(ring, &event);
+    if ((i & 511) == 511)
+      audx_events_drain(ring, batch.data(), batch.size());
+  }
+  const double push_ns =
+      std::chrono::duration<double, std::nano>(
+          std::chrono::steady_clock::now() - start)
+          .count() /
+      pushes;
+  audx_events_destroy(ring);
+  printf("events  push %.1f ns/event incl. timestamp (uncontended)\n",
+         push_ns);
+
+  for (int producers : {1, 2, 4, 8}) {
+    const double ring_rate = events_ring_run(producers);
+    const double locked_rate = events_locked_run(producers);
+    printf("  %d producers  ring %6.1f M events/s  locked handoff %6.1f M "
+           "events/s  (%.1fx)\n",
+           producers, ring_rate / 1e6, locked_rate / 1e6,
+           ring_rate / locked_rate);
+  }
+}
+
+/* --- monitor --- */
+// Cost of publishing to a monitor page: ns/frame of a 16kHz session
+// without a page, publishing, and publishing while a reader samples every
+// slot each millisecond (best of several interleaved runs), plus the cost
+// of one seqlock read.
+
+static void bench_monitor() {
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/audx_bench_monitor.%d", (int)getpid());
+  AudxMonitor *writer = audx_monitor_create(path, 64);
+  AudxMonitor *reader = writer ? audx_monitor_open(path) : nullptr;
+  if (!reader) {
+    printf("monitor  cannot create a page at %s\n", path);
+    audx_monitor_destroy(writer);
+    return;
+  }
+
+  const unsigned int rate = 16000;
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(rate, rate * 5), 10.0f));
+  AudxSession *session = bench_session(rate, 2, 0);
+
+  std::atomic<bool> sampling(false), stop(false);
+  std::thread sampler([&] {
+    AudxMonitorSlot slot;
+    while (!stop.load()) {
+      if (sampling.load()) {
+        for (int s = 0; s < audx_monitor_slots(reader); s++)
+          audx_monitor_read(reader, s, &slot);
+      }
+      usleep(1000);
+    }
+  });
+
+  double best[3] = {1e18, 1e18, 1e18};
+  for (int run = 0; run < 5; run++) {
+    for (int mode = 0; mode < 3; mode++) {
+      audx_session_set_monitor(session, mode ? writer : nullptr, 0);
+      sampling.store(mode == 2);
+      best[mode] = std::min(best[mode], session_ns_per_frame(session, input));
+    }
+  }
+  stop.store(true);
+  sampler.join();
+
+  const int calls = 1000000;
+  int64_t start = bench_now_ns();
+  for (int i = 0; i < calls; i++)
+    audx_monitor_publish(writer, 1, 1000, 0.5f, AUDX_FRAME_ON_TIME);
+  const double publish_ns = (double)(bench_now_ns() - start) / calls;
+
+  AudxMonitorSlot slot;
+  start = bench_now_ns();
+  for (int i = 0; i < calls; i++)
+    audx_monitor_read(reader, 0, &slot);
+  const double read_ns = (double)(bench_now_ns() - start) / calls;
+
+  printf("monitor  16kHz session, best of 5\n");
+  printf("  off                 %8.0f ns/frame\n", best[0]);
+  printf("  publishing          %8.0f ns/frame  (%+.0f)\n", best[1],
+         best[1] - best[0]);
+  printf("  publishing, sampled %8.0f ns/frame  (%+.0f)\n", best[2],
+         best[2] - best[0]);
+  printf("  publish %.1f ns/frame incl. timestamp, seqlock read %.1f ns/slot"
+         "\n",
+         publish_ns, read_ns);
+
+  audx_session_destroy(session);
+  audx_monitor_destroy(reader);
+  audx_monitor_destroy(writer);
+}
+
+/* --- timestamps --- */
+// Presentation timestamps through a stream fed and drained in jittered
+// chunk sizes. Output samples are placed on the input timeline by the
+// timestamp of their read, and the remaining offset to the clean input is
+// measured by cross-correlation (sub-sample). 0 means the timestamps are
+// exact; rates the core resamples itself (44.1kHz) miss that resampler's
+// delay.
+
+// Lag of `y` against `x` in samples, within +-max_lag
+static double xcorr_lag(const std::vector<float> &x, const std::vector<float> &y,
+                        int max_lag) {
+  std::vector<double> score(2 * max_lag + 1);
+  for (int lag = -max_lag; lag <= max_lag; lag++) {
+    double sum = 0.0;
+    for (size_t i = max_lag; i + max_lag < x.size() && i + max_lag < y.size();
+         i++)
+      sum += (double)x[i] * y[i + lag];
+    score[lag + max_lag] = sum;
+  }
+  int best = 0;
+  for (int i = 1; i < (int)score.size(); i++)
+    if (score[i] > score[best])
+      best = i;
+  double frac = 0.0;
+  if (best > 0 && best + 1 < (int)score.size()) {
+    const double a = score[best - 1], b = score[best], c = score[best + 1];
+    if (a - 2 * b + c != 0.0)
+      frac = 0.5 * (a - c) / (a - 2 * b + c);
+  }
+  return best - max_lag + frac;
+}
+
+static void bench_timestamps() {
+  printf("timestamps  pts offset after jittered stream I/O\n");
+  printf("  %6s %7s %10s %12s\n", "rate", "quality", "delay ms", "offset us");
+  const int64_t base_ns = 1000000000000LL;
+  for (unsigned int rate : {8000u, 16000u, 32000u, 44100u, 48000u}) {
+    const auto clean = bench_clean_speech(rate, rate * 4);
+    const auto input = bench_to_int16(bench_add_noise(clean, 30.0f));
+    for (int quality : {0, 4, 10}) {
+      if (rate == FRAME_RATE && quality != 4)
+        continue;
+      AudxSessionConfig config;
+      audx_session_config_default(&config);
+      config.in_rate = rate;
+      config.resample_quality = quality;
+      AudxStream *stream = audx_stream_create(&config, 8);
+      const int n = audx_session_frame_samples(audx_stream_session(stream));
+
+      BenchRng rng(11);
+      std::vector<float> aligned(input.size(), 0.0f);
+      std::vector<short> chunk(4 * n);
+      size_t pos = 0;
+      while (pos < input.size()) {
+        // 1 to 2 frames per write and read
+        const unsigned int len = std::min<size_t>(
+            1 + (size_t)((1.0f + rng.uniform()) * n), input.size() - pos);
+        const int64_t ts = base_ns + (int64_t)pos * 1000000000LL / rate;
+        pos += audx_stream_write_ts(stream, &input[pos], len, ts);
+
+        int64_t pts;
+        int got;
+        while ((got = audx_stream_read_ts(
+                    stream, chunk.data(),
+                    1 + (unsigned int)((1.0f + rng.uniform()) * n), &pts)) >
+               0) {
+          // Input sample the read's first sample belongs to
+          const int64_t at =
+              ((pts - base_ns) * (int64_t)rate + 500000000LL) / 1000000000LL;
+          for (int i = 0; i < got; i++) {
+            if (at + i >= 0 && at + i < (int64_t)aligned.size())
+              aligned[at + i] = chunk[i];
+          }
+        }
+      }
+      const double lag = xcorr_lag(clean, aligned, (int)(rate / 50));
+      printf("  %6u %7d %10.3f %12.1f\n", rate, quality,
+             audx_session_delay_ns(audx_stream_session(stream)) / 1e6,
+             lag * 1e6 / rate);
+      audx_stream_destroy(stream);
+    }
+  }
+}
+
+static const int VMATH_LEN = 4096;
+
+// Best of 5 over repeated passes of one array
+template <typename Fn> static double vmath_ns_per_element(Fn fn) {
+  const int passes = 500;
+  double best = 1e18;
+  for (int run = 0; run < 5; run++) {
+    const int64_t start = bench_now_ns();
+    for (int p = 0; p < passes; p++)
+      fn();
+    best = std::min(best, (double)(bench_now_ns() - start) /
+                              ((double)passes * VMATH_LEN));
+  }
+  return best;
+}
+
+static void bench_vmath() {
+  struct VmathCase {
+    const char *name;
+    float lo, hi;
+    void (*vector)(const float *, float *, int);
+    float (*libm)(float);
+  };
+  static const VmathCase cases[] = {
+      {"exp", -20.0f, 20.0f, audx_vexp, expf},
+      {"log", 1e-6f, 1e6f, audx_vlog, logf},
+      {"tanh", -5.0f, 5.0f, audx_vtanh, tanhf},
+      {"sigmoid", -20.0f, 20.0f, audx_vsigmoid,
+       [](float x) { return 1.0f / (1.0f + expf(-x)); }},
+      {"rsqrt", 1e-6f, 1e6f, audx_vrsqrt,
+       [](float x) { return 1.0f / sqrtf(x); }},
+  };
+
+  printf("vmath  %d-element arrays, %s kernels vs libm\n", VMATH_LEN,
+         audx_vmath_isa());
+  printf("  %-8s %12s %12s %8s\n", "function", "libm ns/el", "vmath ns/el",
+         "speedup");
+  std::vector<float> x(VMATH_LEN), y(VMATH_LEN);
+  for (const VmathCase &c : cases) {
+    BenchRng rng(3);
+    for (float &v : x)
+      v = c.lo + (c.hi - c.lo) * 0.5f * (1.0f + rng.uniform());
+    const double libm = vmath_ns_per_element([&] {
+      for (int i = 0; i < VMATH_LEN; i++)
+        y[i] = c.libm(x[i]);
+    });
+    const double vector = vmath_ns_per_element([&] {
+      c.vector(x.data(), y.data(), VMATH_LEN);
+    });
+    printf("  %-8s %12.3f %12.3f %7.1fx\n", c.name, libm, vector,
+           libm / vector);
+  }
+}
+
+// FNV-1a over int16 samples, for comparing outputs across machines
+static uint64_t fnv1a(const std::vector<short> &samples) {
+  uint64_t hash = 14695981039346656037ull;
+  for (short v : samples) {
+    for (int b = 0; b < 2; b++) {
+      hash ^= (uint8_t)((uint16_t)v >> (8 * b));
+      hash *= 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+// Resamples `input` to FRAME_RATE and back in 10ms frames
+static double round_trip_ns_per_frame(unsigned int rate, int quality,
+                                      int deterministic,
+                                      const std::vector<short> &input,
+                                      std::vector<short> &output) {
+  AudxResampler *up = audx_resampler_create(rate, FRAME_RATE, quality);
+  AudxResampler *down = audx_resampler_create(FRAME_RATE, rate, quality);
+  audx_resampler_set_deterministic(up, deterministic);
+  audx_resampler_set_deterministic(down, deterministic);
+  const unsigned int n = rate / 100;
+  std::vector<short> mid(FRAME_SIZE);
+  output.assign(input.size(), 0);
+  const int frames = (int)(input.size() / n);
+  const int64_t start = bench_now_ns();
+  for (int f = 0; f < frames; f++) {
+    unsigned int in_len = n, mid_len = FRAME_SIZE, out_len;
+    audx_resampler_process_int(up, &input[(size_t)f * n], &in_len, mid.data(),
+                               &mid_len);
+    out_len = n;
+    audx_resampler_process_int(down, mid.data(), &mid_len,
+                               &output[(size_t)f * n], &out_len);
+  }
+  const double ns = (double)(bench_now_ns() - start) / frames;
+  audx_resampler_destroy(up);
+  audx_resampler_destroy(down);
+  return ns;
+}
+
+static void bench_deterministic() {
+  printf("deterministic  rate -> 48k -> rate resampling, best of 5; FNV-1a "
+         "of the output\n");
+  printf("  %6s %7s %9s %9s %6s %17s %17s\n", "rate", "quality", "fast ns",
+         "exact ns", "cost", "fast hash", "exact hash");
+  for (unsigned int rate : {8000u, 16000u, 44100u}) {
+    const auto input = bench_to_int16(
+        bench_add_noise(bench_clean_speech(rate, rate * 5), 10.0f));
+    for (int quality : {4, 10}) {
+      std::vector<short> out[2];
+      double best[2] = {1e18, 1e18};
+      for (int run = 0; run < 5; run++) {
+        for (int mode = 0; mode < 2; mode++)
+          best[mode] = std::min(best[mode],
+                                round_trip_ns_per_frame(rate, quality, mode,
+                                                        input, out[mode]));
+      }
+      printf("  %6u %7d %9.0f %9.0f %5.1f%% %17llx %17llx\n", rate,
+             quality, best[0], best[1], 100.0 * (best[1] / best[0] - 1.0),
+             (unsigned long long)fnv1a(out[0]),
+             (unsigned long long)fnv1a(out[1]));
+    }
+  }
+}
+
+/* --- params --- */
+// Cost of picking up runtime parameters on the processing thread: the
+// parameter block's acquire against a mutex-guarded copy, while 0, 1 or 4
+// control threads publish new values as fast as they can. Mean ns per
+// pickup over a tight loop, and the 99.9th percentile and worst of pickups
+// timed one by one (so including a clock read; with fewer cores than
+// threads the worst is a preemption either way). Then ns/frame of a 16kHz
+// session at the defaults and with strength 0.5 and the AGC on.
+
+static const int PARAMS_PICKUPS = 2000000;
+
+struct PickupCost {
+  double mean_ns;
+  double p999_ns;
+  double max_ns;
+};
+
+template <class Pickup, class Publish>
+static PickupCost params_run(int writers, Pickup pickup, Publish publish) {
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> threads;
+  for (int w = 0; w < writers; w++) {
+    threads.emplace_back([&, w] {
+      AudxParams values;
+      audx_params_default(&values);
+      for (long n = 0; !stop.load(std::memory_order_relaxed); n++) {
+        values.strength = (n & 1) ? 0.25f : 0.75f;
+        values.agc_target_db = -20.0f - (float)w;
+        publish(values);
+      }
+    });
+  }
+
+  volatile float sink = 0.0f;
+  const int64_t start = bench_now_ns();
+  for (int i = 0; i < PARAMS_PICKUPS; i++)
+    sink = pickup();
+  const double mean_ns = (double)(bench_now_ns() - start) / PARAMS_PICKUPS;
+  std::vector<int64_t> single(PARAMS_PICKUPS / 10);
+  for (int64_t &ns : single) {
+    const int64_t t0 = bench_now_ns();
+    sink = pickup();
+    ns = bench_now_ns() - t0;
+  }
+  (void)sink;
+
+  stop = true;
+  for (auto &t : threads)
+    t.join();
+  std::sort(single.begin(), single.end());
+  return {mean_ns, (double)single[single.size() * 999 / 1000],
+          (double)single.back()};
+}
+
+static void bench_params() {
+  printf("params  processing-thread pickup while control threads write, "
+         "ns\n");
+  printf("  %7s %10s %10s %10s %10s %10s %10s\n", "writers", "block mean",
+         "p99.9", "max", "mutex mean", "p99.9", "max");
+  for (int writers : {0, 1, 4}) {
+    AudxParamBlock *block = audx_param_block_create(nullptr);
+    const PickupCost lock_free = params_run(
+        writers,
+        [block] {
+          const AudxParams *p = audx_param_block_acquire(block);
+          return p->strength + p->agc_target_db;
+        },
+        [block](const AudxParams &values) {
+          audx_param_block_update(block, &values, AUDX_PARAM_ALL);
+        });
+    audx_param_block_destroy(block);
+
+    std::mutex lock;
+    AudxParams shared;
+    audx_params_default(&shared);
+    const PickupCost locked = params_run(
+        writers,
+        [&] {
+          std::lock_guard<std::mutex> guard(lock);
+          const AudxParams p = shared;
+          return p.strength + p.agc_target_db;
+        },
+        [&](const AudxParams &values) {
+          std::lock_guard<std::mutex> guard(lock);
+          shared = values;
+        });
+
+    printf("  %7d %10.1f %10.0f %10.0f %10.1f %10.0f %10.0f\n", writers,
+           lock_free.mean_ns, lock_free.p999_ns, lock_free.max_ns,
+           locked.mean_ns, locked.p999_ns, locked.max_ns);
+  }
+
+  const unsigned int rate = 16000;
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(rate, rate * 10), 10.0f));
+  double best[2] = {1e18, 1e18};
+  for (int run = 0; run < 5; run++) {
+    for (int mode = 0; mode < 2; mode++) {
+      AudxSession *session = bench_session(rate, 2, 0);
+      if (mode) {
+        AudxParams params;
+        audx_session_get_params(session, &params);
+        params.strength = 0.5f;
+        params.agc = 1;
+        audx_session_set_params(session, &params, AUDX_PARAM_ALL);
+      }
+      best[mode] = std::min(best[mode], session_ns_per_frame(session, input));
+      audx_session_destroy(session);
+    }
+  }
+  printf("  session 16k  defaults %.0f ns/frame  strength 0.5 + AGC %.0f "
+         "ns/frame (%+.1f%%)\n",
+         best[0], best[1], 100.0 * (best[1] / best[0] - 1.0));
+}
+
+/* --- layout --- */
+// False sharing between streams processed on different threads, at 1 to 32
+// threads, each owning four streams assigned round-robin (as a shared
+// engine queue hands them out). Per-stream counters are updated as fast as
+// possible, packed 16 bytes apart (plain arrays of small structs) against
+// padded to AUDX_STATE_ALIGN; the speaker detector's inputs are the real
+// padded case. In the style of perf c2c, "shared lines" counts cache lines
+// stored to by more than one thread and "remote" the share of stores that
+// land on such lines, from the addresses. Then ns/frame of 16kHz sessions
+// created on the heap against in an arena region per thread, in thread CPU
+// time.
+
+static const int LAYOUT_STREAMS_PER_THREAD = 4;
+static const int LAYOUT_UPDATES = 2000000; // per thread
+
+struct PackedCounters {
+  std::atomic<uint32_t> frames;
+  std::atomic<float> vad;
+  std::atomic<uint64_t> busy_ns;
+};
+
+struct alignas(AUDX_STATE_ALIGN) PaddedCounters {
+  std::atomic<uint32_t> frames;
+  std::atomic<float> vad;
+  std::atomic<uint64_t> busy_ns;
+};
+
+struct LineSharing {
+  int shared_lines;
+  double remote_share;
+};
+
+// Lines written by more than one thread, given each stream's counter block
+// and the thread that owns it
+static LineSharing line_sharing(const std::vector<const void *> &blocks,
+                                size_t bytes, int threads) {
+  std::vector<std::pair<uintptr_t, int>> writes; // line, thread
+  for (size_t i = 0; i < blocks.size(); i++) {
+    const uintptr_t first = (uintptr_t)blocks[i] / AUDX_CACHE_LINE;
+    const uintptr_t last = ((uintptr_t)blocks[i] + bytes - 1) / AUDX_CACHE_LINE;
+    for (uintptr_t line = first; line <= last; line++)
+      writes.push_back({line, (int)(i % threads)});
+  }
+  std::sort(writes.begin(), writes.end());
+  int shared = 0;
+  size_t remote = 0;
+  for (size_t i = 0; i < writes.size();) {
+    size_t j = i;
+    bool mixed = false;
+    while (j < writes.size() && writes[j].first == writes[i].first) {
+      mixed |= writes[j].second != writes[i].second;
+      j++;
+    }
+    if (mixed) {
+      shared++;
+      remote += j - i;
+    }
+    i = j;
+  }
+  return {shared, writes.empty() ? 0.0 : (double)remote / writes.size()};
+}
+
+// Aggregate M updates/s of `threads` threads each calling update(stream, i)
+// on their own streams
+template <class Update>
+static double layout_run(int threads, Update update) {
+  std::atomic<int> ready(0);
+  std::atomic<bool> go(false);
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++) {
+    pool.emplace_back([&, t] {
+      ready++;
+      while (!go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+      for (int i = 0; i < LAYOUT_UPDATES; i++)
+        update(t + threads * (i % LAYOUT_STREAMS_PER_THREAD), i);
+    });
+  }
+  while (ready.load() < threads)
+    std::this_thread::yield();
+  const int64_t start = bench_now_ns();
+  go.store(true, std::memory_order_release);
+  for (auto &t : pool)
+    t.join();
+  const double seconds = (double)(bench_now_ns() - start) / 1e9;
+  return (double)threads * LAYOUT_UPDATES / seconds / 1e6;
+}
+
+template <class Counters> static void count_frame(Counters &c, int i) {
+  c.frames.fetch_add(1, std::memory_order_relaxed);
+  c.vad.store((float)(i & 7) * 0.125f, std::memory_order_relaxed);
+  c.busy_ns.fetch_add(1000, std::memory_order_relaxed);
+}
+
+// CPU time of the calling thread, so oversubscribed runs stay comparable
+static int64_t thread_cpu_ns() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static double layout_sessions(int threads, bool arena_layout) {
+  const unsigned int rate = 16000;
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(rate, rate * 1), 10.0f));
+  AudxSessionConfig config;
+  audx_session_config_default(&config);
+  config.in_rate = rate;
+  AudxArena *arena = arena_layout ? audx_arena_create(threads, 0) : nullptr;
+  const int count = threads * 2;
+  std::vector<AudxSession *> sessions(count);
+  for (int i = 0; i < count; i++)
+    sessions[i] = arena ? audx_session_create_in(&config, arena, i % threads)
+                        : audx_session_create(&config);
+
+  std::vector<double> ns(threads);
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++) {
+    pool.emplace_back([&, t] {
+      const int n = audx_session_frame_samples(sessions[t]);
+      std::vector<short> out(n);
+      const int frames = (int)input.size() / n;
+      const int64_t start = thread_cpu_ns();
+      for (int f = 0; f < frames; f++)
+        for (int s = t; s < count; s += threads)
+          audx_session_process_int(sessions[s],
+                                   const_cast<short *>(&input[(size_t)f * n]),
+                                   out.data());
+      ns[t] = (double)(thread_cpu_ns() - start) / (frames * 2);
+    });
+  }
+  for (auto &t : pool)
+    t.join();
+  for (AudxSession *session : sessions)
+    audx_session_destroy(session);
+  audx_arena_destroy(arena);
+  double total = 0.0;
+  for (double v : ns)
+    total += v;
+  return total / threads;
+}
+
+static void bench_layout() {
+  printf("layout  per-stream counters, %d streams per thread, round-robin "
+         "ownership (%u CPUs)\n",
+         LAYOUT_STREAMS_PER_THREAD, std::thread::hardware_concurrency());
+  printf("  %7s %12s %8s %8s %12s %8s %8s %12s\n", "threads", "packed M/s",
+         "shared", "remote", "padded M/s", "shared", "remote",
+         "speaker M/s");
+  for (int threads : {1, 2, 4, 8, 16, 32}) {
+    const int streams = threads * LAYOUT_STREAMS_PER_THREAD;
+    std::vector<PackedCounters> packed(streams);
+    std::vector<PaddedCounters> padded(streams);
+    std::vector<const void *> packed_blocks, padded_blocks;
+    for (int i = 0; i < streams; i++) {
+      packed_blocks.push_back(&packed[i]);
+      padded_blocks.push_back(&padded[i]);
+    }
+    const LineSharing packed_lines =
+        line_sharing(packed_blocks, sizeof(PackedCounters), threads);
+    const LineSharing padded_lines =
+        line_sharing(padded_blocks, sizeof(PaddedCounters), threads);
+
+    const double packed_rate = layout_run(
+        threads, [&](int s, int i) { count_frame(packed[s], i); });
+    const double padded_rate = layout_run(
+        threads, [&](int s, int i) { count_frame(padded[s], i); });
+
+    AudxSpeakerConfig config;
+    audx_speaker_config_default(&config);
+    AudxSpeakerDetector *detector =
+        audx_speaker_create(&config, streams, nullptr, nullptr);
+    const double speaker_rate = layout_run(threads, [&](int s, int i) {
+      audx_speaker_update_energy(detector, s, (float)(i & 7) * 0.125f, 40.0f);
+    });
+    audx_speaker_destroy(detector);
+
+    printf("  %7d %12.1f %8d %7.0f%% %12.1f %8d %7.0f%% %12.1f\n", threads,
+           packed_rate, packed_lines.shared_lines,
+           100.0 * packed_lines.remote_share, padded_rate,
+           padded_lines.shared_lines, 100.0 * padded_lines.remote_share,
+           speaker_rate);
+  }
+
+  printf("  sessions 16k, 2 per thread: CPU ns/frame, mean over threads\n");
+  printf("  %7s %12s %12s\n", "threads", "heap", "arena");
+  for (int threads : {1, 2, 4, 8, 16, 32}) {
+    const double heap = layout_sessions(threads, false);
+    const double arena = layout_sessions(threads, true);
+    printf("  %7d %12.0f %12.0f\n", threads, heap, arena);
+  }
+}
+
+/* --- numa --- */
+// Node-aware engine placement. Prints the sysfs topology and, with two or
+// more nodes, the latency of a dependent-load chase through memory placed
+// on each node from threads on each node. Then runs the engine over 64
+// streams of 48kHz frames (sessions and per-node table replicas made by
+// the engine) without a topology, with the detected one and, on a
+// single-node machine, with its CPUs split into two emulated nodes: the
+// code paths run, but every "node" has the same memory, so remote
+// latency cannot show. Reports frames/s, the share of frames run on a
+// remote node, and migrations.
+
+static const size_t NUMA_CHASE_BYTES = 64u << 20;
+
+// ns per dependent load through a random cycle in memory on `mem_node`,
+// walked from `cpu_node`
+static double numa_chase_ns(const AudxNumaTopology &t, int cpu_node,
+                            int mem_node) {
+  const size_t n = NUMA_CHASE_BYTES / sizeof(size_t);
+  size_t *next = nullptr;
+  std::thread([&] {
+    audx_numa_bind_thread(&t, mem_node);
+    next = (size_t *)malloc(n * sizeof(size_t)); // first touch below
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; i++)
+      order[i] = i;
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    for (size_t i = n - 1; i > 0; i--) {
+      rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+      std::swap(order[i], order[(rng >> 33) % (i + 1)]);
+    }
+    for (size_t i = 0; i < n; i++)
+      next[order[i]] = order[(i + 1) % n];
+  }).join();
+
+  double ns = 0.0;
+  std::thread([&] {
+    audx_numa_bind_thread(&t, cpu_node);
+    const size_t steps = 4000000;
+    size_t p = 0;
+    const int64_t start = bench_now_ns();
+    for (size_t i = 0; i < steps; i++)
+      p = next[p];
+    ns = (double)(bench_now_ns() - start) / steps;
+    volatile size_t sink = p;
+    (void)sink;
+  }).join();
+  free(next);
+  return ns;
+}
+
+static void numa_engine_run(const char *label, const AudxNumaTopology *t,
+                            const std::vector<short> &input) {
+  AudxEngineConfig config;
+  audx_engine_config_default(&config);
+  config.affinity = AUDX_AFFINITY_STEAL;
+  config.threads = std::max(config.threads, 4); // workers on every node
+  config.numa = t;
+  const int streams = 64, rounds = 100;
+  AudxEngine *engine = audx_engine_create(&config);
+
+  AudxSessionConfig session_config;
+  audx_session_config_default(&session_config);
+  session_config.in_rate = 16000;
+  AudxTableSpec specs[2];
+  const int count = audx_session_table_specs(&session_config, specs);
+  audx_engine_build_tables(engine, specs, count);
+
+  const int nodes = audx_engine_nodes(engine);
+  std::vector<AudxSession *> sessions;
+  std::vector<int> ids;
+  for (int i = 0; i < streams; i++) {
+    sessions.push_back(
+        audx_engine_session_create(engine, &session_config, i % nodes));
+    ids.push_back(audx_engine_add_stream(engine, sessions.back(),
+                                         AUDX_PRIORITY_NORMAL,
+                                         AUDX_LATE_PROCESS));
+  }
+
+  const size_t n = 160;
+  std::vector<short> out((size_t)streams * n);
+  const int64_t start = bench_now_ns();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < streams; i++)
+      audx_engine_submit(engine, ids[i], &input[(size_t)((r + i) % 100) * n],
+                         &out[(size_t)i * n], INT64_MAX, nullptr, nullptr);
+    audx_engine_drain(engine);
+  }
+  const int64_t elapsed = bench_now_ns() - start;
+
+  AudxEngineStats stats;
+  audx_engine_stats(engine, &stats);
+  for (AudxSession *session : sessions)
+    audx_session_destroy(session);
+  audx_engine_destroy(engine);
+
+  const double frames = (double)streams * rounds;
+  printf("  %-18s %d node(s) %2d threads %9.0f frames/s  remote %5.1f%%  "
+         "migrations %5.1f%%\n",
+         label, nodes, config.threads, frames * 1e9 / elapsed,
+         100.0 * stats.remote / frames, 100.0 * stats.migrations / frames);
+}
+
+static void bench_numa() {
+  AudxNumaTopology detected;
+  audx_numa_topology(nullptr, &detected);
+  printf("numa  %d node(s) with usable CPUs\n", detected.nodes);
+  for (int node = 0; node < detected.nodes; node++)
+    printf("  node%d: %d CPUs\n", detected.id[node],
+           CPU_COUNT(&detected.cpus[node]));
+
+  if (detected.nodes >= 2) {
+    printf("  chase ns/load, rows: CPU node, columns: memory node\n");
+    for (int c = 0; c < detected.nodes; c++) {
+      printf("  node%-3d", detected.id[c]);
+      for (int m = 0; m < detected.nodes; m++)
+        printf(" %8.1f", numa_chase_ns(detected, c, m));
+      printf("\n");
+    }
+  }
+
+  const auto input = bench_to_int16(
+      bench_add_noise(bench_clean_speech(16000, 16000), 10.0f));
+  numa_engine_run("unaware", nullptr, input);
+  numa_engine_run("detected", &detected, input);
+  if (detected.nodes == 1) {
+    // Halves of the CPU list; both halves are the one CPU if there is one
+    AudxNumaTopology split = detected;
+    split.nodes = 2;
+    split.id[1] = 1;
+    CPU_ZERO(&split.cpus[0]);
+    CPU_ZERO(&split.cpus[1]);
+    const int cpus = CPU_COUNT(&detected.cpus[0]);
+    for (int cpu = 0, seen = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (!CPU_ISSET(cpu, &detected.cpus[0]))
+        continue;
+      if (cpus == 1 || seen < cpus / 2)
+        CPU_SET(cpu, &split.cpus[0]);
+      if (cpus == 1 || seen >= cpus / 2)
+        CPU_SET(cpu, &split.cpus[1]);
+      seen++;
+    }
+    numa_engine_run("emulated 2 nodes", &split, input);
+  }
+}
+
+/* --- dtx --- */
+// DTX decisions over a conversational corpus: talk spurts of 1-3s with
+// their own short pauses, separated by 1.5-4s of listening, at 16kHz with
+// noise. For several hangovers: the share of frames sent, sent as
+// comfort-noise updates and skipped, the share of reference speech frames
+// (clean signal above -50 dBFS, aligned with the output's delay) that were
+// not sent, and the payload bitrate with an encoder at DTX_BENCH_KBPS that
+// sends DTX_BENCH_SID_BYTES per update. Skipped frames are encoder calls
+// saved outright. Also the cost of one decision next to a session frame.
+
+#define DTX_BENCH_KBPS 24
+#define DTX_BENCH_SID_BYTES 3
+
+static void bench_dtx() {
+  const unsigned int rate = 16000;
+  const int n = rate / 100;
+  std::vector<float> clean;
+  BenchRng rng(11);
+  for (uint32_t spurt = 0; clean.size() < (size_t)rate * 60; spurt++) {
+    const int talk = (int)(rate * (2.0f + rng.uniform()));
+    const auto speech = bench_clean_speech(rate, talk, 100 + spurt);
+    clean.insert(clean.end(), speech.begin(), speech.end());
+    clean.resize(clean.size() + (size_t)(rate * (2.75f + 1.25f * rng.uniform())),
+                 0.0f);
+  }
+  const auto input = bench_to_int16(bench_add_noise(clean, 15.0f));
+  const int frames = (int)(input.size() / n);
+
+  AudxSessionConfig config;
+  audx_session_config_default(&config);
+  config.in_rate = rate;
+  AudxSession *session = audx_session_create(&config);
+  std::vector<short> out(input.size());
+  std::vector<float> vad(frames);
+  std::vector<short> in(n);
+  const int64_t start = bench_now_ns();
+  for (int f = 0; f < frames; f++) {
+    memcpy(in.data(), &input[(size_t)f * n], n * sizeof(short));
+    vad[f] = audx_session_process_int(session, in.data(), &out[(size_t)f * n]);
+  }
+  const double session_ns = (double)(bench_now_ns() - start) / frames;
+  const int delay = (int)(audx_session_delay_ns(session) * rate / 1000000000);
+  audx_session_destroy(session);
+
+  // Reference speech per output frame
+  std::vector<bool> speech(frames, false);
+  for (int f = 0; f < frames; f++) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+      const long t = (long)f * n + i - delay;
+      const double v = t >= 0 ? clean[t] / 32768.0 : 0.0;
+      sum += v * v;
+    }
+    speech[f] = 10.0 * log10(sum / n + 1e-12) > -50.0;
+  }
+  int speech_frames = 0;
+  for (bool s : speech)
+    speech_frames += s;
+
+  const double seconds = (double)frames / 100.0;
+  printf("dtx  %.0fs at 16kHz, %.0f%% reference speech; encoder %d kbps, "
+         "%d-byte updates\n",
+         seconds, 100.0 * speech_frames / frames, DTX_BENCH_KBPS,
+         DTX_BENCH_SID_BYTES);
+  printf("  %9s %7s %7s %8s %13s %12s %11s\n", "hangover", "sent", "sid",
+         "skipped", "speech lost", "kbps", "noise dBFS");
+  printf("  %9s %6.1f%% %6.1f%% %7.1f%% %12.1f%% %12.2f %11s\n", "no dtx",
+         100.0, 0.0, 0.0, 0.0, (double)DTX_BENCH_KBPS, "-");
+  for (int hangover : {0, 10, 20, 40}) {
+    AudxDtxConfig dtx_config;
+    audx_dtx_config_default(&dtx_config);
+    dtx_config.hangover_frames = hangover;
+    AudxDtx *dtx = audx_dtx_create(&dtx_config);
+    int lost = 0;
+    double noise_sum = 0.0;
+    int noise_frames = 0;
+    for (int f = 0; f < frames; f++) {
+      AudxDtxFrame frame;
+      const int decision =
+          audx_dtx_update(dtx, vad[f], &out[(size_t)f * n], n, &frame);
+      lost += speech[f] && decision != AUDX_DTX_TRANSMIT;
+      if (decision != AUDX_DTX_TRANSMIT) {
+        noise_sum += frame.noise_db;
+        noise_frames++;
+      }
+    }
+    unsigned long long counts[3];
+    audx_dtx_counts(dtx, counts);
+    audx_dtx_destroy(dtx);
+    const double bytes_per_frame = DTX_BENCH_KBPS * 1000.0 / 8.0 / 100.0;
+    const double kbps = (counts[AUDX_DTX_TRANSMIT] * bytes_per_frame +
+                         counts[AUDX_DTX_SID] * DTX_BENCH_SID_BYTES) *
+                        8.0 / seconds / 1000.0;
+    printf("  %7d %s %6.1f%% %6.1f%% %7.1f%% %12.1f%% %12.2f %11.1f\n",
+           hangover, "fr", 100.0 * counts[AUDX_DTX_TRANSMIT] / frames,
+           100.0 * counts[AUDX_DTX_SID] / frames,
+           100.0 * counts[AUDX_DTX_SILENT] / frames,
+           speech_frames ? 100.0 * lost / speech_frames : 0.0, kbps,
+           noise_frames ? noise_sum / noise_frames : (double)AUDX_DTX_FLOOR_DB);
+  }
+
+  AudxDtxConfig dtx_config;
+  audx_dtx_config_default(&dtx_config);
+  AudxDtx *dtx = audx_dtx_create(&dtx_config);
+  const int64_t t0 = bench_now_ns();
+  for (int f = 0; f < frames; f++)
+    audx_dtx_update(dtx, vad[f], &out[(size_t)f * n], n, nullptr);
+  const double dtx_ns = (double)(bench_now_ns() - t0) / frames;
+  audx_dtx_destroy(dtx);
+  printf("  decision %.0f ns/frame, %.2f%% of a %.0f ns session frame\n",
+         dtx_ns, 100.0 * dtx_ns / session_ns, session_ns);
+}
+
+/* --- Driver --- */
+
+struct BenchCase {
+  const char *name;
+  void (*run)();
+};
+
+static const BenchCase CASES[] = {
+    {"bypass", bench_bypass},
+    {"resampler", bench_resampler},
+    {"halfband", bench_halfband},
+    {"bandwidth", bench_bandwidth},
+    {"scratch", bench_scratch},
+    {"prefault", bench_prefault},
+    {"cpp", bench_cpp},
+    {"edf", bench_edf},
+    {"affinity", bench_affinity},
+    {"fused", bench_fused},
+    {"reprocess", bench_reprocess},
+    {"prime", bench_prime},
+    {"speaker", bench_speaker},
+    {"tables", bench_tables},
+    {"events", bench_events},
+    {"monitor", bench_monitor},
+    {"timestamps", bench_timestamps},
+    {"vmath", bench_vmath},
+    {"deterministic", bench_deterministic},
+    {"params", bench_params},
+    {"layout", bench_layout},
+    {"numa", bench_numa},
+    {"dtx", bench_dtx},
+};
+
+int main(int argc, char **argv) {
+  int ran = 0;
+  for (const BenchCase &c : CASES) {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc; i++)
+      selected |= strcmp(argv[i], c.name) == 0;
+    if (!selected)
+      continue;
+    c.run();
+    ran++;
+  }
+
+  if (ran == 0) {
+    fprintf(stderr, "usage: %s [case ...]\n", argv[0]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,390 @@
+// Behavioural regression checks for scheduling, bypass and detection paths
+// that the latency harness does not exercise.
+//
+//   burst   a burst of frames on an idle engine is spread across all idle
+//           workers in every affinity mode, so it finishes in about
+//           frames / workers done-callback times
+//   bypass  bypassed output is the input delayed by the session's reported
+//           latency, so it lines up with the denoised path it crossfades
+//           with
+//   degrade frames an engine degrades are delayed and timestamped like
+//           processed ones, and still reach the session's event ring
+//   speaker a talker whose frames reach the detector with jitter (bursts
+//           and empty ticks) keeps the floor against a steady, quieter one
+//   timestamps
+//           stream timestamps stay exact for sample positions hours and
+//           years past the last timestamp written
+//
+// Usage: audx_check [--check] [case ...]   (no case names runs all)
+// With --check the exit status is 1 if a case fails.
+
+#include "engine.h"
+#include "events.h"
+#include "session.h"
+#include "speaker.h"
+#include "stream.h"
+
+#include "bench_util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+struct CaseResult {
+  bool passed;
+};
+
+/* --- burst --- */
+
+#define BURST_WORKERS 4
+#define BURST_STREAMS 16
+#define BURST_ROUNDS 5
+#define BURST_DONE_MS 3
+// A round may take this many times the ideal frames / workers callbacks
+#define BURST_SLACK 2.0
+
+struct BurstDone {
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+};
+
+static void burst_done(void *ctx, int, float, int) {
+  auto *done = (BurstDone *)ctx;
+  {
+    std::lock_guard<std::mutex> guard(done->mutex);
+    done->threads.insert(std::this_thread::get_id());
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(BURST_DONE_MS));
+}
+
+static CaseResult check_burst() {
+  static const char *const NAMES[] = {"shared", "steal", "home"};
+  const int rate = 16000, n = rate / 100;
+  bool passed = true;
+
+  for (int affinity = AUDX_AFFINITY_SHARED; affinity <= AUDX_AFFINITY_HOME;
+       affinity++) {
+    AudxEngineConfig config;
+    audx_engine_config_default(&config);
+    config.threads = BURST_WORKERS;
+    config.affinity = affinity;
+    AudxEngine *engine = audx_engine_create(&config);
+
+    AudxSessionConfig session_config;
+    audx_session_config_default(&session_config);
+    session_config.in_rate = rate;
+    std::vector<AudxSession *> sessions;
+    for (int s = 0; s < BURST_STREAMS; s++) {
+      sessions.push_back(audx_session_create(&session_config));
+      audx_engine_add_stream(engine, sessions.back(), AUDX_PRIORITY_NORMAL,
+                             AUDX_LATE_PROCESS);
+    }
+
+    std::vector<short> in((size_t)BURST_STREAMS * n, 0);
+    std::vector<short> out(in.size());
+    BurstDone done;
+    size_t fewest_threads = BURST_WORKERS;
+    int64_t elapsed = 0;
+    for (int round = 0; round < BURST_ROUNDS; round++) {
+      done.threads.clear();
+      const int64_t start = bench_now_ns();
+      for (int s = 0; s < BURST_STREAMS; s++)
+        audx_engine_submit(engine, s, &in[(size_t)s * n],
+                           &out[(size_t)s * n], INT64_MAX, burst_done, &done);
+      audx_engine_drain(engine);
+      elapsed += bench_now_ns() - start;
+      fewest_threads = std::min(fewest_threads, done.threads.size());
+    }
+
+    const double ms = (double)elapsed / BURST_ROUNDS / 1e6;
+    const double ideal =
+        (double)BURST_STREAMS / BURST_WORKERS * BURST_DONE_MS;
+    const bool ok = fewest_threads == BURST_WORKERS && ms <= ideal * BURST_SLACK;
+    printf("burst  %-6s %d workers  %2zu used (fewest in a round)  "
+           "%5.1f ms/round  ideal %4.1f%s\n",
+           NAMES[affinity], BURST_WORKERS, fewest_threads, ms, ideal,
+           ok ? "" : "  FAIL");
+    passed &= ok;
+
+    audx_engine_destroy(engine);
+    for (AudxSession *session : sessions)
+      audx_session_destroy(session);
+  }
+  return {passed};
+}
+
+/* --- bypass --- */
+
+#define BYPASS_FRAMES 20
+// Frames after which the fade into bypass is over
+#define BYPASS_SETTLE_FRAMES 2
+
+static CaseResult check_bypass() {
+  static const unsigned int RATES[] = {8000, 16000, 44100, 48000, 22050};
+  bool passed = true;
+
+  for (unsigned int rate : RATES) {
+    AudxSessionConfig config;
+    audx_session_config_default(&config);
+    config.in_rate = rate;
+    AudxSession *session = audx_session_create(&config);
+    const int n = audx_session_frame_samples(session);
+    const int64_t delay = (audx_session_delay_ns(session) * rate +
+                           500000000LL) / 1000000000LL;
+    audx_session_set_bypass(session, 1);
+
+    // A ramp has a distinct value at every position, so any offset shows
+    std::vector<short> in((size_t)BYPASS_FRAMES * n), out(in.size());
+    for (size_t i = 0; i < in.size(); i++)
+      in[i] = (short)(i % 30000 + 1);
+    for (int f = 0; f < BYPASS_FRAMES; f++) {
+      std::copy_n(&in[(size_t)f * n], n, &out[(size_t)f * n]);
+      audx_session_process_int(session, &out[(size_t)f * n],
+                               &out[(size_t)f * n]);
+    }
+
+    int mismatches = 0;
+    for (size_t t = (size_t)BYPASS_SETTLE_FRAMES * n + delay; t < out.size();
+         t++)
+      mismatches += out[t] != in[t - delay];
+    const bool ok = mismatches == 0;
+    printf("bypass %5u Hz  delay %3lld samples  %d misaligned%s\n", rate,
+           (long long)delay, mismatches, ok ? "" : "  FAIL");
+    passed &= ok;
+    audx_session_destroy(session);
+  }
+  return {passed};
+}
+
+/* --- degrade --- */
+
+#define DEGRADE_FRAMES 10
+
+struct DegradeDone {
+  int degraded = 0;
+  int64_t pts_error = 0; // largest |pts - expected| seen
+  int64_t expected;
+};
+
+static void degrade_done(void *ctx, int, float, int status, int64_t pts_ns) {
+  auto *done = (DegradeDone *)ctx;
+  done->degraded += status == AUDX_FRAME_DEGRADED;
+  done->pts_error = std::max(done->pts_error, std::abs(pts_ns - done->expected));
+}
+
+static CaseResult check_degrade() {
+  const unsigned int rate = 16000;
+  AudxEngineConfig config;
+  audx_engine_config_default(&config);
+  config.threads = 1;
+  AudxEngine *engine = audx_engine_create(&config);
+
+  AudxSessionConfig session_config;
+  audx_session_config_default(&session_config);
+  session_config.in_rate = rate;
+  AudxSession *session = audx_session_create(&session_config);
+  AudxEventRing *events = audx_events_create(4 * DEGRADE_FRAMES);
+  audx_session_set_events(session, events, 0);
+  const int stream = audx_engine_add_stream(engine, session,
+                                            AUDX_PRIORITY_NORMAL,
+                                            AUDX_LATE_DEGRADE);
+  const int n = audx_session_frame_samples(session);
+  const int64_t delay_ns = audx_session_delay_ns(session);
+  const int64_t delay =
+      (delay_ns * rate + 500000000LL) / 1000000000LL;
+
+  std::vector<short> in((size_t)DEGRADE_FRAMES * n), out(in.size());
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = (short)(i % 30000 + 1);
+  DegradeDone done;
+  for (int f = 0; f < DEGRADE_FRAMES; f++) {
+    // A deadline already passed makes every frame hopeless
+    const int64_t timestamp = (int64_t)f * 10000000LL;
+    done.expected = timestamp - delay_ns;
+    audx_engine_submit_ts(engine, stream, &in[(size_t)f * n],
+                          &out[(size_t)f * n], 0, timestamp, degrade_done,
+                          &done);
+    audx_engine_drain(engine);
+  }
+
+  int mismatches = 0;
+  for (size_t t = delay; t < out.size(); t++)
+    mismatches += out[t] != in[t - delay];
+  std::vector<AudxEvent> drained(4 * DEGRADE_FRAMES);
+  const size_t count =
+      audx_events_drain(events, drained.data(), drained.size());
+  int vad_events = 0;
+  for (size_t i = 0; i < count; i++)
+    vad_events += drained[i].type == AUDX_EVENT_VAD;
+  const bool ok = done.degraded == DEGRADE_FRAMES && mismatches == 0 &&
+                  done.pts_error == 0 && vad_events == DEGRADE_FRAMES;
+  printf("degrade %d/%d degraded  delay %lld samples  %d misaligned  "
+         "pts error %lld ns  %d VAD events%s\n",
+         done.degraded, DEGRADE_FRAMES, (long long)delay, mismatches,
+         (long long)done.pts_error, vad_events, ok ? "" : "  FAIL");
+
+  audx_engine_destroy(engine);
+  audx_session_destroy(session);
+  audx_events_destroy(events);
+  return {ok};
+}
+
+/* --- speaker --- */
+
+#define SPEAKER_TICKS 1000
+// Frames of the jittered talker arrive up to this late, in 10ms frames
+#define SPEAKER_JITTER_FRAMES 1.5
+// Ticks until stream 0 has taken the floor: stream 1 may hold it until the
+// first jittered frames arrive and then for switch_frames
+#define SPEAKER_SETTLE_TICKS 50
+
+struct SpeakerChanges {
+  int count = 0;
+  int last = -1;
+};
+
+static void speaker_changed(void *ctx, int, int current) {
+  auto *changes = (SpeakerChanges *)ctx;
+  changes->count++;
+  changes->last = current;
+}
+
+static CaseResult check_speaker() {
+  AudxSpeakerConfig config;
+  audx_speaker_config_default(&config);
+  SpeakerChanges changes;
+  AudxSpeakerDetector *detector =
+      audx_speaker_create(&config, 2, speaker_changed, &changes);
+
+  // Stream 0 talks 8 dB above stream 1, but its frames are delivered with
+  // jitter: some ticks see none, the next sees two
+  BenchRng rng(5);
+  double arrival = 0.0; // in frame periods, never earlier than the previous
+  int delivered = 0, empty_ticks = 0, talking_ticks = 0, settled = 0;
+  for (int tick = 0; tick < SPEAKER_TICKS; tick++) {
+    if (tick == SPEAKER_SETTLE_TICKS)
+      settled = changes.count;
+    int frames = 0;
+    while (delivered < SPEAKER_TICKS) {
+      const double next =
+          std::max(arrival, delivered + SPEAKER_JITTER_FRAMES * 0.5 *
+                                            (rng.uniform() + 1.0f));
+      if (next > tick + 1)
+        break;
+      arrival = next;
+      audx_speaker_update_energy(detector, 0, 0.9f, 60.0f);
+      delivered++;
+      frames++;
+    }
+    empty_ticks += frames == 0;
+    audx_speaker_update_energy(detector, 1, 0.9f, 52.0f);
+    audx_speaker_tick(detector);
+    talking_ticks += audx_speaker_talking(detector, 0);
+  }
+
+  // Once stream 0 has the floor it must keep it, and keep talking
+  const int flips = changes.count - settled;
+  const bool ok = empty_ticks > 0 && flips == 0 && changes.last == 0 &&
+                  talking_ticks >= SPEAKER_TICKS - SPEAKER_SETTLE_TICKS;
+  printf("speaker %d ticks  %d without a frame  %d changes after settling  "
+         "active %d  talking %d/%d%s\n",
+         SPEAKER_TICKS, empty_ticks, flips, changes.last, talking_ticks,
+         SPEAKER_TICKS, ok ? "" : "  FAIL");
+  audx_speaker_destroy(detector);
+  return {ok};
+}
+
+/* --- timestamps --- */
+
+// 200 hours without a timestamp, then 200 million seconds past one: both
+// overflowed 64-bit nanosecond products
+#define TIMESTAMP_UNANCHORED_S 720000LL
+#define TIMESTAMP_ANCHORED_S 200000000LL
+#define TIMESTAMP_ANCHOR_NS 1000000000000000LL
+
+static CaseResult check_timestamps() {
+  static const unsigned int RATES[] = {44100, 48000};
+  bool passed = true;
+
+  for (unsigned int rate : RATES) {
+    AudxSessionConfig config;
+    audx_session_config_default(&config);
+    config.in_rate = rate;
+    AudxStream *stream = audx_stream_create(&config, 4);
+    // One sample past a whole second checks the remainder is kept
+    const int64_t tail_ns = 1000000000LL / rate;
+
+    const int64_t unanchored = audx_stream_input_timestamp(
+        stream, (uint64_t)(TIMESTAMP_UNANCHORED_S * rate + 1));
+    const int64_t unanchored_error =
+        unanchored - (TIMESTAMP_UNANCHORED_S * 1000000000LL + tail_ns);
+
+    std::vector<short> frame((size_t)audx_session_frame_samples(
+        audx_stream_session(stream)));
+    audx_stream_write_ts(stream, frame.data(), (unsigned int)frame.size(),
+                         TIMESTAMP_ANCHOR_NS);
+    const int64_t anchored = audx_stream_input_timestamp(
+        stream, (uint64_t)(TIMESTAMP_ANCHORED_S * rate + 1));
+    const int64_t anchored_error =
+        anchored - (TIMESTAMP_ANCHOR_NS +
+                    TIMESTAMP_ANCHORED_S * 1000000000LL + tail_ns);
+
+    const bool ok = unanchored_error == 0 && anchored_error == 0;
+    printf("timestamps %5u Hz  unanchored error %lld ns  anchored error "
+           "%lld ns%s\n",
+           rate, (long long)unanchored_error, (long long)anchored_error,
+           ok ? "" : "  FAIL");
+    passed &= ok;
+    audx_stream_destroy(stream);
+  }
+  return {passed};
+}
+
+/* --- Driver --- */
+
+struct CheckCase {
+  const char *name;
+  CaseResult (*run)();
+};
+
+static const CheckCase CASES[] = {
+    {"burst", check_burst},
+    {"bypass", check_bypass},
+    {"degrade", check_degrade},
+    {"speaker", check_speaker},
+    {"timestamps", check_timestamps},
+};
+
+int main(int argc, char **argv) {
+  bool check = false;
+  int ran = 0, failures = 0;
+  std::vector<const char *> names;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--check") == 0)
+      check = true;
+    else
+      names.push_back(argv[i]);
+  }
+
+  for (const CheckCase &c : CASES) {
+    bool selected = names.empty();
+    for (const char *name : names)
+      selected |= strcmp(name, c.name) == 0;
+    if (!selected)
+      continue;
+    failures += !c.run().passed;
+    ran++;
+  }
+
+  if (ran == 0) {
+    fprintf(stderr, "usage: %s [--check] [case ...]\n", argv[0]);
+    return 1;
+  }
+  return check && failures ? 1 : 0;
+}
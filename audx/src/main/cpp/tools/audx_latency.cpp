@@ -0,0 +1,252 @@
+// Capture-to-playback latency harness on a simulated clock.
+//
+// A capture device and a render device are simulated with their own period
+// size, clock drift (ppm) and callback jitter. Captured periods are written
+// to an AudxStream and render periods are read from it, in the order the
+// callbacks would fire. The input carries tone bursts with sharp onsets;
+// each onset is found again in the played signal, which gives the latency
+// from the ADC to the DAC for that burst.
+//
+// Usage: audx_latency [--check] [case ...]   (no case names runs all)
+// With --check the exit status is 1 if a case exceeds its latency or
+// underrun budget. Latency budgets are absolute capture-to-playback figures
+// per rate pair: buffering plus the wrapper's resampling, plus the core's
+// one-frame delay as a fixed constant. A regression anywhere on the path,
+// the library's own processing included, counts against them.
+
+#include "bench_util.h"
+#include "stream.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const double SIM_SECONDS = 30.0;
+static const double BURST_INTERVAL_S = 0.5;
+static const double BURST_MS = 5.0;
+static const float BURST_AMPLITUDE = 16000.0f;
+static const float NOISE_AMPLITUDE = 30.0f;
+static const float ONSET_THRESHOLD = 0.2f * BURST_AMPLITUDE;
+static const double ONSET_QUIET_S = 0.1; // silence required before an onset
+// The core's overlap-add synthesis delay, one 10ms frame for every build.
+// Builds without it (test stubs) simply measure that much under budget.
+static const double CORE_DELAY_MS = 10.0;
+
+struct DeviceConfig {
+  unsigned int period; // samples per callback
+  double ppm;          // sample clock error
+  double jitter_ms;    // callbacks are delayed by up to this much
+};
+
+struct LatencyCase {
+  const char *name;
+  unsigned int rate;
+  DeviceConfig capture;
+  DeviceConfig render;
+  unsigned int prebuffer; // samples queued before playback starts
+  int queue_frames;
+  double max_latency_ms; // --check budgets; CORE_DELAY_MS comes on top
+  int max_underruns;
+};
+
+// clang-format off
+static const LatencyCase CASES[] = {
+    // name            rate   capture            render             prebuf q  max ms underruns
+    {"aligned-10ms",   48000, {480, 0, 0},       {480, 0, 0},       480,  8, 12.0,  0},
+    {"android-fast",   48000, {192, 0, 0.5},     {192, 0, 0.5},     384,  8, 18.0,  0},
+    {"mismatched",     48000, {960, 0, 1.0},     {256, 0, 1.0},     1024, 8, 45.0,  0},
+    // 16 kHz pays about 13ms of resampling to and from the core's 48 kHz
+    {"wideband-16k",   16000, {320, 0, 1.0},     {160, 0, 1.0},     480,  8, 68.0,  0},
+    {"drift-fast-cap", 48000, {480, 100, 1.0},   {480, -100, 1.0},  960,  8, 38.0,  0},
+    {"drift-slow-cap", 48000, {480, -300, 1.0},  {480, 300, 1.0},   480,  8, 30.0,  8},
+    {"jitter-capture", 48000, {240, 0, 6.0},     {240, 0, 0},       240,  8, 30.0,  4},
+};
+// clang-format on
+
+struct Device {
+  DeviceConfig config;
+  double sample_rate; // actual rate of the device clock
+  double jitter_s;
+  uint64_t callbacks;
+  double last_time;
+
+  // Time at which the next callback fires
+  double next_time(BenchRng &rng) const {
+    const double ideal = (double)(callbacks + 1) * config.period / sample_rate;
+    const double t = ideal + jitter_s * 0.5 * (rng.uniform() + 1.0f);
+    return t > last_time ? t : last_time;
+  }
+};
+
+struct LatencyResult {
+  int bursts;
+  int detected;
+  double min_ms, mean_ms, max_ms;
+  int underruns;
+  uint64_t dropped;
+};
+
+// Index of every sample where |x| first reaches the onset threshold after
+// at least ONSET_QUIET_S of quiet
+static std::vector<size_t> find_onsets(const std::vector<short> &x,
+                                       unsigned int rate) {
+  std::vector<size_t> onsets;
+  const size_t quiet_needed = (size_t)(ONSET_QUIET_S * rate);
+  size_t quiet = quiet_needed;
+  for (size_t i = 0; i < x.size(); i++) {
+    if (std::fabs((float)x[i]) >= ONSET_THRESHOLD) {
+      if (quiet >= quiet_needed)
+        onsets.push_back(i);
+      quiet = 0;
+    } else {
+      quiet++;
+    }
+  }
+  return onsets;
+}
+
+static std::vector<short> make_input(unsigned int rate, size_t samples) {
+  BenchRng rng(7);
+  std::vector<short> x(samples);
+  const size_t interval = (size_t)(BURST_INTERVAL_S * rate);
+  const size_t burst = (size_t)(BURST_MS * rate / 1000.0);
+  for (size_t i = 0; i < samples; i++) {
+    float v = NOISE_AMPLITUDE * rng.uniform();
+    const size_t phase = i % interval;
+    if (i >= interval && phase < burst)
+      v += BURST_AMPLITUDE * (float)std::sin(2.0 * M_PI * 1000.0 * phase / rate);
+    x[i] = (short)v;
+  }
+  return x;
+}
+
+static AudxStream *create_stream(unsigned int rate, int queue_frames) {
+  AudxSessionConfig config;
+  audx_session_config_default(&config);
+  config.in_rate = rate;
+  return audx_stream_create(&config, queue_frames);
+}
+
+static LatencyResult run_case(const LatencyCase &c) {
+  AudxStream *stream = create_stream(c.rate, c.queue_frames);
+
+  Device capture = {c.capture, c.rate * (1.0 + c.capture.ppm * 1e-6),
+                    c.capture.jitter_ms / 1000.0, 0, 0.0};
+  Device render = {c.render, c.rate * (1.0 + c.render.ppm * 1e-6),
+                   c.render.jitter_ms / 1000.0, 0, 0.0};
+
+  const size_t total = (size_t)(SIM_SECONDS * c.rate);
+  const std::vector<short> input = make_input(c.rate, total + c.capture.period);
+  std::vector<short> played;
+  played.reserve(total + c.render.period);
+  std::vector<short> period(c.render.period);
+
+  BenchRng rng(11);
+  double next_capture = capture.next_time(rng);
+  double next_render = render.next_time(rng);
+  bool playing = false;
+  LatencyResult result = {};
+
+  while (played.size() < total) {
+    if (next_capture <= next_render) {
+      // Samples [k * period, (k + 1) * period) are complete at this point
+      const size_t offset = (size_t)capture.callbacks * c.capture.period;
+      const int accepted =
+          audx_stream_write(stream, &input[offset], c.capture.period);
+      result.dropped += c.capture.period - accepted;
+      capture.last_time = next_capture;
+      capture.callbacks++;
+      next_capture = capture.next_time(rng);
+    } else {
+      // The period filled now plays after the one currently playing
+      if (!playing && audx_stream_available(stream) >= c.prebuffer)
+        playing = true;
+      int got = 0;
+      if (playing) {
+        got = audx_stream_read(stream, period.data(), c.render.period);
+        if (got < (int)c.render.period)
+          result.underruns++;
+      }
+      memset(period.data() + got, 0, (c.render.period - got) * sizeof(short));
+      played.insert(played.end(), period.begin(), period.end());
+      render.last_time = next_render;
+      render.callbacks++;
+      next_render = render.next_time(rng);
+    }
+  }
+  audx_stream_destroy(stream);
+
+  // Pair each played onset with the earliest captured one before it
+  const std::vector<size_t> in_onsets = find_onsets(input, c.rate);
+  const std::vector<size_t> out_onsets = find_onsets(played, c.rate);
+  result.min_ms = 1e30;
+  double sum = 0.0;
+  size_t next_in = 0;
+  for (size_t out : out_onsets) {
+    const double play_s = (double)(out + c.render.period) / render.sample_rate;
+    while (next_in < in_onsets.size()) {
+      const double capture_s = (double)in_onsets[next_in] / capture.sample_rate;
+      const double latency_ms = (play_s - capture_s) * 1000.0;
+      if (latency_ms < 0.0)
+        break; // spurious onset, nothing captured yet
+      next_in++;
+      if (latency_ms > 1000.0 * BURST_INTERVAL_S)
+        continue; // this burst was lost
+      result.detected++;
+      sum += latency_ms;
+      result.min_ms = std::min(result.min_ms, latency_ms);
+      result.max_ms = std::max(result.max_ms, latency_ms);
+      break;
+    }
+  }
+  for (size_t in : in_onsets)
+    if ((double)in / capture.sample_rate < played.size() / render.sample_rate)
+      result.bursts++;
+  result.mean_ms = result.detected ? sum / result.detected : 0.0;
+  if (!result.detected)
+    result.min_ms = 0.0;
+  return result;
+}
+
+int main(int argc, char **argv) {
+  bool check = false;
+  std::vector<const char *> names;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--check") == 0)
+      check = true;
+    else
+      names.push_back(argv[i]);
+  }
+
+  printf("%-15s %6s %9s %9s %9s %9s %7s %9s %8s\n", "case", "rate",
+         "budget ms", "min ms", "mean ms", "max ms", "hits", "underrun",
+         "dropped");
+
+  int failures = 0, ran = 0;
+  for (const LatencyCase &c : CASES) {
+    bool selected = names.empty();
+    for (const char *name : names)
+      selected |= strcmp(name, c.name) == 0;
+    if (!selected)
+      continue;
+    ran++;
+
+    const double budget_ms = c.max_latency_ms + CORE_DELAY_MS;
+    const LatencyResult r = run_case(c);
+    const bool missed = r.detected < r.bursts * 9 / 10;
+    const bool failed = r.max_ms > budget_ms ||
+                        r.underruns > c.max_underruns || missed;
+    printf("%-15s %6u %9.2f %9.2f %9.2f %9.2f %3d/%-3d %9d %8llu%s\n",
+           c.name, c.rate, budget_ms, r.min_ms, r.mean_ms, r.max_ms,
+           r.detected, r.bursts, r.underruns, (unsigned long long)r.dropped,
+           check && failed ? "  FAIL" : "");
+    failures += failed;
+  }
+
+  if (ran == 0) {
+    fprintf(stderr, "unknown case\n");
+    return 2;
+  }
+  return check && failures ? 1 : 0;
+}
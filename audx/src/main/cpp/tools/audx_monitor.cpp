@@ -0,0 +1,105 @@
+// Samples a monitor page (monitor.h) published by another process and
+// prints per-stream rates for each interval:
+//   fps       frames handled per second
+//   rtf       processing time over audio time
+//   late      processed after the deadline, % of frames
+//   drop      dropped or degraded, % of frames
+//   speech    frames with VAD >= 0.5, % of processed frames
+//   vad       VAD of the last frame
+//   age       time since the stream last published, in ms
+// The page is mapped read-only and read through its seqlock, so sampling
+// never blocks or slows the writer.
+//
+// Usage: audx_monitor path [--interval ms] [--count n]
+
+#include "monitor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#include <vector>
+
+static uint64_t monotonic_ns() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static double percent(uint64_t part, uint64_t whole) {
+  return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+int main(int argc, char **argv) {
+  const char *path = nullptr;
+  int interval_ms = 1000;
+  int count = 0; // until interrupted
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+      interval_ms = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+      count = atoi(argv[++i]);
+    } else if (!path && argv[i][0] != '-') {
+      path = argv[i];
+    } else {
+      path = nullptr;
+      break;
+    }
+  }
+  if (!path || interval_ms < 1) {
+    fprintf(stderr, "usage: %s path [--interval ms] [--count n]\n", argv[0]);
+    return 2;
+  }
+
+  AudxMonitor *monitor = audx_monitor_open(path);
+  if (!monitor) {
+    fprintf(stderr, "%s: not a monitor page of version %d\n", path,
+            AUDX_MONITOR_VERSION);
+    return 1;
+  }
+
+  const int slots = audx_monitor_slots(monitor);
+  std::vector<AudxMonitorSlot> previous(slots), current(slots);
+  for (int s = 0; s < slots; s++)
+    audx_monitor_read(monitor, s, &previous[s]);
+
+  for (int sample = 0; count == 0 || sample < count; sample++) {
+    usleep((useconds_t)interval_ms * 1000);
+    const uint64_t now = monotonic_ns();
+    const double seconds = interval_ms / 1000.0;
+
+    printf("%6s %8s %7s %6s %6s %7s %5s %8s\n", "stream", "fps", "rtf",
+           "late%", "drop%", "speech%", "vad", "age ms");
+    for (int s = 0; s < slots; s++) {
+      AudxMonitorSlot &cur = current[s];
+      if (audx_monitor_read(monitor, s, &cur) != 0) {
+        printf("%6d  writer stopped mid-update\n", s);
+        continue;
+      }
+      if (!cur.active)
+        continue;
+
+      AudxMonitorSlot &prev = previous[s];
+      const uint64_t frames = cur.frames - prev.frames;
+      const uint64_t skipped =
+          cur.dropped - prev.dropped + cur.degraded - prev.degraded;
+      const double rtf =
+          frames ? (double)(cur.busy_ns - prev.busy_ns) /
+                       (double)(frames * AUDX_MONITOR_FRAME_NS)
+                 : 0.0;
+      printf("%6d %8.1f %7.3f %6.2f %6.2f %7.1f %5.2f %8.1f\n", s,
+             (double)frames / seconds, rtf,
+             percent(cur.late - prev.late, frames), percent(skipped, frames),
+             percent(cur.speech_frames - prev.speech_frames, frames - skipped),
+             cur.last_vad,
+             now > cur.updated_ns ? (double)(now - cur.updated_ns) / 1e6
+                                  : 0.0);
+      prev = cur;
+    }
+    fflush(stdout);
+  }
+
+  audx_monitor_destroy(monitor);
+  return 0;
+}
@@ -0,0 +1,332 @@
+// Quality-versus-cost sweep over session configurations.
+//
+// Every configuration processes the synthetic corpus (speech-like signal
+// plus white noise at several SNRs) and is scored against the clean
+// reference:
+//   segsnr    segmental SNR over speech frames in dB, frames clamped to
+//             [-10, 35]
+//   lsd       log-spectral distance over speech frames in dB, within the
+//             band the reference occupies
+//   vad       fraction of frames where VAD > 0.5 matches speech activity
+//   ns/frame  processing time per 10ms frame (fastest corpus item)
+// The output is aligned to the reference first (cross-correlation), so the
+// resampling and core delays do not count as distortion. A configuration is
+// on the Pareto frontier when no other one is at least as good on all four
+// and better on one.
+//
+// Usage: audx_sweep [--csv file] [--all] [--seconds n]
+// Prints every configuration with the frontier marked and writes the
+// frontier (with --all, every configuration) as CSV to `file`, "-" for
+// stdout.
+
+#include "bench_util.h"
+#include "session.h"
+#include "vmath.h"
+
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static const float CORPUS_SNR_DB[] = {0.0f, 5.0f, 10.0f, 20.0f};
+static const int QUALITIES[] = {0, 2, 4, 7, 10};
+static const unsigned int RATES[] = {8000, 16000, 24000, 32000, 44100, 48000};
+static const unsigned int CORPUS_BANDWIDTH = 4000; // of bench_clean_speech
+static const float SEGSNR_MIN_DB = -10.0f;
+static const float SEGSNR_MAX_DB = 35.0f;
+static const float SPEECH_FLOOR = 0.01f; // frame RMS relative to the loudest
+static const float VAD_THRESHOLD = 0.5f;
+static const double MAX_DELAY_S = 0.05;
+
+struct SweepConfig {
+  unsigned int rate;
+  int quality;
+  unsigned int bandwidth; // 0 for full band
+};
+
+struct SweepResult {
+  SweepConfig config;
+  double ns_per_frame;
+  double segsnr_db;
+  double lsd_db;
+  double vad_accuracy;
+  int delay; // samples
+  bool pareto;
+};
+
+struct CorpusItem {
+  std::vector<float> clean;
+  std::vector<short> noisy;
+  std::vector<char> speech; // per frame
+};
+
+static std::vector<CorpusItem> make_corpus(unsigned int rate, int seconds) {
+  const int n = rate / 100;
+  std::vector<CorpusItem> corpus;
+  uint32_t seed = 7;
+  for (float snr : CORPUS_SNR_DB) {
+    CorpusItem item;
+    item.clean = bench_clean_speech(rate, n * 100 * seconds, seed);
+    item.noisy = bench_to_int16(bench_add_noise(item.clean, snr, seed + 4));
+    seed += 2;
+
+    const int frames = (int)item.clean.size() / n;
+    std::vector<float> rms(frames);
+    float loudest = 0.0f;
+    for (int f = 0; f < frames; f++) {
+      double sum = 0.0;
+      for (int i = 0; i < n; i++)
+        sum += (double)item.clean[f * n + i] * item.clean[f * n + i];
+      rms[f] = (float)std::sqrt(sum / n);
+      loudest = std::max(loudest, rms[f]);
+    }
+    item.speech.resize(frames);
+    for (int f = 0; f < frames; f++)
+      item.speech[f] = rms[f] > SPEECH_FLOOR * loudest;
+    corpus.push_back(std::move(item));
+  }
+  return corpus;
+}
+
+// In-place radix-2 FFT; size is a power of two
+static void fft(std::vector<std::complex<float>> &x) {
+  const size_t size = x.size();
+  for (size_t i = 1, j = 0; i < size; i++) {
+    size_t bit = size >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j)
+      std::swap(x[i], x[j]);
+  }
+  for (size_t len = 2; len <= size; len <<= 1) {
+    const float angle = -2.0f * (float)M_PI / (float)len;
+    const std::complex<float> step(cosf(angle), sinf(angle));
+    for (size_t i = 0; i < size; i += len) {
+      std::complex<float> w(1.0f, 0.0f);
+      for (size_t k = 0; k < len / 2; k++) {
+        const std::complex<float> a = x[i + k];
+        const std::complex<float> b = x[i + k + len / 2] * w;
+        x[i + k] = a + b;
+        x[i + k + len / 2] = a - b;
+        w *= step;
+      }
+    }
+  }
+}
+
+// Hann-windowed power spectrum of one frame, zero-padded to `size`
+static void power_spectrum(const float *frame, int n, size_t size,
+                           std::vector<float> &power) {
+  std::vector<std::complex<float>> x(size);
+  for (int i = 0; i < n; i++) {
+    const float w = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (n - 1));
+    x[i] = frame[i] * w;
+  }
+  fft(x);
+  power.resize(size / 2 + 1);
+  for (size_t k = 0; k <= size / 2; k++)
+    power[k] = std::norm(x[k]);
+}
+
+// Lag of `out` against `clean` with the highest correlation
+static int estimate_delay(const std::vector<float> &clean,
+                          const std::vector<short> &out, unsigned int rate) {
+  const int max_lag = (int)(MAX_DELAY_S * rate);
+  const size_t span = std::min<size_t>(clean.size(), 2 * rate) - max_lag;
+  int best = 0;
+  double best_corr = -1e300;
+  for (int lag = 0; lag <= max_lag; lag++) {
+    double corr = 0.0;
+    for (size_t i = 0; i < span; i++)
+      corr += (double)clean[i] * out[i + lag];
+    if (corr > best_corr) {
+      best_corr = corr;
+      best = lag;
+    }
+  }
+  return best;
+}
+
+static SweepResult run_config(const SweepConfig &config,
+                              const std::vector<CorpusItem> &corpus) {
+  AudxSessionConfig session_config;
+  audx_session_config_default(&session_config);
+  session_config.in_rate = config.rate;
+  session_config.resample_quality = config.quality;
+  session_config.bandwidth = config.bandwidth;
+
+  const int n = config.rate / 100;
+  std::vector<std::vector<short>> outputs;
+  std::vector<std::vector<float>> vads;
+  double ns_per_frame = 1e30;
+  for (const CorpusItem &item : corpus) {
+    AudxSession *session = audx_session_create(&session_config);
+    const int frames = (int)item.noisy.size() / n;
+    std::vector<short> out(item.noisy.size()), in(n);
+    std::vector<float> vad(frames);
+    const int64_t start = bench_now_ns();
+    for (int f = 0; f < frames; f++) {
+      memcpy(in.data(), &item.noisy[(size_t)f * n], n * sizeof(short));
+      vad[f] =
+          audx_session_process_int(session, in.data(), &out[(size_t)f * n]);
+    }
+    ns_per_frame =
+        std::min(ns_per_frame, (double)(bench_now_ns() - start) / frames);
+    audx_session_destroy(session);
+    outputs.push_back(std::move(out));
+    vads.push_back(std::move(vad));
+  }
+
+  SweepResult result = {};
+  result.config = config;
+  result.ns_per_frame = ns_per_frame;
+  // The cleanest item gives the most reliable alignment
+  result.delay = estimate_delay(corpus.back().clean, outputs.back(),
+                                config.rate);
+
+  size_t fft_size = 1;
+  while (fft_size < (size_t)n)
+    fft_size <<= 1;
+  const size_t band_bins = (size_t)CORPUS_BANDWIDTH * fft_size / config.rate;
+  const size_t bins = std::min(fft_size / 2, band_bins) + 1;
+  std::vector<float> aligned(n), clean_power, out_power, ratio(bins);
+  double segsnr = 0.0, lsd = 0.0;
+  int speech_frames = 0, vad_hits = 0, vad_frames = 0;
+  for (size_t c = 0; c < corpus.size(); c++) {
+    const CorpusItem &item = corpus[c];
+    const std::vector<short> &out = outputs[c];
+    const int frames = (int)item.speech.size();
+    for (int f = 0; f < frames; f++) {
+      vad_hits += (vads[c][f] > VAD_THRESHOLD) == (bool)item.speech[f];
+      vad_frames++;
+
+      const size_t at = (size_t)f * n;
+      if (!item.speech[f] || at + n + result.delay > out.size())
+        continue;
+      const float *ref = &item.clean[at];
+      double signal = 0.0, error = 0.0;
+      for (int i = 0; i < n; i++) {
+        aligned[i] = out[at + result.delay + i];
+        signal += (double)ref[i] * ref[i];
+        error += (double)(ref[i] - aligned[i]) * (ref[i] - aligned[i]);
+      }
+      const double snr = 10.0 * std::log10((signal + 1e-9) / (error + 1e-9));
+      segsnr += std::min<double>(SEGSNR_MAX_DB,
+                                 std::max<double>(SEGSNR_MIN_DB, snr));
+
+      power_spectrum(ref, n, fft_size, clean_power);
+      power_spectrum(aligned.data(), n, fft_size, out_power);
+      for (size_t k = 0; k < bins; k++)
+        ratio[k] = (clean_power[k] + 1.0f) / (out_power[k] + 1.0f);
+      audx_vlog(ratio.data(), ratio.data(), (int)bins);
+      double sum = 0.0;
+      for (size_t k = 0; k < bins; k++) {
+        const double d = (10.0 / M_LN10) * ratio[k];
+        sum += d * d;
+      }
+      lsd += std::sqrt(sum / bins);
+      speech_frames++;
+    }
+  }
+  result.segsnr_db = segsnr / std::max(speech_frames, 1);
+  result.lsd_db = lsd / std::max(speech_frames, 1);
+  result.vad_accuracy = (double)vad_hits / std::max(vad_frames, 1);
+  return result;
+}
+
+// a is at least as good as b everywhere and better somewhere
+static bool dominates(const SweepResult &a, const SweepResult &b) {
+  const bool no_worse = a.ns_per_frame <= b.ns_per_frame &&
+                        a.segsnr_db >= b.segsnr_db && a.lsd_db <= b.lsd_db &&
+                        a.vad_accuracy >= b.vad_accuracy;
+  const bool better = a.ns_per_frame < b.ns_per_frame ||
+                      a.segsnr_db > b.segsnr_db || a.lsd_db < b.lsd_db ||
+                      a.vad_accuracy > b.vad_accuracy;
+  return no_worse && better;
+}
+
+static void write_csv(FILE *file, const std::vector<SweepResult> &results,
+                      bool all) {
+  fprintf(file, "rate,quality,bandwidth,ns_per_frame,segsnr_db,lsd_db,"
+                "vad_accuracy,delay_samples,pareto\n");
+  for (const SweepResult &r : results) {
+    if (!all && !r.pareto)
+      continue;
+    fprintf(file, "%u,%d,%u,%.0f,%.3f,%.3f,%.4f,%d,%d\n", r.config.rate,
+            r.config.quality, r.config.bandwidth, r.ns_per_frame, r.segsnr_db,
+            r.lsd_db, r.vad_accuracy, r.delay, r.pareto ? 1 : 0);
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *csv_path = nullptr;
+  bool all = false;
+  int seconds = 10;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+      csv_path = argv[++i];
+    } else if (strcmp(argv[i], "--all") == 0) {
+      all = true;
+    } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+      seconds = std::max(1, atoi(argv[++i]));
+    } else {
+      fprintf(stderr, "usage: %s [--csv file] [--all] [--seconds n]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  // Quality and bandwidth only matter where the input is resampled
+  std::vector<SweepConfig> configs;
+  for (unsigned int rate : RATES) {
+    if (rate == FRAME_RATE) {
+      configs.push_back({rate, 4, 0});
+      continue;
+    }
+    for (int quality : QUALITIES) {
+      configs.push_back({rate, quality, 0});
+      if (CORPUS_BANDWIDTH < rate / 2)
+        configs.push_back({rate, quality, CORPUS_BANDWIDTH});
+    }
+  }
+
+  std::vector<SweepResult> results;
+  unsigned int corpus_rate = 0;
+  std::vector<CorpusItem> corpus;
+  printf("%6s %7s %9s %10s %9s %8s %8s %6s  %s\n", "rate", "quality",
+         "bandwidth", "ns/frame", "segsnr", "lsd", "vad", "delay", "pareto");
+  for (const SweepConfig &config : configs) {
+    if (config.rate != corpus_rate) {
+      corpus = make_corpus(config.rate, seconds);
+      corpus_rate = config.rate;
+    }
+    results.push_back(run_config(config, corpus));
+  }
+
+  for (SweepResult &r : results) {
+    r.pareto = true;
+    for (const SweepResult &other : results)
+      if (dominates(other, r)) {
+        r.pareto = false;
+        break;
+      }
+    printf("%6u %7d %9u %10.0f %9.2f %8.2f %8.3f %6d  %s\n", r.config.rate,
+           r.config.quality, r.config.bandwidth, r.ns_per_frame, r.segsnr_db,
+           r.lsd_db, r.vad_accuracy, r.delay, r.pareto ? "*" : "");
+  }
+
+  if (csv_path) {
+    const bool to_stdout = strcmp(csv_path, "-") == 0;
+    FILE *file = to_stdout ? stdout : fopen(csv_path, "w");
+    if (!file) {
+      fprintf(stderr, "cannot write %s\n", csv_path);
+      return 1;
+    }
+    write_csv(file, results, all);
+    if (!to_stdout)
+      fclose(file);
+  }
+  return 0;
+}
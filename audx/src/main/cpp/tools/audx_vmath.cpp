@@ -0,0 +1,176 @@
+// Accuracy of the vmath.h functions against double-precision libm.
+//
+// Every function is evaluated over a dense sweep of its documented domain:
+// evenly spaced points for bounded domains, and a stride through the float
+// bit patterns (so every binade is covered) for positive inputs. Errors are
+// in ulps of the float nearest the exact result. Each build of the kernels
+// the host can run is checked: the scalar one, the baseline SIMD one and
+// the one the library dispatches to.
+//
+// Usage: audx_vmath [--check]
+// With --check the exit status is 1 if a function exceeds the bound
+// documented in vmath.h.
+
+#include "vmath.h"
+#include "vmath_impl.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const int LINEAR_POINTS = 1 << 22;
+static const uint32_t BIT_STRIDE = 257; // odd, so mantissas vary
+
+typedef void (*ArrayFn)(const float *x, float *y, int n);
+
+struct Domain {
+  bool bits; // sweep bit patterns in [lo, hi] instead of evenly spaced
+  float lo, hi;
+};
+
+struct Function {
+  const char *name;
+  double (*reference)(double);
+  Domain domains[2];
+  double max_ulp; // vmath.h bound
+  ArrayFn scalar, base, dispatched;
+};
+
+static double ref_sigmoid(double x) { return 1.0 / (1.0 + exp(-x)); }
+static double ref_rsqrt(double x) { return 1.0 / sqrt(x); }
+
+template <class V, class K> static void build(const float *x, float *y,
+                                              int n) {
+  vmath::apply<V, K>(x, y, n);
+}
+
+#if defined(HAS_X86_SIMD)
+typedef vmath::SseOps BaseOps;
+#elif defined(HAS_ARM_NEON)
+typedef vmath::NeonOps BaseOps;
+#else
+typedef vmath::ScalarOps BaseOps;
+#endif
+
+#define BUILDS(K)                                                              \
+  build<vmath::ScalarOps, vmath::K>, build<BaseOps, vmath::K>
+
+static const Domain NONE = {false, 0.0f, 0.0f};
+
+static const Function FUNCTIONS[] = {
+    {"exp", exp, {{false, -87.0f, 88.0f}, NONE}, 2, BUILDS(Exp), audx_vexp},
+    {"log",
+     log,
+     {{true, FLT_MIN, FLT_MAX}, {false, 0.5f, 2.0f}},
+     2,
+     BUILDS(Log),
+     audx_vlog},
+    {"tanh",
+     tanh,
+     {{false, -10.0f, 10.0f}, {true, FLT_MIN, 1.0f}},
+     2,
+     BUILDS(Tanh),
+     audx_vtanh},
+    {"sigmoid",
+     ref_sigmoid,
+     {{false, -87.0f, 88.0f}, NONE},
+     3,
+     BUILDS(Sigmoid),
+     audx_vsigmoid},
+    {"rsqrt",
+     ref_rsqrt,
+     {{true, FLT_MIN, FLT_MAX}, NONE},
+     4,
+     BUILDS(Rsqrt),
+     audx_vrsqrt},
+};
+
+static uint32_t bits_of(float f) {
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+static float float_of(uint32_t u) {
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+static std::vector<float> sweep(const Domain &d) {
+  std::vector<float> x;
+  if (d.bits) {
+    // Positive floats order like their bit patterns
+    for (uint64_t u = bits_of(d.lo); u <= bits_of(d.hi); u += BIT_STRIDE)
+      x.push_back(float_of((uint32_t)u));
+    x.push_back(d.hi);
+  } else if (d.hi > d.lo) {
+    for (int i = 0; i <= LINEAR_POINTS; i++)
+      x.push_back(d.lo + (d.hi - d.lo) * (float)((double)i / LINEAR_POINTS));
+  }
+  return x;
+}
+
+static double ulp_error(float y, double exact) {
+  const float nearest = (float)exact;
+  const float next = nextafterf(fabsf(nearest), INFINITY);
+  const double ulp = (double)next - (double)fabsf(nearest);
+  return fabs((double)y - exact) / ulp;
+}
+
+struct Accuracy {
+  double max_ulp;
+  float worst_x;
+};
+
+static Accuracy measure(const Function &f, ArrayFn fn) {
+  Accuracy acc = {0.0, 0.0f};
+  for (const Domain &d : f.domains) {
+    const std::vector<float> x = sweep(d);
+    std::vector<float> y(x.size());
+    fn(x.data(), y.data(), (int)x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+      const double e = ulp_error(y[i], f.reference((double)x[i]));
+      if (!(e <= acc.max_ulp)) { // also catches NaN
+        acc.max_ulp = e;
+        acc.worst_x = x[i];
+      }
+    }
+  }
+  return acc;
+}
+
+int main(int argc, char **argv) {
+  bool check = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--check") == 0) {
+      check = true;
+    } else {
+      fprintf(stderr, "usage: %s [--check]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  printf("dispatch: %s\n", audx_vmath_isa());
+  printf("%-8s %-10s %9s %14s %6s\n", "function", "build", "max ulp", "at x",
+         "bound");
+  int failures = 0;
+  for (const Function &f : FUNCTIONS) {
+    const struct {
+      const char *name;
+      ArrayFn fn;
+    } builds[] = {{"scalar", f.scalar},
+                  {"base", f.base},
+                  {audx_vmath_isa(), f.dispatched}};
+    for (const auto &b : builds) {
+      const Accuracy acc = measure(f, b.fn);
+      const bool failed = !(acc.max_ulp <= f.max_ulp);
+      printf("%-8s %-10s %9.3f %14.7g %6.0f%s\n", f.name, b.name, acc.max_ulp,
+             acc.worst_x, f.max_ulp, check && failed ? "  FAIL" : "");
+      failures += failed;
+    }
+  }
+  return check && failures ? 1 : 0;
+}
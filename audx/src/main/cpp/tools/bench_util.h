@@ -0,0 +1,144 @@
+#ifndef AUDX_BENCH_UTIL_H
+#define AUDX_BENCH_UTIL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* --- Host tool helpers --- */
+
+static inline int64_t bench_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Deterministic LCG so every run sees the same corpus
+struct BenchRng {
+  uint32_t state;
+  explicit BenchRng(uint32_t seed) : state(seed ? seed : 1) {}
+  float uniform() { // [-1, 1)
+    state = state * 1664525u + 1013904223u;
+    return (float)(int32_t)state / 2147483648.0f;
+  }
+};
+
+// Speech-like clean signal: harmonic bursts with a slowly moving pitch,
+// separated by pauses. Amplitude is in int16 units.
+static inline std::vector<float> bench_clean_speech(unsigned int rate,
+                                                    int samples,
+                                                    uint32_t seed = 7) {
+  std::vector<float> out(samples, 0.0f);
+  BenchRng rng(seed);
+  const float bandwidth = std::min(4000.0f, rate * 0.45f);
+  double phase = 0.0;
+  int pos = 0;
+  while (pos < samples) {
+    const int talk = (int)(rate * (0.25f + 0.15f * (rng.uniform() + 1.0f)));
+    const int pause = (int)(rate * (0.15f + 0.10f * (rng.uniform() + 1.0f)));
+    const float f0 = 150.0f + 40.0f * rng.uniform();
+    for (int i = 0; i < talk && pos < samples; i++, pos++) {
+      const float env = sinf((float)M_PI * (float)i / (float)talk);
+      const float f = f0 * (1.0f + 0.05f * sinf(6.0f * (float)i / rate));
+      phase += 2.0 * M_PI * f / rate;
+      float v = 0.0f;
+      for (int h = 1; f * h < bandwidth; h++)
+        v += sinf((float)(phase * h)) / (float)h;
+      out[pos] = 6000.0f * env * v;
+    }
+    pos += pause;
+  }
+  return out;
+}
+
+// White noise scaled to the requested SNR against `clean`
+static inline std::vector<float> bench_add_noise(const std::vector<float> &clean,
+                                                 float snr_db,
+                                                 uint32_t seed = 11) {
+  double energy = 0.0;
+  for (float v : clean)
+    energy += (double)v * v;
+  const double rms = std::sqrt(energy / std::max<size_t>(clean.size(), 1));
+  const float noise_rms = (float)(rms / std::pow(10.0, snr_db / 20.0));
+  BenchRng rng(seed);
+  std::vector<float> out(clean.size());
+  for (size_t i = 0; i < clean.size(); i++)
+    out[i] = clean[i] + noise_rms * 1.732f * rng.uniform();
+  return out;
+}
+
+static inline std::vector<short> bench_to_int16(const std::vector<float> &in) {
+  std::vector<short> out(in.size());
+  for (size_t i = 0; i < in.size(); i++)
+    out[i] = (short)std::max(-32768.0f, std::min(32767.0f, in[i]));
+  return out;
+}
+
+static inline double bench_percentile(std::vector<int64_t> values, double p) {
+  if (values.empty())
+    return 0.0;
+  std::sort(values.begin(), values.end());
+  size_t idx = (size_t)(p / 100.0 * (double)(values.size() - 1) + 0.5);
+  return (double)values[std::min(idx, values.size() - 1)];
+}
+
+// Hardware counter for the calling thread. valid() is false when perf
+// events are unavailable (e.g. perf_event_paranoid or no PMU in a VM).
+struct BenchPerfCounter {
+  int fd = -1;
+
+  // With `inherit`, threads created after start() are counted too; their
+  // counts are added when they exit
+  BenchPerfCounter(uint32_t type, uint64_t config, bool inherit = false) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = inherit;
+    fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+  ~BenchPerfCounter() {
+#ifdef __linux__
+    if (fd >= 0)
+      close(fd);
+#endif
+  }
+  bool valid() const { return fd >= 0; }
+  void start() {
+#ifdef __linux__
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+  uint64_t stop() {
+    uint64_t value = 0;
+#ifdef __linux__
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd, &value, sizeof(value)) != sizeof(value))
+        value = 0;
+    }
+#endif
+    return value;
+  }
+};
+
+#endif // AUDX_BENCH_UTIL_H
@@ -0,0 +1,63 @@
+#include "vmath.h"
+#include "vmath_impl.h"
+
+using namespace vmath;
+
+#if defined(HAS_X86_SIMD)
+typedef SseOps BaseOps;
+#define VMATH_BASE_ISA "sse4.1"
+#elif defined(HAS_ARM_NEON)
+typedef NeonOps BaseOps;
+#define VMATH_BASE_ISA "neon"
+#else
+typedef ScalarOps BaseOps;
+#define VMATH_BASE_ISA "scalar"
+#endif
+
+typedef void (*VmathFn)(const float *x, float *y, int n);
+
+struct VmathTable {
+  VmathFn exp, log, tanh, sigmoid, rsqrt;
+  const char *isa;
+};
+
+#if defined(HAS_X86_SIMD)
+// vmath_avx2.cpp, built with -mavx2 -mfma; only called when the CPU has both
+void audx_vmath_avx2_exp(const float *x, float *y, int n);
+void audx_vmath_avx2_log(const float *x, float *y, int n);
+void audx_vmath_avx2_tanh(const float *x, float *y, int n);
+void audx_vmath_avx2_sigmoid(const float *x, float *y, int n);
+void audx_vmath_avx2_rsqrt(const float *x, float *y, int n);
+#endif
+
+static VmathTable select_table() {
+#if defined(HAS_X86_SIMD)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return {audx_vmath_avx2_exp,     audx_vmath_avx2_log,
+            audx_vmath_avx2_tanh,    audx_vmath_avx2_sigmoid,
+            audx_vmath_avx2_rsqrt,   "avx2"};
+#endif
+  return {apply<BaseOps, Exp>,     apply<BaseOps, Log>,
+          apply<BaseOps, Tanh>,    apply<BaseOps, Sigmoid>,
+          apply<BaseOps, Rsqrt>,   VMATH_BASE_ISA};
+}
+
+static const VmathTable &table() {
+  static const VmathTable t = select_table();
+  return t;
+}
+
+void audx_vexp(const float *x, float *y, int n) { table().exp(x, y, n); }
+
+void audx_vlog(const float *x, float *y, int n) { table().log(x, y, n); }
+
+void audx_vtanh(const float *x, float *y, int n) { table().tanh(x, y, n); }
+
+void audx_vsigmoid(const float *x, float *y, int n) {
+  table().sigmoid(x, y, n);
+}
+
+void audx_vrsqrt(const float *x, float *y, int n) { table().rsqrt(x, y, n); }
+
+const char *audx_vmath_isa(void) { return table().isa; }
@@ -0,0 +1,37 @@
+#ifndef AUDX_VMATH_H
+#define AUDX_VMATH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Vector math --- */
+// Polynomial approximations of transcendental functions over float arrays,
+// vectorised with AVX2+FMA (picked at run time), SSE4.1 or NEON, and a
+// scalar build of the same polynomials elsewhere and for array tails.
+// Bounds are relative errors against double-precision references over the
+// stated domains, as checked by `audx_vmath --check`:
+//
+//   audx_vexp      2 ulp   x in [-87, 88]; saturates outside
+//   audx_vlog      2 ulp   x > 0; below FLT_MIN clamps to log(FLT_MIN)
+//   audx_vtanh     2 ulp   all x; |x| >= 9 returns +-1
+//   audx_vsigmoid  3 ulp   x >= -87 (absolute error 2e-38 below)
+//   audx_vrsqrt    4 ulp   positive normal x (estimate + Newton step)
+//
+// `y` may alias `x`. Results can differ between instruction sets in the
+// last bit (FMA contraction).
+
+void audx_vexp(const float *x, float *y, int n);
+void audx_vlog(const float *x, float *y, int n);
+void audx_vtanh(const float *x, float *y, int n);
+void audx_vsigmoid(const float *x, float *y, int n);
+void audx_vrsqrt(const float *x, float *y, int n);
+
+// "avx2", "sse4.1", "neon" or "scalar"
+const char *audx_vmath_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDX_VMATH_H
@@ -0,0 +1,30 @@
+// AVX2+FMA builds of the vmath kernels. Compiled with -mavx2 -mfma on x86
+// only; vmath.cpp calls into it after checking the CPU supports both.
+
+#include "vmath_impl.h"
+
+#ifndef __AVX2__
+#error "vmath_avx2.cpp must be compiled with -mavx2 -mfma"
+#endif
+
+using namespace vmath;
+
+void audx_vmath_avx2_exp(const float *x, float *y, int n) {
+  apply<Avx2Ops, Exp>(x, y, n);
+}
+
+void audx_vmath_avx2_log(const float *x, float *y, int n) {
+  apply<Avx2Ops, Log>(x, y, n);
+}
+
+void audx_vmath_avx2_tanh(const float *x, float *y, int n) {
+  apply<Avx2Ops, Tanh>(x, y, n);
+}
+
+void audx_vmath_avx2_sigmoid(const float *x, float *y, int n) {
+  apply<Avx2Ops, Sigmoid>(x, y, n);
+}
+
+void audx_vmath_avx2_rsqrt(const float *x, float *y, int n) {
+  apply<Avx2Ops, Rsqrt>(x, y, n);
+}
@@ -0,0 +1,327 @@
+#ifndef AUDX_VMATH_IMPL_H
+#define AUDX_VMATH_IMPL_H
+
+// Kernels behind vmath.h, written once against a small set of vector
+// operations and instantiated per instruction set. Included by vmath.cpp and
+// by vmath_avx2.cpp, which is compiled with -mavx2 -mfma; not part of the
+// public API.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(HAS_X86_SIMD)
+#include <immintrin.h>
+#elif defined(HAS_ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Everything here has internal linkage: the AVX2 translation unit must not
+// lend its copies of shared inline functions to the baseline one.
+namespace vmath {
+namespace {
+
+/* --- Operations --- */
+// Each Ops type provides F (float lanes), I (int32 lanes), kWidth and the
+// same static functions; fma(a, b, c) is a * b + c, fused where the target
+// has it.
+
+struct ScalarOps {
+  typedef float F;
+  typedef int32_t I;
+  static constexpr int kWidth = 1;
+  static F load(const float *p) { return *p; }
+  static void store(float *p, F v) { *p = v; }
+  static F set(float v) { return v; }
+  static F add(F a, F b) { return a + b; }
+  static F sub(F a, F b) { return a - b; }
+  static F mul(F a, F b) { return a * b; }
+  static F div(F a, F b) { return a / b; }
+  static F fma(F a, F b, F c) { return a * b + c; }
+  static F min(F a, F b) { return a < b ? a : b; }
+  static F max(F a, F b) { return a > b ? a : b; }
+  static F round(F a) { return rintf(a); }
+  static I to_int(F a) { return (I)a; } // a is integral
+  static F to_float(I a) { return (F)a; }
+  static F as_float(I a) {
+    F f;
+    memcpy(&f, &a, sizeof(f));
+    return f;
+  }
+  static I as_int(F a) {
+    I i;
+    memcpy(&i, &a, sizeof(i));
+    return i;
+  }
+  static I iset(int32_t v) { return v; }
+  static I iadd(I a, I b) { return (I)((uint32_t)a + (uint32_t)b); }
+  static I iand(I a, I b) { return a & b; }
+  static I ior(I a, I b) { return a | b; }
+  static I ixor(I a, I b) { return a ^ b; }
+  static I shl23(I a) { return (I)((uint32_t)a << 23); }
+  static I shr23(I a) { return (I)((uint32_t)a >> 23); }
+  // Mask of a < b, as all-ones int lanes
+  static I lt(F a, F b) { return a < b ? -1 : 0; }
+  static F select(I mask, F a, F b) { return mask ? a : b; }
+  static F rsqrt(F a) { return 1.0f / sqrtf(a); }
+};
+
+#if defined(HAS_X86_SIMD)
+struct SseOps {
+  typedef __m128 F;
+  typedef __m128i I;
+  static constexpr int kWidth = 4;
+  static F load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, F v) { _mm_storeu_ps(p, v); }
+  static F set(float v) { return _mm_set1_ps(v); }
+  static F add(F a, F b) { return _mm_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+  static F div(F a, F b) { return _mm_div_ps(a, b); }
+  static F fma(F a, F b, F c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static F min(F a, F b) { return _mm_min_ps(a, b); }
+  static F max(F a, F b) { return _mm_max_ps(a, b); }
+  static F round(F a) {
+    return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static I to_int(F a) { return _mm_cvttps_epi32(a); }
+  static F to_float(I a) { return _mm_cvtepi32_ps(a); }
+  static F as_float(I a) { return _mm_castsi128_ps(a); }
+  static I as_int(F a) { return _mm_castps_si128(a); }
+  static I iset(int32_t v) { return _mm_set1_epi32(v); }
+  static I iadd(I a, I b) { return _mm_add_epi32(a, b); }
+  static I iand(I a, I b) { return _mm_and_si128(a, b); }
+  static I ior(I a, I b) { return _mm_or_si128(a, b); }
+  static I ixor(I a, I b) { return _mm_xor_si128(a, b); }
+  static I shl23(I a) { return _mm_slli_epi32(a, 23); }
+  static I shr23(I a) { return _mm_srli_epi32(a, 23); }
+  static I lt(F a, F b) { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+  static F select(I mask, F a, F b) {
+    return _mm_blendv_ps(b, a, _mm_castsi128_ps(mask));
+  }
+  // 12-bit estimate and one Newton-Raphson step
+  static F rsqrt(F a) {
+    const F y = _mm_rsqrt_ps(a);
+    const F r = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_mul_ps(a, y), y));
+    return _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), y), r));
+  }
+};
+
+#ifdef __AVX2__
+struct Avx2Ops {
+  typedef __m256 F;
+  typedef __m256i I;
+  static constexpr int kWidth = 8;
+  static F load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, F v) { _mm256_storeu_ps(p, v); }
+  static F set(float v) { return _mm256_set1_ps(v); }
+  static F add(F a, F b) { return _mm256_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+  static F div(F a, F b) { return _mm256_div_ps(a, b); }
+  static F fma(F a, F b, F c) { return _mm256_fmadd_ps(a, b, c); }
+  static F min(F a, F b) { return _mm256_min_ps(a, b); }
+  static F max(F a, F b) { return _mm256_max_ps(a, b); }
+  static F round(F a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static I to_int(F a) { return _mm256_cvttps_epi32(a); }
+  static F to_float(I a) { return _mm256_cvtepi32_ps(a); }
+  static F as_float(I a) { return _mm256_castsi256_ps(a); }
+  static I as_int(F a) { return _mm256_castps_si256(a); }
+  static I iset(int32_t v) { return _mm256_set1_epi32(v); }
+  static I iadd(I a, I b) { return _mm256_add_epi32(a, b); }
+  static I iand(I a, I b) { return _mm256_and_si256(a, b); }
+  static I ior(I a, I b) { return _mm256_or_si256(a, b); }
+  static I ixor(I a, I b) { return _mm256_xor_si256(a, b); }
+  static I shl23(I a) { return _mm256_slli_epi32(a, 23); }
+  static I shr23(I a) { return _mm256_srli_epi32(a, 23); }
+  static I lt(F a, F b) {
+    return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+  }
+  static F select(I mask, F a, F b) {
+    return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(mask));
+  }
+  static F rsqrt(F a) {
+    const F y = _mm256_rsqrt_ps(a);
+    const F r = _mm256_fnmadd_ps(_mm256_mul_ps(a, y), y, _mm256_set1_ps(1.0f));
+    return _mm256_fmadd_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), y), r, y);
+  }
+};
+#endif // __AVX2__
+
+#elif defined(HAS_ARM_NEON)
+struct NeonOps {
+  typedef float32x4_t F;
+  typedef int32x4_t I;
+  static constexpr int kWidth = 4;
+  static F load(const float *p) { return vld1q_f32(p); }
+  static void store(float *p, F v) { vst1q_f32(p, v); }
+  static F set(float v) { return vdupq_n_f32(v); }
+  static F add(F a, F b) { return vaddq_f32(a, b); }
+  static F sub(F a, F b) { return vsubq_f32(a, b); }
+  static F mul(F a, F b) { return vmulq_f32(a, b); }
+  static F div(F a, F b) { return vdivq_f32(a, b); }
+  static F fma(F a, F b, F c) { return vfmaq_f32(c, a, b); }
+  static F min(F a, F b) { return vminq_f32(a, b); }
+  static F max(F a, F b) { return vmaxq_f32(a, b); }
+  static F round(F a) { return vrndnq_f32(a); }
+  static I to_int(F a) { return vcvtq_s32_f32(a); }
+  static F to_float(I a) { return vcvtq_f32_s32(a); }
+  static F as_float(I a) { return vreinterpretq_f32_s32(a); }
+  static I as_int(F a) { return vreinterpretq_s32_f32(a); }
+  static I iset(int32_t v) { return vdupq_n_s32(v); }
+  static I iadd(I a, I b) { return vaddq_s32(a, b); }
+  static I iand(I a, I b) { return vandq_s32(a, b); }
+  static I ior(I a, I b) { return vorrq_s32(a, b); }
+  static I ixor(I a, I b) { return veorq_s32(a, b); }
+  static I shl23(I a) { return vshlq_n_s32(a, 23); }
+  static I shr23(I a) {
+    return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), 23));
+  }
+  static I lt(F a, F b) { return vreinterpretq_s32_u32(vcltq_f32(a, b)); }
+  static F select(I mask, F a, F b) {
+    return vbslq_f32(vreinterpretq_u32_s32(mask), a, b);
+  }
+  // 8-bit estimate and two Newton-Raphson steps
+  static F rsqrt(F a) {
+    F y = vrsqrteq_f32(a);
+    y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+    return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+  }
+};
+#endif
+
+/* --- Kernels --- */
+// Cephes single-precision polynomials with Cody-Waite range reduction.
+
+#define VMATH_EXP_HI 88.0f
+#define VMATH_EXP_LO -87.0f
+#define VMATH_TANH_SMALL 0.625f
+#define VMATH_TANH_HI 9.0f
+
+template <class V> inline typename V::F exp_v(typename V::F x) {
+  typedef typename V::F F;
+  x = V::min(V::max(x, V::set(VMATH_EXP_LO)), V::set(VMATH_EXP_HI));
+
+  // x = n ln2 + r, |r| <= ln2 / 2, with ln2 split so n ln2 is exact
+  const F n = V::round(V::mul(x, V::set(1.44269504088896341f)));
+  F r = V::fma(n, V::set(-0.693359375f), x);
+  r = V::fma(n, V::set(2.12194440e-4f), r);
+
+  F p = V::set(1.9875691500e-4f);
+  p = V::fma(p, r, V::set(1.3981999507e-3f));
+  p = V::fma(p, r, V::set(8.3334519073e-3f));
+  p = V::fma(p, r, V::set(4.1665795894e-2f));
+  p = V::fma(p, r, V::set(1.6666665459e-1f));
+  p = V::fma(p, r, V::set(5.0000001201e-1f));
+  p = V::fma(p, V::mul(r, r), V::add(r, V::set(1.0f)));
+
+  // 2^n built in the exponent field; n is within [-126, 127]
+  const F scale =
+      V::as_float(V::shl23(V::iadd(V::to_int(n), V::iset(127))));
+  return V::mul(p, scale);
+}
+
+template <class V> inline typename V::F log_v(typename V::F x) {
+  typedef typename V::F F;
+  typedef typename V::I I;
+  x = V::max(x, V::set(1.17549435e-38f)); // FLT_MIN
+
+  // x = m 2^e with m in [0.5, 1)
+  const I bits = V::as_int(x);
+  F e = V::to_float(V::iadd(V::shr23(bits), V::iset(-126)));
+  F m = V::as_float(
+      V::ior(V::iand(bits, V::iset(0x007fffff)), V::iset(0x3f000000)));
+
+  // Fold m into [sqrt(0.5), sqrt(2)) and take log(1 + m)
+  const I small = V::lt(m, V::set(0.707106781186547524f));
+  e = V::select(small, V::sub(e, V::set(1.0f)), e);
+  m = V::sub(V::select(small, V::add(m, m), m), V::set(1.0f));
+
+  const F z = V::mul(m, m);
+  F p = V::set(7.0376836292e-2f);
+  p = V::fma(p, m, V::set(-1.1514610310e-1f));
+  p = V::fma(p, m, V::set(1.1676998740e-1f));
+  p = V::fma(p, m, V::set(-1.2420140846e-1f));
+  p = V::fma(p, m, V::set(1.4249322787e-1f));
+  p = V::fma(p, m, V::set(-1.6668057665e-1f));
+  p = V::fma(p, m, V::set(2.0000714765e-1f));
+  p = V::fma(p, m, V::set(-2.4999993993e-1f));
+  p = V::fma(p, m, V::set(3.3333331174e-1f));
+  F y = V::mul(V::mul(p, m), z);
+  y = V::fma(e, V::set(-2.12194440e-4f), y);
+  y = V::fma(z, V::set(-0.5f), y);
+  return V::fma(e, V::set(0.693359375f), V::add(m, y));
+}
+
+template <class V> inline typename V::F tanh_v(typename V::F x) {
+  typedef typename V::F F;
+  typedef typename V::I I;
+  const I sign = V::iand(V::as_int(x), V::iset((int32_t)0x80000000));
+  const F a = V::min(V::as_float(V::ixor(V::as_int(x), sign)),
+                     V::set(VMATH_TANH_HI));
+
+  // Small |x|: odd polynomial, avoiding the cancellation in 1 - 2/(e+1)
+  const F z = V::mul(a, a);
+  F p = V::set(-5.70498872745e-3f);
+  p = V::fma(p, z, V::set(2.06390887954e-2f));
+  p = V::fma(p, z, V::set(-5.37397155531e-2f));
+  p = V::fma(p, z, V::set(1.33314422036e-1f));
+  p = V::fma(p, z, V::set(-3.33332819422e-1f));
+  const F near = V::fma(V::mul(p, z), a, a);
+
+  const F e = exp_v<V>(V::add(a, a));
+  const F far = V::sub(V::set(1.0f),
+                       V::div(V::set(2.0f), V::add(e, V::set(1.0f))));
+
+  const F y = V::select(V::lt(a, V::set(VMATH_TANH_SMALL)), near, far);
+  return V::as_float(V::ixor(V::as_int(y), sign));
+}
+
+template <class V> inline typename V::F sigmoid_v(typename V::F x) {
+  typedef typename V::F F;
+  typedef typename V::I I;
+  // With t = exp(-|x|): 1 / (1 + t) for x >= 0 and t / (1 + t) below, so
+  // the large exp(-x) of negative x never feeds the division
+  const I negative = V::lt(x, V::set(0.0f));
+  const F t = exp_v<V>(V::as_float(V::ior(V::as_int(x),
+                                         V::iset((int32_t)0x80000000))));
+  const F s = V::div(V::set(1.0f), V::add(V::set(1.0f), t));
+  return V::select(negative, V::mul(t, s), s);
+}
+
+template <class V> inline typename V::F rsqrt_v(typename V::F x) {
+  return V::rsqrt(x);
+}
+
+/* --- Array drivers --- */
+
+#define VMATH_KERNEL(Name, fn)                                                 \
+  struct Name {                                                                \
+    template <class V> static typename V::F eval(typename V::F x) {            \
+      return fn<V>(x);                                                         \
+    }                                                                          \
+  };
+
+VMATH_KERNEL(Exp, exp_v)
+VMATH_KERNEL(Log, log_v)
+VMATH_KERNEL(Tanh, tanh_v)
+VMATH_KERNEL(Sigmoid, sigmoid_v)
+VMATH_KERNEL(Rsqrt, rsqrt_v)
+
+#undef VMATH_KERNEL
+
+// Full vectors with V, the tail with the scalar build of the same kernel
+template <class V, class K> void apply(const float *x, float *y, int n) {
+  int i = 0;
+  for (; i + V::kWidth <= n; i += V::kWidth)
+    V::store(y + i, K::template eval<V>(V::load(x + i)));
+  for (; i < n; i++)
+    y[i] = K::template eval<ScalarOps>(x[i]);
+}
+
+} // namespace
+} // namespace vmath
+
+#endif // AUDX_VMATH_IMPL_H
@@ -11,12 +11,33 @@ import java.util.concurrent.atomic.AtomicBoolean
  *                     Audio will be automatically resampled to 48kHz for internal processing if needed.
  * @property resampleQuality Resampler quality level (0-10). Higher values provide better quality but slower processing.
  *                           Use predefined constants like [Audx.AUDX_RESAMPLER_QUALITY_VOIP] for common use cases.
- * @throws IllegalArgumentException if inputRate is not positive or resampleQuality is outside valid range
+ * @property bypassWarmInterval While bypassed, the denoiser is fed one frame out of every
+ *                              [bypassWarmInterval] frames to keep its noise estimate warm (0-16).
+ *                              1 tracks every frame, 0 stops tracking entirely.
+ * @property bandwidth Highest frequency present in the input in Hz, or [Audx.BANDWIDTH_FULL].
+ *                     For band-limited sources (e.g. narrowband telephony) the resampling
+ *                     around the denoiser uses much shorter filters. At most inputRate / 2.
+ * @property prefaultMemory Touch all processing memory at creation so the first frame does not
+ *                          page-fault. See [Audx.prefault] for re-warming after long idle periods.
+ *                          The per-thread working buffers are prefaulted on the first frame of
+ *                          the processing thread, or by calling [Audx.prefault] on that thread.
+ * @property lockMemory Lock processing memory (mlock) so it cannot be paged out. Falls back to
+ *                      prefault-only if the process is not allowed to lock memory. The
+ *                      per-thread working buffers are locked on the processing thread, as above.
+ * @property deterministic Produce bit-identical output on arm64 and x86_64 for the same input,
+ *                         for golden tests and cached results. Needs a core built the same way;
+ *                         input rates that are not a multiple of 100 are not covered.
+ * @throws IllegalArgumentException if inputRate is not positive or a parameter is outside valid range
  * @see Audx
  */
 data class AudxConfig(
     var inputRate: Int = Audx.FRAME_RATE,
     var resampleQuality: Int = Audx.AUDX_RESAMPLER_QUALITY_DEFAULT,
+    var bypassWarmInterval: Int = Audx.BYPASS_WARM_INTERVAL_DEFAULT,
+    var bandwidth: Int = Audx.BANDWIDTH_FULL,
+    var prefaultMemory: Boolean = false,
+    var lockMemory: Boolean = false,
+    var deterministic: Boolean = false,
 ) {
     init {
         require(
@@ -28,6 +49,14 @@ data class AudxConfig(
         require(inputRate > 0) {
             "inputRate must be positive, got: $inputRate"
         }
+        require(bypassWarmInterval in 0..Audx.BYPASS_WARM_INTERVAL_MAX) {
+            "bypassWarmInterval must be between 0 and ${Audx.BYPASS_WARM_INTERVAL_MAX}, " +
+                "got: $bypassWarmInterval"
+        }
+        require(bandwidth == Audx.BANDWIDTH_FULL || bandwidth in 1..inputRate / 2) {
+            "bandwidth must be ${Audx.BANDWIDTH_FULL} (full band) or between 1 and " +
+                "${inputRate / 2}, got: $bandwidth"
+        }
     }
 }
 
@@ -65,6 +94,7 @@ data class AudxConfig(
  *
  * ## Thread Safety
  * - NOT thread-safe for concurrent process() calls
+ * - setBypass(), setStrength() and setAgc() may be called from any thread while process() runs
  * - Callbacks execute on the calling thread
  * - close() is thread-safe and idempotent
  *
@@ -93,6 +123,8 @@ class Audx(
     private val closed = AtomicBoolean(false)
     private val callbackLock = Any()
     private var frameCount = 0L
+    @Volatile private var bypassed = false
+    private var dtxPtr = 0L
     private val SKIP_FIRST_N_FRAMES = 1
 
     companion object {
@@ -113,6 +145,52 @@ class Audx(
 
         /** VoIP-optimized resampler quality (3) - tuned for real-time voice communication. */
         const val AUDX_RESAMPLER_QUALITY_VOIP: Int = 3
+
+        /** Default bypass warm interval (2) - the denoiser sees every other frame while bypassed. */
+        const val BYPASS_WARM_INTERVAL_DEFAULT: Int = 2
+
+        /** Maximum bypass warm interval (16). */
+        const val BYPASS_WARM_INTERVAL_MAX: Int = 16
+
+        /** Default AGC target speech level (-18 dBFS). */
+        const val AGC_TARGET_DB_DEFAULT: Float = -18f
+
+        /** Default AGC gain limit (18 dB). */
+        const val AGC_MAX_GAIN_DB_DEFAULT: Float = 18f
+
+        /** Largest AGC gain limit (40 dB). */
+        const val AGC_MAX_GAIN_DB_MAX: Float = 40f
+
+        // Field masks of the native parameter block (params.h)
+        private const val PARAM_STRENGTH = 1
+        private const val PARAM_AGC = 8
+
+        /** Input uses its full bandwidth (0) - default, no band-limited processing. */
+        const val BANDWIDTH_FULL: Int = 0
+
+        /** [dtxDecision]: speech or hangover, encode and send the frame. */
+        const val DTX_TRANSMIT: Int = 0
+
+        /** [dtxDecision]: silence, send a comfort-noise update at [comfortNoiseDb]. */
+        const val DTX_SID: Int = 1
+
+        /** [dtxDecision]: silence, skip the encoder for this frame. */
+        const val DTX_SILENT: Int = 2
+
+        /** Default DTX hangover (20 frames, 200ms). */
+        const val DTX_HANGOVER_DEFAULT: Int = 20
+
+        /** Narrowband telephony content (3400 Hz), e.g. 8kHz PSTN or Bluetooth SCO audio. */
+        const val BANDWIDTH_NARROWBAND: Int = 3_400
+
+        /** Wideband voice content (7000 Hz), e.g. 16kHz HD voice. */
+        const val BANDWIDTH_WIDEBAND: Int = 7_000
+
+        /** [memoryStatus] flag: processing memory was prefaulted at creation. */
+        const val MEMORY_PREFAULT: Int = 1
+
+        /** [memoryStatus] flag: processing memory is locked in RAM. */
+        const val MEMORY_LOCK: Int = 2
     }
 
     /**
@@ -126,11 +204,17 @@ class Audx(
      *     .build()
      * ```
      *
-     * Default values: inputRate = 48000, resampleQuality = 4
+     * Default values: inputRate = 48000, resampleQuality = 4, bypassWarmInterval = 2,
+     * bandwidth = full, prefaultMemory = false, lockMemory = false, deterministic = false
      */
     class Builder {
         private var inputRate = FRAME_RATE
         private var resampleQuality = AUDX_RESAMPLER_QUALITY_DEFAULT
+        private var bypassWarmInterval = BYPASS_WARM_INTERVAL_DEFAULT
+        private var bandwidth = BANDWIDTH_FULL
+        private var prefaultMemory = false
+        private var lockMemory = false
+        private var deterministic = false
 
         /**
          * Sets the input/output sample rate in Hz.
@@ -155,6 +239,69 @@ class Audx(
             return this
         }
 
+        /**
+         * Sets how often the denoiser is updated while bypassed.
+         *
+         * @param interval Feed one frame out of every [interval] frames (0-16). Lower values keep the
+         *                 noise estimate closer to the live signal at a higher CPU cost in bypass.
+         * @return This Builder instance for method chaining
+         * @see Audx.setBypass
+         */
+        fun bypassWarmInterval(interval: Int): Builder {
+            bypassWarmInterval = interval
+            return this
+        }
+
+        /**
+         * Declares the effective bandwidth of the input.
+         *
+         * @param hz Highest frequency present in the input, e.g. [BANDWIDTH_NARROWBAND], or
+         *           [BANDWIDTH_FULL]. Lower values allow cheaper band-limited resampling filters.
+         * @return This Builder instance for method chaining
+         */
+        fun bandwidth(hz: Int): Builder {
+            bandwidth = hz
+            return this
+        }
+
+        /**
+         * Prefaults processing memory at creation to avoid page faults on the first frame.
+         *
+         * @param enabled true to touch all processing memory in [build]
+         * @return This Builder instance for method chaining
+         */
+        fun prefaultMemory(enabled: Boolean): Builder {
+            prefaultMemory = enabled
+            return this
+        }
+
+        /**
+         * Locks processing memory so it stays resident across idle periods.
+         *
+         * Implies [prefaultMemory]. Use [Audx.memoryStatus] to check whether the lock was granted.
+         *
+         * @param enabled true to mlock processing memory in [build]
+         * @return This Builder instance for method chaining
+         */
+        fun lockMemory(enabled: Boolean): Builder {
+            lockMemory = enabled
+            return this
+        }
+
+        /**
+         * Makes output bit-identical across CPU architectures.
+         *
+         * Resampling then rounds every step instead of using fused multiply-adds, which costs
+         * a little throughput on arm64 and nothing on x86_64.
+         *
+         * @param enabled true for reproducible output
+         * @return This Builder instance for method chaining
+         */
+        fun deterministic(enabled: Boolean): Builder {
+            deterministic = enabled
+            return this
+        }
+
         /**
          * Builds and initializes an [Audx] instance with the configured parameters.
          *
@@ -168,6 +315,11 @@ class Audx(
                     AudxConfig(
                         inputRate = inputRate,
                         resampleQuality = resampleQuality,
+                        bypassWarmInterval = bypassWarmInterval,
+                        bandwidth = bandwidth,
+                        prefaultMemory = prefaultMemory,
+                        lockMemory = lockMemory,
+                        deterministic = deterministic,
                     ),
                 )
 
@@ -185,7 +337,15 @@ class Audx(
      * @throws AudxInitializationException if native initialization fails (e.g., invalid config, missing native library)
      */
     fun create() {
-        val ptr = denoiseCreateJNI(config.inputRate, config.resampleQuality)
+        val ptr =
+            denoiseCreateJNI(
+                config.inputRate,
+                config.resampleQuality,
+                config.bypassWarmInterval,
+                config.bandwidth,
+                memoryFlags(),
+                config.deterministic,
+            )
         if (ptr == -1L) {
             throw AudxInitializationException(
                 "Failed to initialize Audx with " +
@@ -196,9 +356,20 @@ class Audx(
         frameCount = 0  // Reset frame counter on new instance
     }
 
+    private fun memoryFlags(): Int {
+        var flags = 0
+        if (config.prefaultMemory || config.lockMemory) flags = flags or MEMORY_PREFAULT
+        if (config.lockMemory) flags = flags or MEMORY_LOCK
+        return flags
+    }
+
     private external fun denoiseCreateJNI(
         inRate: Int,
         resampleQuality: Int,
+        bypassWarmInterval: Int,
+        bandwidth: Int,
+        memoryFlags: Int,
+        deterministic: Boolean,
     ): Long
 
     /**
@@ -256,6 +427,255 @@ class Audx(
         process(input, output, vadProbabilityCallback)
     }
 
+    /**
+     * Enables or disables bypass mode.
+     *
+     * While bypassed, [process] copies input to output unchanged but keeps feeding the denoiser
+     * every [AudxConfig.bypassWarmInterval] frames, so re-enabling suppression is instant and
+     * does not go through a cold start. Both transitions crossfade over one frame.
+     *
+     * Safe to call from any thread; the change takes effect at the next frame boundary.
+     *
+     * @param enabled true to pass audio through, false to resume denoising
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    fun setBypass(enabled: Boolean) {
+        checkNotClosed("setBypass")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        bypassed = enabled
+        denoiseSetBypassJNI(ptr, enabled)
+    }
+
+    /**
+     * Returns true if bypass mode is currently requested.
+     */
+    fun isBypassed(): Boolean = bypassed
+
+    /**
+     * Sets the suppression strength.
+     *
+     * 0 passes the input through, 1 (the default) applies full suppression and values in between
+     * mix the denoised and original signals. The change is ramped over one frame.
+     *
+     * Safe to call from any thread; the change takes effect at the next frame boundary.
+     *
+     * @param strength Suppression strength (0.0-1.0)
+     * @throws IllegalArgumentException if strength is out of range
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    fun setStrength(strength: Float) {
+        require(strength in 0f..1f) { "strength must be between 0 and 1, got: $strength" }
+        checkNotClosed("setStrength")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        denoiseSetParamsJNI(ptr, PARAM_STRENGTH, strength, false, 0f, 0f)
+    }
+
+    /**
+     * Enables or disables automatic gain control of the output.
+     *
+     * The AGC tracks the level of frames with speech and steers the output gain towards
+     * [targetDb], by at most 0.5 dB per frame and never by more than [maxGainDb] or so far that a
+     * frame clips.
+     *
+     * Safe to call from any thread; the change takes effect at the next frame boundary.
+     *
+     * @param enabled true to enable the AGC
+     * @param targetDb Speech level to aim for in dBFS (-60 to 0)
+     * @param maxGainDb Largest boost or cut in dB (0 to [AGC_MAX_GAIN_DB_MAX])
+     * @throws IllegalArgumentException if a level is out of range
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    fun setAgc(
+        enabled: Boolean,
+        targetDb: Float = AGC_TARGET_DB_DEFAULT,
+        maxGainDb: Float = AGC_MAX_GAIN_DB_DEFAULT,
+    ) {
+        require(targetDb in -60f..0f) { "targetDb must be between -60 and 0, got: $targetDb" }
+        require(maxGainDb in 0f..AGC_MAX_GAIN_DB_MAX) {
+            "maxGainDb must be between 0 and $AGC_MAX_GAIN_DB_MAX, got: $maxGainDb"
+        }
+        checkNotClosed("setAgc")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        denoiseSetParamsJNI(ptr, PARAM_AGC, 1f, enabled, targetDb, maxGainDb)
+    }
+
+    /**
+     * Enables or disables discontinuous transmission (DTX) decisions for the output.
+     *
+     * When enabled, every processed frame gets a [dtxDecision] taken from the denoiser's VAD,
+     * so a network encoder can skip silent frames and send comfort-noise updates instead,
+     * without running a VAD of its own. Speech is followed by [hangoverFrames] frames that are
+     * still sent, covering word endings.
+     *
+     * Must be called on the thread that calls [process], between frames.
+     *
+     * @param enabled true to make DTX decisions, false to stop
+     * @param hangoverFrames Frames sent after speech ends (0 to 100)
+     * @throws IllegalArgumentException if hangoverFrames is out of range
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    fun setDtx(
+        enabled: Boolean,
+        hangoverFrames: Int = DTX_HANGOVER_DEFAULT,
+    ) {
+        require(hangoverFrames in 0..100) {
+            "hangoverFrames must be between 0 and 100, got: $hangoverFrames"
+        }
+        checkNotClosed("setDtx")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        dtxPtr = denoiseSetDtxJNI(ptr, dtxPtr, enabled, hangoverFrames)
+    }
+
+    /**
+     * DTX decision for the frame last returned by [process]: [DTX_TRANSMIT], [DTX_SID] or
+     * [DTX_SILENT]. Always [DTX_TRANSMIT] while DTX is disabled.
+     *
+     * Read on the thread that calls [process].
+     *
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    val dtxDecision: Int
+        get() {
+            checkNotClosed("dtxDecision")
+            return if (dtxPtr != 0L) denoiseDtxDecisionJNI(dtxPtr) else DTX_TRANSMIT
+        }
+
+    /**
+     * Comfort-noise level in dBFS to send with a [DTX_SID] frame: the tracked level of the
+     * output between speech. -96 before any silence was seen or while DTX is disabled.
+     *
+     * Read on the thread that calls [process].
+     *
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    val comfortNoiseDb: Float
+        get() {
+            checkNotClosed("comfortNoiseDb")
+            return if (dtxPtr != 0L) denoiseDtxNoiseDbJNI(dtxPtr) else -96f
+        }
+
+    /**
+     * Algorithmic delay from input to output in nanoseconds.
+     *
+     * The output of [process] carries audio captured this long before the input passed in the
+     * same call, so its presentation timestamp is the input's capture timestamp minus this value
+     * (for A/V sync). It covers the resampling around the denoiser and the denoiser's own
+     * one-frame delay. Bypassed audio is delayed by the same amount, so switching bypass keeps the
+     * dry and denoised signals aligned.
+     *
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    val delayNanos: Long
+        get() {
+            checkNotClosed("delayNanos")
+            val ptr = denoisePtr ?: error("Native pointer is null")
+            return denoiseDelayJNI(ptr)
+        }
+
+    /** Native speaker detector this instance reports to, 0 when it is not attached to one. */
+    internal var speakerDetectorPtr: Long = 0L
+        private set
+
+    /**
+     * Reports every processed frame to a native active-speaker detector, or stops reporting
+     * when [detectorPtr] is 0. Called by [AudxSpeakerDetector.attach].
+     */
+    internal fun setSpeaker(
+        detectorPtr: Long,
+        stream: Int,
+    ) {
+        checkNotClosed("setSpeaker")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        denoiseSetSpeakerJNI(ptr, detectorPtr, stream)
+        speakerDetectorPtr = detectorPtr
+    }
+
+    /** Native event ring this instance pushes to, 0 when it is not attached to a channel. */
+    internal var eventsRingPtr: Long = 0L
+        private set
+
+    /**
+     * Pushes the VAD and speech segment events of every processed frame to a native event ring,
+     * or stops when [ringPtr] is 0. Called by [AudxEventChannel.attach].
+     */
+    internal fun setEvents(
+        ringPtr: Long,
+        stream: Int,
+    ) {
+        checkNotClosed("setEvents")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        denoiseSetEventsJNI(ptr, ringPtr, stream)
+        eventsRingPtr = ringPtr
+    }
+
+    /**
+     * Adapts the denoiser to the room before the first live frame, without producing output.
+     *
+     * Pass pre-roll audio at the configured inputRate, e.g. the capture ring buffer from before
+     * the user unmuted. The most recent whole 10ms frames are used, so the pre-roll should end
+     * right before the next frame passed to [process]. The first live frames are then denoised
+     * as if the stream had been running. At input rates that are multiples of 100Hz other than
+     * 48kHz (e.g. 16kHz or 44.1kHz) this costs less than processing the same audio; at 48kHz,
+     * and at rates such as 22.05kHz, it costs the same.
+     *
+     * @param preRoll ShortArray containing PCM16 audio samples at the configured inputRate
+     * @return the number of 10ms frames consumed
+     * @throws IllegalStateException if this Audx instance has been closed
+     * @throws AudxProcessingException if native processing fails
+     */
+    fun prime(preRoll: ShortArray): Int {
+        checkNotClosed("prime")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        val frames = denoisePrimeJNI(ptr, preRoll)
+        if (frames < 0) {
+            throw AudxProcessingException("Priming failed")
+        }
+        if (frames > 0) {
+            // Already warm: no need to silence the first output frames
+            frameCount = maxOf(frameCount, SKIP_FIRST_N_FRAMES.toLong())
+        }
+        return frames
+    }
+
+    /**
+     * Touches all processing memory again so the next frame does not page-fault.
+     *
+     * Call before resuming after a long idle period (e.g. when a call is unmuted or a recording
+     * restarts). Not needed when memory is locked.
+     *
+     * Call it on the thread that runs [process]: that thread's working buffers are reserved,
+     * prefaulted and (with [AudxConfig.lockMemory]) locked here instead of on its first frame.
+     *
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    fun prefault() {
+        checkNotClosed("prefault")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        denoisePrefaultJNI(ptr)
+    }
+
+    /**
+     * Returns the memory residency flags actually in effect ([MEMORY_PREFAULT], [MEMORY_LOCK]).
+     *
+     * [MEMORY_LOCK] is missing when [AudxConfig.lockMemory] was requested but the system refused it.
+     *
+     * @throws IllegalStateException if this Audx instance has been closed
+     */
+    fun memoryStatus(): Int {
+        checkNotClosed("memoryStatus")
+
+        val ptr = denoisePtr ?: error("Native pointer is null")
+        return denoiseMemoryStatusJNI(ptr)
+    }
+
     /**
      * Releases native resources associated with this Audx instance.
      *
@@ -273,6 +693,10 @@ class Audx(
                     denoisePtr?.let { ptr ->
                         denoiseDestroyJNI(ptr)
                     }
+                    if (dtxPtr != 0L) {
+                        denoiseDtxDestroyJNI(dtxPtr)
+                        dtxPtr = 0L
+                    }
                 }
             } finally {
                 denoisePtr = null
@@ -297,5 +721,55 @@ class Audx(
         output: ShortArray,
     ): Float
 
+    private external fun denoiseSetBypassJNI(
+        ptr: Long,
+        enabled: Boolean,
+    )
+
+    private external fun denoiseSetParamsJNI(
+        ptr: Long,
+        fields: Int,
+        strength: Float,
+        agc: Boolean,
+        agcTargetDb: Float,
+        agcMaxGainDb: Float,
+    ): Boolean
+
+    private external fun denoiseSetSpeakerJNI(
+        ptr: Long,
+        detectorPtr: Long,
+        stream: Int,
+    )
+
+    private external fun denoiseSetEventsJNI(
+        ptr: Long,
+        ringPtr: Long,
+        stream: Int,
+    )
+
+    private external fun denoiseSetDtxJNI(
+        ptr: Long,
+        dtxPtr: Long,
+        enabled: Boolean,
+        hangoverFrames: Int,
+    ): Long
+
+    private external fun denoiseDtxDecisionJNI(dtxPtr: Long): Int
+
+    private external fun denoiseDtxNoiseDbJNI(dtxPtr: Long): Float
+
+    private external fun denoiseDtxDestroyJNI(dtxPtr: Long)
+
+    private external fun denoisePrimeJNI(
+        ptr: Long,
+        samples: ShortArray,
+    ): Int
+
+    private external fun denoiseDelayJNI(ptr: Long): Long
+
+    private external fun denoisePrefaultJNI(ptr: Long)
+
+    private external fun denoiseMemoryStatusJNI(ptr: Long): Int
+
     private external fun denoiseDestroyJNI(ptr: Long)
 }
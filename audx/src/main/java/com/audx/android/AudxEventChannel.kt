@@ -0,0 +1,212 @@
+package com.audx.android
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.concurrent.atomic.AtomicBoolean
+
+/**
+ * Delivers per-frame results from native processing threads to Kotlin in batches.
+ *
+ * Attached [Audx] instances push fixed-size event records (VAD, speech segment start and end)
+ * into a native lock-free ring while they process, without calling into the JVM. [drain] moves
+ * everything queued so far into a direct [ByteBuffer] with a single JNI call and hands the
+ * records to a handler, so the cost per event is a few buffer reads instead of a JNI upcall.
+ * When the consumer falls behind by more than [capacity] events, new events are dropped and
+ * counted by [dropped].
+ *
+ * ## Usage
+ * ```kotlin
+ * val events = AudxEventChannel(capacity = 1024)
+ * events.attach(audx, stream = 0)
+ * // e.g. every 100ms on a UI or coroutine timer
+ * events.drain { type, stream, frame, timeNanos, value, aux ->
+ *     if (type == AudxEventChannel.SPEECH_START) onSpeech(stream)
+ * }
+ * ```
+ *
+ * ## Thread Safety
+ * - Attached instances may process on any threads
+ * - [attach], [detach] and [drain] must not run concurrently with each other
+ * - An instance pushes to the ring from native code while it processes, without locking.
+ *   [attach], [detach] and [close] change where it pushes, so call them between that
+ *   instance's frames: on its processing thread, or while it is not processing
+ * - close() is idempotent
+ *
+ * @param capacity Events the ring holds; rounded up to a power of two
+ * @throws IllegalArgumentException if [capacity] is outside 1..[CAPACITY_MAX]
+ * @throws AudxInitializationException if native initialization fails
+ */
+class AudxEventChannel(
+    capacity: Int = CAPACITY_DEFAULT,
+) : AutoCloseable {
+    init {
+        require(capacity in 1..CAPACITY_MAX) { "capacity must be between 1 and $CAPACITY_MAX, got: $capacity" }
+        System.loadLibrary("audx-android")
+    }
+
+    private var ringPtr: Long = eventsCreateJNI(capacity)
+    private val closed = AtomicBoolean(false)
+    private val attached = mutableMapOf<Int, Audx>()
+
+    init {
+        if (ringPtr == -1L) {
+            throw AudxInitializationException("Failed to initialize AudxEventChannel with capacity=$capacity")
+        }
+    }
+
+    /** Events the ring holds. */
+    val capacity: Int = eventsCapacityJNI(ringPtr)
+
+    private val buffer: ByteBuffer =
+        ByteBuffer.allocateDirect(this.capacity * EVENT_BYTES).order(ByteOrder.nativeOrder())
+
+    companion object {
+        /** Default ring size (1024 events), about 3 seconds of one stream's VAD and segment events. */
+        const val CAPACITY_DEFAULT: Int = 1024
+
+        /** Largest ring size (65536 events, a 2 MB ring plus an equal drain buffer). */
+        const val CAPACITY_MAX: Int = 1 shl 16
+
+        /** VAD probability of a frame in `value`. */
+        const val VAD: Int = 1
+
+        /** A speech segment started; `value` is the VAD probability that started it. */
+        const val SPEECH_START: Int = 2
+
+        /** A speech segment ended; `aux` is its length in frames. */
+        const val SPEECH_END: Int = 3
+
+        /** Size of one native event record in bytes. */
+        private const val EVENT_BYTES = 32
+    }
+
+    /**
+     * Receives drained events. Called on the thread that calls [drain].
+     */
+    fun interface Handler {
+        /**
+         * @param type One of [VAD], [SPEECH_START], [SPEECH_END]
+         * @param stream Stream index given to [attach]
+         * @param frame Frame index within the stream, counted from [attach]
+         * @param timeNanos `CLOCK_MONOTONIC` time the event was produced, as [System.nanoTime]
+         * @param value Event value, see the type constants
+         * @param aux Event detail, see the type constants
+         */
+        fun onEvent(
+            type: Int,
+            stream: Int,
+            frame: Long,
+            timeNanos: Long,
+            value: Float,
+            aux: Int,
+        )
+    }
+
+    /**
+     * Pushes the events of the frames [audx] processes as [stream], replacing any instance
+     * previously attached to that index. Call between frames of [audx].
+     *
+     * An instance pushes to one channel under one index at a time; [detach] it before
+     * attaching it elsewhere.
+     *
+     * @throws IllegalArgumentException if [audx] is already attached under another index or
+     *   to another channel
+     * @throws IllegalStateException if this channel or [audx] has been closed
+     */
+    fun attach(
+        audx: Audx,
+        stream: Int,
+    ) {
+        checkNotClosed("attach")
+        require(audx.eventsRingPtr == 0L || attached[stream] === audx) {
+            "Audx instance is already attached to an event channel; detach it first"
+        }
+
+        attached.remove(stream)?.let { if (!it.isClosed()) it.setEvents(0L, 0) }
+        audx.setEvents(ringPtr, stream)
+        attached[stream] = audx
+    }
+
+    /**
+     * Stops pushing events for [stream]. Call between frames of the instance attached to
+     * [stream].
+     */
+    fun detach(stream: Int) {
+        checkNotClosed("detach")
+
+        attached.remove(stream)?.let { if (!it.isClosed()) it.setEvents(0L, 0) }
+    }
+
+    /**
+     * Passes the queued events, oldest first, to [handler]. One call delivers at most
+     * [capacity] events.
+     *
+     * @return the number of events delivered
+     * @throws IllegalStateException if this channel has been closed
+     */
+    fun drain(handler: Handler): Int {
+        checkNotClosed("drain")
+
+        val count = eventsDrainJNI(ringPtr, buffer)
+        for (i in 0 until count) {
+            val base = i * EVENT_BYTES
+            handler.onEvent(
+                buffer.getInt(base),
+                buffer.getInt(base + 4),
+                buffer.getLong(base + 8),
+                buffer.getLong(base + 16),
+                buffer.getFloat(base + 24),
+                buffer.getInt(base + 28),
+            )
+        }
+        return count
+    }
+
+    /**
+     * Returns the number of events dropped because the ring was full.
+     */
+    fun dropped(): Long {
+        checkNotClosed("dropped")
+        return eventsDroppedJNI(ringPtr)
+    }
+
+    /**
+     * Detaches all instances and releases native resources. This method is idempotent.
+     *
+     * No attached instance may be processing: the native ring is freed right after the
+     * instances are detached, so a frame still running would push into freed memory. Stop
+     * processing (or [detach] each instance on its processing thread) before closing.
+     */
+    override fun close() {
+        if (closed.compareAndSet(false, true)) {
+            attached.values.forEach { if (!it.isClosed()) it.setEvents(0L, 0) }
+            attached.clear()
+            eventsDestroyJNI(ringPtr)
+            ringPtr = 0L
+        }
+    }
+
+    /**
+     * Returns true if this channel has been closed and cannot be used.
+     */
+    fun isClosed(): Boolean = closed.get()
+
+    private fun checkNotClosed(methodName: String) {
+        check(!closed.get()) {
+            "Cannot call $methodName() on closed AudxEventChannel instance"
+        }
+    }
+
+    private external fun eventsCreateJNI(capacity: Int): Long
+
+    private external fun eventsCapacityJNI(ptr: Long): Int
+
+    private external fun eventsDrainJNI(
+        ptr: Long,
+        buffer: ByteBuffer,
+    ): Int
+
+    private external fun eventsDroppedJNI(ptr: Long): Long
+
+    private external fun eventsDestroyJNI(ptr: Long)
+}
@@ -0,0 +1,194 @@
+package com.audx.android
+
+import java.util.concurrent.atomic.AtomicBoolean
+
+/**
+ * Standalone streaming sample rate converter.
+ *
+ * Uses the same polyphase windowed-sinc filters and quality levels as the resampling inside
+ * [Audx], so apps can convert between rates (e.g. 44.1kHz, 48kHz, 16kHz) without shipping a
+ * second resampler library. Any pair of positive rates is supported; rates 2, 4 or 8 times apart
+ * (e.g. 96kHz or 192kHz to 48kHz) use a cheaper cascade of halfband filters.
+ *
+ * ## Usage
+ * ```kotlin
+ * AudxResampler(inputRate = 44100, outputRate = 48000).use { resampler ->
+ *     val output = ShortArray(resampler.maxOutputSize(input.size))
+ *     val written = resampler.process(input, output)
+ *     // output[0 until written] holds the converted samples
+ * }
+ * ```
+ *
+ * The resampler is stateful: consecutive calls continue the same stream, and the filter delays
+ * the signal by [inputLatency] input samples.
+ *
+ * ## Thread Safety
+ * - NOT thread-safe for concurrent process() calls
+ * - close() is thread-safe and idempotent
+ *
+ * @property inputRate Sample rate of the input in Hz. Must be positive.
+ * @property outputRate Sample rate of the output in Hz. Must be positive.
+ * @property quality Filter quality (0-10), same scale as [AudxConfig.resampleQuality]
+ * @throws IllegalArgumentException if a rate is not positive or quality is outside valid range
+ * @throws AudxInitializationException if native initialization fails
+ */
+class AudxResampler(
+    val inputRate: Int,
+    val outputRate: Int,
+    val quality: Int = Audx.AUDX_RESAMPLER_QUALITY_DEFAULT,
+) : AutoCloseable {
+    init {
+        require(inputRate > 0) { "inputRate must be positive, got: $inputRate" }
+        require(outputRate > 0) { "outputRate must be positive, got: $outputRate" }
+        require(quality in Audx.AUDX_RESAMPLER_QUALITY_MIN..Audx.AUDX_RESAMPLER_QUALITY_MAX) {
+            "quality must be between " +
+                "${Audx.AUDX_RESAMPLER_QUALITY_MIN} and ${Audx.AUDX_RESAMPLER_QUALITY_MAX}, got: $quality"
+        }
+        System.loadLibrary("audx-android")
+    }
+
+    private var resamplerPtr: Long = resamplerCreateJNI(inputRate, outputRate, quality)
+    private val closed = AtomicBoolean(false)
+
+    init {
+        if (resamplerPtr == -1L) {
+            throw AudxInitializationException(
+                "Failed to initialize AudxResampler with " +
+                    "inputRate=$inputRate, outputRate=$outputRate, quality=$quality",
+            )
+        }
+    }
+
+    /** Delay introduced by the filter, in input samples. */
+    val inputLatency: Int
+        get() {
+            checkNotClosed("inputLatency")
+            return resamplerLatencyJNI(resamplerPtr)
+        }
+
+    /**
+     * Returns the largest number of samples [process] can write for [inputSize] input samples.
+     */
+    fun maxOutputSize(inputSize: Int): Int {
+        checkNotClosed("maxOutputSize")
+        require(inputSize >= 0) { "inputSize must not be negative, got: $inputSize" }
+        return resamplerMaxOutputJNI(resamplerPtr, inputSize)
+    }
+
+    /**
+     * Converts PCM16 samples.
+     *
+     * @param input Samples at [inputRate]
+     * @param output Receives samples at [outputRate]. Must hold at least
+     *               [maxOutputSize] of [inputSize] samples.
+     * @param inputSize Number of samples of [input] to consume
+     * @return Number of samples written to [output]
+     * @throws IllegalStateException if this resampler has been closed
+     * @throws IllegalArgumentException if [output] is too small
+     * @throws AudxProcessingException if native processing fails
+     */
+    fun process(
+        input: ShortArray,
+        output: ShortArray,
+        inputSize: Int = input.size,
+    ): Int {
+        checkNotClosed("process")
+        checkSizes(input.size, output.size, inputSize)
+
+        val written = resamplerProcessJNI(resamplerPtr, input, inputSize, output)
+        if (written < 0) throw AudxProcessingException("Resampling failed")
+        return written
+    }
+
+    /**
+     * Converts float samples (any scale; PCM16 range is conventional).
+     *
+     * @see process
+     */
+    fun process(
+        input: FloatArray,
+        output: FloatArray,
+        inputSize: Int = input.size,
+    ): Int {
+        checkNotClosed("process")
+        checkSizes(input.size, output.size, inputSize)
+
+        val written = resamplerProcessFloatJNI(resamplerPtr, input, inputSize, output)
+        if (written < 0) throw AudxProcessingException("Resampling failed")
+        return written
+    }
+
+    /**
+     * Clears the filter history, as if the resampler had just been created.
+     */
+    fun reset() {
+        checkNotClosed("reset")
+        resamplerResetJNI(resamplerPtr)
+    }
+
+    /**
+     * Releases native resources. This method is idempotent.
+     */
+    override fun close() {
+        if (closed.compareAndSet(false, true)) {
+            resamplerDestroyJNI(resamplerPtr)
+            resamplerPtr = 0L
+        }
+    }
+
+    /**
+     * Returns true if this resampler has been closed and cannot be used.
+     */
+    fun isClosed(): Boolean = closed.get()
+
+    private fun checkSizes(
+        inputCapacity: Int,
+        outputCapacity: Int,
+        inputSize: Int,
+    ) {
+        require(inputSize in 0..inputCapacity) {
+            "inputSize must be between 0 and $inputCapacity, got: $inputSize"
+        }
+        val needed = maxOutputSize(inputSize)
+        require(outputCapacity >= needed) {
+            "output must hold at least $needed samples, got: $outputCapacity"
+        }
+    }
+
+    private fun checkNotClosed(methodName: String) {
+        check(!closed.get()) {
+            "Cannot call $methodName() on closed AudxResampler instance"
+        }
+    }
+
+    private external fun resamplerCreateJNI(
+        inRate: Int,
+        outRate: Int,
+        quality: Int,
+    ): Long
+
+    private external fun resamplerProcessJNI(
+        ptr: Long,
+        input: ShortArray,
+        inputSize: Int,
+        output: ShortArray,
+    ): Int
+
+    private external fun resamplerProcessFloatJNI(
+        ptr: Long,
+        input: FloatArray,
+        inputSize: Int,
+        output: FloatArray,
+    ): Int
+
+    private external fun resamplerMaxOutputJNI(
+        ptr: Long,
+        inputSize: Int,
+    ): Int
+
+    private external fun resamplerLatencyJNI(ptr: Long): Int
+
+    private external fun resamplerResetJNI(ptr: Long)
+
+    private external fun resamplerDestroyJNI(ptr: Long)
+}
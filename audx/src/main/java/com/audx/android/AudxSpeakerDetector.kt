@@ -0,0 +1,184 @@
+package com.audx.android
+
+import java.util.concurrent.atomic.AtomicBoolean
+
+/**
+ * Native active-speaker detection across several [Audx] instances.
+ *
+ * Each attached instance reports the VAD probability and energy of every frame it processes
+ * directly in native code, so the JVM sees no per-frame callbacks. Call [tick] once per 10ms
+ * frame period; [listener] runs only when the active speaker changes.
+ *
+ * A stream counts as talking once its VAD reaches [vadOn] and stops after its VAD has stayed
+ * below [vadOff] for [hangoverFrames]. The loudest talking stream wins, but a talking active
+ * speaker only loses the floor to a stream that is [dominanceDb] louder for [switchFrames] frames
+ * in a row. When nobody talks the last active speaker is kept.
+ *
+ * ## Usage
+ * ```kotlin
+ * val detector = AudxSpeakerDetector(streams = participants.size) { previous, current ->
+ *     ui.highlight(current)
+ * }
+ * participants.forEachIndexed { i, p -> detector.attach(p.audx, i) }
+ * // every 10ms, e.g. from the mixer
+ * detector.tick()
+ * ```
+ *
+ * ## Thread Safety
+ * - Attached instances may process on any threads
+ * - [attach], [detach] and [tick] must not run concurrently with each other
+ * - An instance reads the detector from native code while it processes, without locking.
+ *   [attach], [detach] and [close] change what it reads, so call them between that instance's
+ *   frames: on its processing thread, or while it is not processing
+ * - close() is idempotent
+ *
+ * @property streams Number of participants, indexed from 0
+ * @throws IllegalArgumentException if a parameter is outside its valid range
+ * @throws AudxInitializationException if native initialization fails
+ */
+class AudxSpeakerDetector(
+    val streams: Int,
+    val vadOn: Float = 0.6f,
+    val vadOff: Float = 0.3f,
+    val hangoverFrames: Int = 30,
+    val dominanceDb: Float = 6.0f,
+    val switchFrames: Int = 20,
+    val smoothing: Float = 0.1f,
+    private val listener: (previous: Int, current: Int) -> Unit,
+) : AutoCloseable {
+    init {
+        require(streams > 0) { "streams must be positive, got: $streams" }
+        require(vadOff <= vadOn) { "vadOff must not exceed vadOn, got: $vadOff > $vadOn" }
+        require(hangoverFrames >= 0) { "hangoverFrames must not be negative, got: $hangoverFrames" }
+        require(switchFrames > 0) { "switchFrames must be positive, got: $switchFrames" }
+        require(smoothing > 0f && smoothing <= 1f) { "smoothing must be in (0, 1], got: $smoothing" }
+        System.loadLibrary("audx-android")
+    }
+
+    private var detectorPtr: Long =
+        speakerCreateJNI(streams, vadOn, vadOff, hangoverFrames, dominanceDb, switchFrames, smoothing)
+    private val closed = AtomicBoolean(false)
+    private val attached = mutableMapOf<Int, Audx>()
+
+    init {
+        if (detectorPtr == -1L) {
+            throw AudxInitializationException("Failed to initialize AudxSpeakerDetector with streams=$streams")
+        }
+    }
+
+    /** Index of the active speaker, or -1 before anyone has talked. */
+    var activeSpeaker: Int = -1
+        private set
+
+    /**
+     * Reports the frames [audx] processes as participant [stream], replacing any instance
+     * previously attached to that index. Call between frames of [audx].
+     *
+     * An instance reports to one detector as one participant at a time; [detach] it before
+     * attaching it elsewhere.
+     *
+     * @throws IllegalArgumentException if [stream] is out of range, or [audx] is already
+     *   attached as another participant or to another detector
+     * @throws IllegalStateException if this detector or [audx] has been closed
+     */
+    fun attach(
+        audx: Audx,
+        stream: Int,
+    ) {
+        checkNotClosed("attach")
+        require(stream in 0 until streams) { "stream must be between 0 and ${streams - 1}, got: $stream" }
+        require(audx.speakerDetectorPtr == 0L || attached[stream] === audx) {
+            "Audx instance is already attached to a speaker detector; detach it first"
+        }
+
+        attached.remove(stream)?.let { if (!it.isClosed()) it.setSpeaker(0L, 0) }
+        audx.setSpeaker(detectorPtr, stream)
+        attached[stream] = audx
+    }
+
+    /**
+     * Stops reporting for participant [stream]; it counts as silent after five [tick]s without
+     * frames from it. Call between frames of the instance attached to [stream].
+     */
+    fun detach(stream: Int) {
+        checkNotClosed("detach")
+
+        attached.remove(stream)?.let { if (!it.isClosed()) it.setSpeaker(0L, 0) }
+    }
+
+    /**
+     * Evaluates the frames reported since the previous call. Call once per 10ms frame period.
+     *
+     * Frames that arrive in a burst count together, and a stream that reported nothing since the
+     * previous call keeps its last value for up to five calls, so callback jitter between the
+     * processing threads and the ticking thread does not make the decision flicker.
+     *
+     * @return the active speaker, or -1 before anyone has talked
+     * @throws IllegalStateException if this detector has been closed
+     */
+    fun tick(): Int {
+        checkNotClosed("tick")
+
+        val current = speakerTickJNI(detectorPtr)
+        if (current != activeSpeaker) {
+            val previous = activeSpeaker
+            activeSpeaker = current
+            listener(previous, current)
+        }
+        return current
+    }
+
+    /**
+     * Returns true if participant [stream] currently counts as talking.
+     */
+    fun isTalking(stream: Int): Boolean {
+        checkNotClosed("isTalking")
+        return speakerTalkingJNI(detectorPtr, stream)
+    }
+
+    /**
+     * Detaches all instances and releases native resources. This method is idempotent.
+     *
+     * No attached instance may be processing: the native detector is freed right after the
+     * instances are detached, so a frame still running would report into freed memory. Stop
+     * processing (or [detach] each instance on its processing thread) before closing.
+     */
+    override fun close() {
+        if (closed.compareAndSet(false, true)) {
+            attached.values.forEach { if (!it.isClosed()) it.setSpeaker(0L, 0) }
+            attached.clear()
+            speakerDestroyJNI(detectorPtr)
+            detectorPtr = 0L
+        }
+    }
+
+    /**
+     * Returns true if this detector has been closed and cannot be used.
+     */
+    fun isClosed(): Boolean = closed.get()
+
+    private fun checkNotClosed(methodName: String) {
+        check(!closed.get()) {
+            "Cannot call $methodName() on closed AudxSpeakerDetector instance"
+        }
+    }
+
+    private external fun speakerCreateJNI(
+        streams: Int,
+        vadOn: Float,
+        vadOff: Float,
+        hangoverFrames: Int,
+        dominanceDb: Float,
+        switchFrames: Int,
+        smoothing: Float,
+    ): Long
+
+    private external fun speakerTickJNI(ptr: Long): Int
+
+    private external fun speakerTalkingJNI(
+        ptr: Long,
+        stream: Int,
+    ): Boolean
+
+    private external fun speakerDestroyJNI(ptr: Long)
+}